@@ -0,0 +1,104 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "osm2rdf/Version.h"
+#include "osm2rdf/config/Config.h"
+#include "osm2rdf/config/ExitCode.h"
+#include "osm2rdf/osm/GeometryHandler.h"
+#include "osm2rdf/osm/GeometryState.h"
+#include "osm2rdf/ttl/Writer.h"
+#include "osm2rdf/util/Output.h"
+#include "osm2rdf/util/Time.h"
+#include "popl.hpp"
+
+#if defined(_OPENMP)
+#include "omp.h"
+#endif
+
+// Calculates the geometric relations of tiles written by osm2rdf with
+// --geometry-tiles. Tiles already claimed by another worker are skipped, so
+// several workers, also on other machines sharing the cache directory, can
+// be started on the same tiles.
+
+// ____________________________________________________________________________
+int main(int argc, char** argv) {
+  popl::OptionParser parser("Usage: osm2rdf-tile [options] TILE...");
+  auto helpOp = parser.add<popl::Switch>("h", "help", "Print help");
+  auto threadsOp = parser.add<popl::Value<int>>(
+      "t", "threads", "Number of threads",
+      static_cast<int>(std::thread::hardware_concurrency()));
+  try {
+    parser.parse(argc, argv);
+  } catch (const popl::invalid_option& e) {
+    std::cerr << "Invalid Option Exception: " << e.what() << "\n"
+              << parser.help() << "\n";
+    std::exit(osm2rdf::config::ExitCode::FAILURE);
+  }
+  if (helpOp->is_set() || parser.non_option_args().empty()) {
+    std::cerr << parser << "\n";
+    std::exit(helpOp->is_set() ? osm2rdf::config::ExitCode::SUCCESS
+                               : osm2rdf::config::ExitCode::INPUT_MISSING);
+  }
+
+  osm2rdf::config::Config config;
+  config.numThreads = std::max(threadsOp->value(), 1);
+#if defined(_OPENMP)
+  omp_set_num_threads(config.numThreads);
+#endif
+
+  try {
+    // Relations are stored by predicate index, the writer only provides the
+    // predicate IRIs of the sweep and never writes.
+    osm2rdf::util::Output output{config, ""};
+    osm2rdf::ttl::Writer<osm2rdf::ttl::format::QLEVER> writer{config, &output};
+
+    for (const auto& arg : parser.non_option_args()) {
+      const std::filesystem::path tile{arg};
+      if (!osm2rdf::osm::GeometryHandler<
+              osm2rdf::ttl::format::QLEVER>::claimTile(tile)) {
+        continue;
+      }
+      std::cerr << osm2rdf::util::currentTimeFormatted()
+                << "osm2rdf-tile :: " << tile << std::endl;
+      // Each tile gets its own sweep cache, also if a reclaimed tile is
+      // processed by two workers.
+      config.cache = tile.string() + ".sweep" + osm2rdf::osm::processSuffix();
+      std::filesystem::create_directories(config.cache);
+      {
+        osm2rdf::osm::GeometryHandler<osm2rdf::ttl::format::QLEVER> handler{
+            config, &writer};
+        handler.processTile(tile);
+      }
+      std::filesystem::remove_all(config.cache);
+    }
+  } catch (const std::exception& e) {
+    std::cerr << osm2rdf::util::currentTimeFormatted()
+              << "osm2rdf-tile :: " << osm2rdf::version::GIT_INFO
+              << " :: ERROR" << std::endl;
+    std::cerr << e.what() << std::endl;
+    std::exit(osm2rdf::config::ExitCode::EXCEPTION);
+  }
+  std::exit(osm2rdf::config::ExitCode::SUCCESS);
+}
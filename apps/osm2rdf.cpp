@@ -16,6 +16,8 @@
 // You should have received a copy of the GNU General Public License
 // along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <unistd.h>
+
 #include <cstdlib>
 #include <filesystem>
 #include <iostream>
@@ -40,6 +42,7 @@ void run(const osm2rdf::config::Config& config) {
   // Setup
   // Input file reference
   osm2rdf::util::Output output{config, config.output};
+  output.setStdoutFd(STDOUT_FILENO);
   if (!output.open()) {
     std::cerr << "Error opening outputfile: " << config.output << std::endl;
     exit(1);
@@ -71,7 +74,13 @@ void run(const osm2rdf::config::Config& config) {
             << "Memory used: " << memory.peak() << " MBytes" << std::endl;
 
   // All work done, close output
+  writer.closeGroups();
   output.close();
+  if (config.outputAsyncWrite) {
+    std::cerr << osm2rdf::util::formattedTimeSpacer
+              << "Output stalled: " << output.stallSeconds() << " s"
+              << std::endl;
+  }
 
   // Write final RDF statistics if requested
   if (config.writeRDFStatistics) {
@@ -107,6 +116,8 @@ int main(int argc, char** argv) {
       run<osm2rdf::ttl::format::NT>(config);
     } else if (config.outputFormat == "ttl") {
       run<osm2rdf::ttl::format::TTL>(config);
+    } else if (config.outputFormat == "binary") {
+      run<osm2rdf::ttl::format::BINARY>(config);
     } else {
       std::cerr << osm2rdf::util::currentTimeFormatted()
                 << "osm2rdf :: " << osm2rdf::version::GIT_INFO << " :: ERROR"
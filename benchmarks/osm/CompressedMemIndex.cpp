@@ -0,0 +1,82 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/CompressedMemIndex.h"
+
+#include <algorithm>
+#include <random>
+
+#include "benchmark/benchmark.h"
+#include "osmium/osm/location.hpp"
+#include "osmium/osm/types.hpp"
+
+using Index = osm2rdf::osm::CompressedMemIndex<osmium::unsigned_object_id_type,
+                                               osmium::Location>;
+
+// Enough nodes for the 64 MiB chunks to be mostly full.
+static const size_t NUM_NODES = size_t{1} << 27U;
+// Bytes per node the index may use for the nodes below, about 35 GB for the
+// 9.5 billion nodes of the planet.
+static const double MAX_BYTES_PER_NODE = 4.0;
+
+// ____________________________________________________________________________
+// Stores nodes in ID order like in a planet file: IDs mostly consecutive with
+// small gaps from deleted nodes, coordinates mostly a few meters apart along
+// ways, sometimes a jump within the region and rarely anywhere.
+static void CompressedMemIndex_set_Planet(benchmark::State& state) {
+  for (auto _ : state) {
+    Index index;
+    std::mt19937_64 gen{42};
+    std::uniform_int_distribution<int> percent{0, 99};
+    std::uniform_int_distribution<int> gap{2, 4};
+    std::uniform_int_distribution<int32_t> step{-1000, 1000};
+    std::uniform_int_distribution<int32_t> jump{-100000, 100000};
+    std::uniform_int_distribution<int32_t> lon{-1800000000, 1800000000};
+    std::uniform_int_distribution<int32_t> lat{-900000000, 900000000};
+    uint64_t id = 0;
+    int32_t x = 78000000;
+    int32_t y = 480000000;
+    for (size_t i = 0; i < NUM_NODES; ++i) {
+      id += percent(gen) < 90 ? 1 : gap(gen);
+      const int p = percent(gen);
+      if (p < 95) {
+        x += step(gen);
+        y += step(gen);
+      } else if (p < 99) {
+        x += jump(gen);
+        y += jump(gen);
+      } else {
+        x = lon(gen);
+        y = lat(gen);
+      }
+      x = std::clamp(x, -1800000000, 1800000000);
+      y = std::clamp(y, -900000000, 900000000);
+      index.set(id, osmium::Location{x, y});
+    }
+    const double bytesPerNode =
+        static_cast<double>(index.used_memory()) / NUM_NODES;
+    state.counters["bytesPerNode"] = bytesPerNode;
+    if (bytesPerNode > MAX_BYTES_PER_NODE) {
+      state.SkipWithError("Location index uses too many bytes per node");
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NUM_NODES);
+}
+BENCHMARK(CompressedMemIndex_set_Planet)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
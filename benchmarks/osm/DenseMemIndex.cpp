@@ -0,0 +1,67 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/DenseMemIndex.h"
+
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "osmium/osm/location.hpp"
+#include "osmium/osm/types.hpp"
+
+using Index = osm2rdf::osm::DenseMemIndex<osmium::unsigned_object_id_type,
+                                          osmium::Location>;
+
+// Larger than the TLB reach with normal pages.
+static const size_t NUM_IDS = size_t{1} << 26U;
+static const size_t NUM_LOOKUPS = size_t{1} << 16U;
+
+// ____________________________________________________________________________
+static void DenseMemIndex_get_noexcept_Random(benchmark::State& state) {
+  Index index{0, NUM_IDS - 1,
+              static_cast<osm2rdf::config::HugePages>(state.range(0)),
+              static_cast<osm2rdf::config::NumaPlacement>(state.range(1))};
+  for (size_t id = 0; id < NUM_IDS; ++id) {
+    index.set(id, osmium::Location{static_cast<int32_t>(id), 1});
+  }
+  std::mt19937_64 gen{42};
+  std::uniform_int_distribution<size_t> dist{0, NUM_IDS - 1};
+  std::vector<size_t> ids(NUM_LOOKUPS);
+  for (auto& id : ids) {
+    id = dist(gen);
+  }
+
+  for (auto _ : state) {
+    for (const auto id : ids) {
+      benchmark::DoNotOptimize(index.get_noexcept(id));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NUM_LOOKUPS);
+  state.counters["pageSize"] = static_cast<double>(index.pageSize());
+  state.counters["replicas"] = static_cast<double>(index.replicas());
+}
+BENCHMARK(DenseMemIndex_get_noexcept_Random)
+    ->ArgNames({"pages", "numa"})
+    ->ArgsProduct({{osm2rdf::config::NO_HUGE_PAGES,
+                    osm2rdf::config::TRANSPARENT_HUGE_PAGES,
+                    osm2rdf::config::HUGE_PAGES_2M,
+                    osm2rdf::config::HUGE_PAGES_1G},
+                   {osm2rdf::config::NUMA_LOCAL,
+                    osm2rdf::config::NUMA_INTERLEAVE,
+                    osm2rdf::config::NUMA_REPLICATE}});
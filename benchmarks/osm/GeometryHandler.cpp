@@ -0,0 +1,131 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/GeometryHandler.h"
+
+#include <cstdint>
+#include <filesystem>
+
+#include "benchmark/benchmark.h"
+#include "osm2rdf/config/Config.h"
+#include "osm2rdf/osm/Area.h"
+#include "osm2rdf/osm/Node.h"
+#include "osm2rdf/ttl/Format.h"
+#include "osm2rdf/ttl/Writer.h"
+#include "osm2rdf/util/Output.h"
+#include "osmium/builder/attr.hpp"
+#include "osmium/builder/osm_object_builder.hpp"
+
+// Squares per axis, each square overlaps its neighbours and holds a node.
+static const int64_t GRID_SIZE = 32;
+static const double CELL_SIZE = 0.01;
+
+// ____________________________________________________________________________
+static osmium::memory::Buffer createGrid() {
+  osmium::memory::Buffer buffer{size_t{1} << 20U,
+                                osmium::memory::Buffer::auto_grow::yes};
+  for (int64_t x = 0; x < GRID_SIZE; ++x) {
+    for (int64_t y = 0; y < GRID_SIZE; ++y) {
+      const int64_t id = x * GRID_SIZE + y + 1;
+      const double minX = 7.5 + x * CELL_SIZE;
+      const double minY = 48.0 + y * CELL_SIZE;
+      const double maxX = minX + 1.5 * CELL_SIZE;
+      const double maxY = minY + 1.5 * CELL_SIZE;
+      osmium::builder::add_area(buffer, osmium::builder::attr::_id(2 * id),
+                                osmium::builder::attr::_outer_ring({
+                                    {1, {minX, minY}},
+                                    {2, {maxX, minY}},
+                                    {3, {maxX, maxY}},
+                                    {4, {minX, maxY}},
+                                    {1, {minX, minY}},
+                                }));
+      osmium::builder::add_node(
+          buffer, osmium::builder::attr::_id(id),
+          osmium::builder::attr::_location(osmium::Location(
+              minX + 0.5 * CELL_SIZE, minY + 0.5 * CELL_SIZE)));
+    }
+  }
+  return buffer;
+}
+
+// ____________________________________________________________________________
+// Calculates the geometric relations of the grid, the argument is a bitmask of
+// the written predicates in the order intersects, contains, covers, touches,
+// equals, overlaps and crosses. All predicates are calculated, the difference
+// to 127 is the saved output.
+static void GeometryHandler_calculateRelations(benchmark::State& state) {
+  const auto mask = static_cast<uint64_t>(state.range(0));
+  osm2rdf::config::Config config;
+  config.numThreads = 1;
+  config.cache = std::filesystem::temp_directory_path();
+  config.output = config.cache / "osm2rdf-benchmark-geometry-handler.qlever";
+  config.outputCompress = osm2rdf::config::NONE;
+  config.addIntersectsRelations = (mask & 1U) != 0;
+  config.addContainsRelations = (mask & 2U) != 0;
+  config.addCoversRelations = (mask & 4U) != 0;
+  config.addTouchesRelations = (mask & 8U) != 0;
+  config.addEqualsRelations = (mask & 16U) != 0;
+  config.addOverlapsRelations = (mask & 32U) != 0;
+  config.addCrossesRelations = (mask & 64U) != 0;
+
+  auto buffer = createGrid();
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    osm2rdf::util::Output output{config, config.output};
+    output.open();
+    osm2rdf::ttl::Writer<osm2rdf::ttl::format::QLEVER> writer{config, &output};
+    {
+      osm2rdf::osm::GeometryHandler<osm2rdf::ttl::format::QLEVER> handler{
+          config, &writer};
+      for (const auto& item : buffer) {
+        if (item.type() == osmium::item_type::area) {
+          osm2rdf::osm::Area area{static_cast<const osmium::Area&>(item)};
+          area.finalize();
+          handler.area(area);
+        } else if (item.type() == osmium::item_type::node) {
+          handler.node(
+              osm2rdf::osm::Node{static_cast<const osmium::Node&>(item)});
+        }
+      }
+      state.ResumeTiming();
+
+      handler.calculateRelations();
+
+      state.PauseTiming();
+    }
+    writer.closeGroups();
+    output.close();
+    state.ResumeTiming();
+  }
+  std::filesystem::remove(config.output);
+  state.SetItemsProcessed(state.iterations() * GRID_SIZE * GRID_SIZE * 2);
+  state.counters["predicates"] = static_cast<double>(mask);
+}
+BENCHMARK(GeometryHandler_calculateRelations)
+    ->ArgNames({"predicates"})
+    ->Args({127})
+    ->Args({126})
+    ->Args({125})
+    ->Args({123})
+    ->Args({119})
+    ->Args({111})
+    ->Args({95})
+    ->Args({63})
+    ->Args({3})
+    ->Unit(benchmark::kMillisecond);
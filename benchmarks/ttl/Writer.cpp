@@ -18,8 +18,40 @@
 
 #include "osm2rdf/ttl/Writer.h"
 
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <string>
+#include <vector>
+
 #include "benchmark/benchmark.h"
+#include "osm2rdf/ttl/Constants.h"
 #include "osm2rdf/ttl/Format.h"
+#include "osm2rdf/util/Output.h"
+#include "osm2rdf/util/Simd.h"
+
+// Number of heap allocations, reported by the triple benchmarks.
+static std::atomic<size_t> allocations{0};
+
+// Not inlined, gcc mistakes malloc and free for mismatched allocation
+// functions otherwise.
+__attribute__((noinline)) void* operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = std::malloc(size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+__attribute__((noinline)) void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete(void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
 
 // ---------------------------------------------------------------------------
 static void Writer_NT_generateBlankNode(benchmark::State& state) {
@@ -444,3 +476,221 @@ BENCHMARK(Writer_QLEVER_encodePN_LOCAL_0xFAFA)
     ->RangeMultiplier(2)
     ->Range(1U << 4U, 1U << 11U)
     ->Complexity();
+
+// ---------------------------------------------------------------------------
+// Writes typical node and way member triples, either by building each term as
+// std::string first or directly through the triple cursor. The "allocs"
+// and "bytes" counters are the number of heap allocations and the output size
+// per iteration.
+template <typename T>
+static void writeTriples(benchmark::State& state, bool cursor) {
+  osm2rdf::config::Config config;
+  config.outputCompress = osm2rdf::config::NONE;
+  config.mergeOutput = osm2rdf::util::OutputMergeMode::NONE;
+  std::filesystem::path tmpDir =
+      config.getTempPath("BENCHMARK_TTL_Writer", "triples");
+  std::filesystem::create_directories(tmpDir);
+  config.output = tmpDir / "out";
+  osm2rdf::util::Output output{config, config.output};
+  output.open();
+  osm2rdf::ttl::Writer<T> w{config, &output};
+  const std::string subj = w.generateIRI("osmnode", 240109189);
+
+  size_t pos = 0;
+  size_t before = allocations.load();
+  for (auto _ : state) {
+    if (cursor) {
+      w.triple()
+          .term(subj)
+          .term(osm2rdf::ttl::constants::IRI__OSMMETA_CHANGESET)
+          .iri("osmchangeset", 9316364)
+          .end();
+      w.triple()
+          .term(subj)
+          .term(osm2rdf::ttl::constants::IRI__OSMMETA_USER)
+          .literal("Lorem ipsum")
+          .end();
+      w.triple()
+          .term(subj)
+          .term(osm2rdf::ttl::constants::IRI__OSM2RDF_MEMBER__POS)
+          .integerLiteral(pos++,
+                          osm2rdf::ttl::constants::LITERAL_SUFFIX__XSD_INTEGER)
+          .end();
+      w.triple()
+          .term(subj)
+          .term(osm2rdf::ttl::constants::IRI__OSMWAY_NEXT_NODE_DISTANCE)
+          .doubleLiteral(12.345678,
+                         osm2rdf::ttl::constants::LITERAL_SUFFIX__XSD_DECIMAL)
+          .end();
+    } else {
+      w.writeTriple(subj, osm2rdf::ttl::constants::IRI__OSMMETA_CHANGESET,
+                    w.generateIRI("osmchangeset", 9316364));
+      w.writeTriple(subj, osm2rdf::ttl::constants::IRI__OSMMETA_USER,
+                    w.generateLiteral("Lorem ipsum", ""));
+      w.writeLiteralTripleUnsafe(
+          subj, osm2rdf::ttl::constants::IRI__OSM2RDF_MEMBER__POS,
+          std::to_string(pos++),
+          "^^" + osm2rdf::ttl::constants::IRI__XSD_INTEGER);
+      w.writeLiteralTripleUnsafe(
+          subj, osm2rdf::ttl::constants::IRI__OSMWAY_NEXT_NODE_DISTANCE,
+          std::to_string(12.345678),
+          "^^" + osm2rdf::ttl::constants::IRI__XSD_DECIMAL);
+    }
+  }
+  state.counters["allocs"] = benchmark::Counter(
+      static_cast<double>(allocations.load() - before),
+      benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed(state.iterations() * 4);
+
+  output.close();
+  // Output size per iteration, summed over all part files.
+  size_t bytes = 0;
+  for (const auto& entry : std::filesystem::directory_iterator(tmpDir)) {
+    bytes += entry.file_size();
+  }
+  state.counters["bytes"] = benchmark::Counter(
+      static_cast<double>(bytes), benchmark::Counter::kAvgIterations);
+  std::filesystem::remove_all(tmpDir);
+}
+
+// ---------------------------------------------------------------------------
+static void Writer_NT_writeTriple(benchmark::State& state) {
+  writeTriples<osm2rdf::ttl::format::NT>(state, false);
+}
+BENCHMARK(Writer_NT_writeTriple);
+
+static void Writer_NT_triple(benchmark::State& state) {
+  writeTriples<osm2rdf::ttl::format::NT>(state, true);
+}
+BENCHMARK(Writer_NT_triple);
+
+static void Writer_TTL_writeTriple(benchmark::State& state) {
+  writeTriples<osm2rdf::ttl::format::TTL>(state, false);
+}
+BENCHMARK(Writer_TTL_writeTriple);
+
+static void Writer_TTL_triple(benchmark::State& state) {
+  writeTriples<osm2rdf::ttl::format::TTL>(state, true);
+}
+BENCHMARK(Writer_TTL_triple);
+
+static void Writer_QLEVER_writeTriple(benchmark::State& state) {
+  writeTriples<osm2rdf::ttl::format::QLEVER>(state, false);
+}
+BENCHMARK(Writer_QLEVER_writeTriple);
+
+static void Writer_QLEVER_triple(benchmark::State& state) {
+  writeTriples<osm2rdf::ttl::format::QLEVER>(state, true);
+}
+BENCHMARK(Writer_QLEVER_triple);
+
+static void Writer_BINARY_writeTriple(benchmark::State& state) {
+  writeTriples<osm2rdf::ttl::format::BINARY>(state, false);
+}
+BENCHMARK(Writer_BINARY_writeTriple);
+
+static void Writer_BINARY_triple(benchmark::State& state) {
+  writeTriples<osm2rdf::ttl::format::BINARY>(state, true);
+}
+BENCHMARK(Writer_BINARY_triple);
+
+// ---------------------------------------------------------------------------
+// Tag keys and values as found in OSM extracts: mostly ASCII, names in
+// several scripts, urls and a few values requiring escapes.
+static const std::vector<std::string> TAG_KEYS{
+    "name",          "name:de",         "name:en",
+    "addr:street",   "addr:housenumber", "addr:postcode",
+    "opening_hours", "wikipedia",       "wikidata",
+    "highway",       "building",        "source:geometry",
+    "contact:phone", "note",            "check_date:opening_hours"};
+static const std::vector<std::string> TAG_VALUES{
+    u8"Freiburg im Breisgau",
+    u8"Albert-Ludwigs-Universität Freiburg",
+    u8"Straße des 17. Juni",
+    u8"Москва",
+    u8"東京都",
+    u8"القاهرة",
+    "Mo-Fr 08:00-18:00; Sa 09:00-14:00; PH off",
+    "de:Freiburg im Breisgau",
+    "https://www.uni-freiburg.de/university/contact?lang=en",
+    "residential",
+    "79110",
+    "+49 761 203 0",
+    "Entrance at the back, ask for \"Hausmeister\"\nclosed on holidays",
+    "C:\\osm\\import.osm",
+    "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+    "tempor incididunt ut labore et dolore magna aliqua."};
+
+// Returns the number of bytes in strings.
+static int64_t corpusBytes(const std::vector<std::string>& strings) {
+  int64_t bytes = 0;
+  for (const auto& s : strings) {
+    bytes += static_cast<int64_t>(s.size());
+  }
+  return bytes;
+}
+
+// Runs f on each corpus entry with the simd level given as argument and
+// reports the throughput in bytes per second.
+template <typename F>
+static void encodeCorpus(benchmark::State& state,
+                         const std::vector<std::string>& strings, F f) {
+  const auto previous = osm2rdf::util::simd::level();
+  const auto level = static_cast<osm2rdf::util::simd::Level>(state.range(0));
+  if (level > osm2rdf::util::simd::detectLevel()) {
+    state.SkipWithError("simd level not supported by cpu");
+    return;
+  }
+  osm2rdf::util::simd::setLevel(level);
+  for (auto _ : state) {
+    for (const auto& s : strings) {
+      benchmark::DoNotOptimize(f(s));
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * corpusBytes(strings));
+  osm2rdf::util::simd::setLevel(previous);
+}
+
+// Levels: 0 = scalar, 1 = SSE2, 2 = AVX2
+// ---------------------------------------------------------------------------
+static void Writer_NT_STRING_LITERAL_QUOTE_tags(benchmark::State& state) {
+  osm2rdf::config::Config config;
+  osm2rdf::ttl::Writer<osm2rdf::ttl::format::NT> w{config, nullptr};
+  encodeCorpus(state, TAG_VALUES,
+               [&w](std::string_view s) { return w.STRING_LITERAL_QUOTE(s); });
+}
+BENCHMARK(Writer_NT_STRING_LITERAL_QUOTE_tags)->DenseRange(0, 2);
+
+static void Writer_NT_encodeIRIREF_tags(benchmark::State& state) {
+  osm2rdf::config::Config config;
+  osm2rdf::ttl::Writer<osm2rdf::ttl::format::NT> w{config, nullptr};
+  encodeCorpus(state, TAG_VALUES,
+               [&w](std::string_view s) { return w.encodeIRIREF(s); });
+}
+BENCHMARK(Writer_NT_encodeIRIREF_tags)->DenseRange(0, 2);
+
+static void Writer_QLEVER_encodeIRIREF_tags(benchmark::State& state) {
+  osm2rdf::config::Config config;
+  osm2rdf::ttl::Writer<osm2rdf::ttl::format::QLEVER> w{config, nullptr};
+  encodeCorpus(state, TAG_VALUES,
+               [&w](std::string_view s) { return w.encodeIRIREF(s); });
+}
+BENCHMARK(Writer_QLEVER_encodeIRIREF_tags)->DenseRange(0, 2);
+
+static void Writer_TTL_encodePN_LOCAL_keys(benchmark::State& state) {
+  osm2rdf::config::Config config;
+  osm2rdf::ttl::Writer<osm2rdf::ttl::format::TTL> w{config, nullptr};
+  encodeCorpus(state, TAG_KEYS,
+               [&w](std::string_view s) { return w.encodePN_LOCAL(s); });
+}
+BENCHMARK(Writer_TTL_encodePN_LOCAL_keys)->DenseRange(0, 2);
+
+static void Writer_TTL_generateLiteral_a_simd(benchmark::State& state) {
+  osm2rdf::config::Config config;
+  osm2rdf::ttl::Writer<osm2rdf::ttl::format::TTL> w{config, nullptr};
+  const std::vector<std::string> strings{std::string(1U << 11U, 'a')};
+  encodeCorpus(state, strings, [&w](std::string_view s) {
+    return w.generateLiteral(s, "");
+  });
+}
+BENCHMARK(Writer_TTL_generateLiteral_a_simd)->DenseRange(0, 2);
@@ -0,0 +1,37 @@
+#----------------------------------------------------------------------
+#
+#  FindLZ4.cmake
+#
+#  Find the LZ4 library.
+#
+#----------------------------------------------------------------------
+#
+#  Usage:
+#
+#      find_package(LZ4)
+#
+#      if(LZ4_FOUND)
+#          target_include_directories(target PRIVATE ${LZ4_INCLUDE_DIR})
+#          target_link_libraries(target PRIVATE ${LZ4_LIBRARY})
+#      endif()
+#
+#----------------------------------------------------------------------
+#
+#  Variables:
+#
+#    LZ4_FOUND        - True if LZ4 was found.
+#    LZ4_INCLUDE_DIR  - Where to find include files.
+#    LZ4_LIBRARY      - Library to link against.
+#
+#----------------------------------------------------------------------
+
+find_path(LZ4_INCLUDE_DIR lz4frame.h)
+find_library(LZ4_LIBRARY NAMES lz4)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(LZ4
+    REQUIRED_VARS LZ4_LIBRARY LZ4_INCLUDE_DIR)
+
+mark_as_advanced(LZ4_INCLUDE_DIR LZ4_LIBRARY)
+
+#----------------------------------------------------------------------
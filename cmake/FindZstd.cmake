@@ -0,0 +1,37 @@
+#----------------------------------------------------------------------
+#
+#  FindZstd.cmake
+#
+#  Find the Zstandard library.
+#
+#----------------------------------------------------------------------
+#
+#  Usage:
+#
+#      find_package(Zstd)
+#
+#      if(ZSTD_FOUND)
+#          target_include_directories(target PRIVATE ${ZSTD_INCLUDE_DIR})
+#          target_link_libraries(target PRIVATE ${ZSTD_LIBRARY})
+#      endif()
+#
+#----------------------------------------------------------------------
+#
+#  Variables:
+#
+#    ZSTD_FOUND        - True if Zstandard was found.
+#    ZSTD_INCLUDE_DIR  - Where to find include files.
+#    ZSTD_LIBRARY      - Library to link against.
+#
+#----------------------------------------------------------------------
+
+find_path(ZSTD_INCLUDE_DIR zstd.h)
+find_library(ZSTD_LIBRARY NAMES zstd)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(Zstd
+    REQUIRED_VARS ZSTD_LIBRARY ZSTD_INCLUDE_DIR)
+
+mark_as_advanced(ZSTD_INCLUDE_DIR ZSTD_LIBRARY)
+
+#----------------------------------------------------------------------
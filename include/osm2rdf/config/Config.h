@@ -41,6 +41,21 @@ enum CompressFormat {
   NONE = 0,
   BZ2 = 1,
   GZ = 2,
+  ZSTD = 3,
+  LZ4 = 4,
+};
+
+enum HugePages {
+  NO_HUGE_PAGES = 0,
+  TRANSPARENT_HUGE_PAGES = 1,
+  HUGE_PAGES_2M = 2,
+  HUGE_PAGES_1G = 3
+};
+
+enum NumaPlacement {
+  NUMA_LOCAL = 0,
+  NUMA_INTERLEAVE = 1,
+  NUMA_REPLICATE = 2
 };
 
 enum SourceDataset {
@@ -51,6 +66,13 @@ enum SourceDataset {
 struct Config {
   // Select what to do
   std::string storeLocations;
+  // Memory backing the mem-dense location index.
+  HugePages storeLocationsHugePages = NO_HUGE_PAGES;
+  NumaPlacement storeLocationsNuma = NUMA_LOCAL;
+  // Only store locations of nodes referenced by ways or relations.
+  bool storeLocationsReferencedOnly = false;
+  // Dump nodes and store their locations in the first pass.
+  bool nodesFirstPass = false;
 
   bool noFacts = false;
   bool noAreaFacts = false;
@@ -63,7 +85,28 @@ struct Config {
   bool noNodeGeometricRelations = false;
   bool noRelationGeometricRelations = false;
   bool noWayGeometricRelations = false;
+  // Geometric predicates to write, the others are calculated but dropped.
+  bool addIntersectsRelations = true;
+  bool addContainsRelations = true;
+  bool addCoversRelations = true;
+  bool addTouchesRelations = true;
+  bool addEqualsRelations = true;
+  bool addOverlapsRelations = true;
+  bool addCrossesRelations = true;
   double simplifyGeometries = 0;
+  // State of geometries and geometric relations for incremental updates,
+  // empty to disable.
+  std::filesystem::path geometryState;
+  // Add geometries to the sweep in spatial order.
+  bool sortGeometries = false;
+  // Tiles per axis for geometric relations, 0 for a single sweep.
+  int geometryTiles = 0;
+  // Local worker processes for tiles.
+  int geometryTileWorkers = 1;
+  // osm2rdf-tile executable, empty for the one next to osm2rdf.
+  std::filesystem::path geometryTileWorker;
+  // Seconds without progress after which tiles are reclaimed or fail.
+  int geometryTileTimeout = 600;
 
   SourceDataset sourceDataset = OSM;
 
@@ -106,7 +149,18 @@ struct Config {
   osm2rdf::util::OutputMergeMode mergeOutput =
       osm2rdf::util::OutputMergeMode::CONCATENATE;
   CompressFormat outputCompress = BZ2;
+  // Number of threads compressing full output buffers, 0 compresses on the
+  // writing thread.
+  int outputCompressionThreads = 0;
+  // Codec specific compression level, 0 selects the codec default.
+  int outputCompressionLevel = 0;
+  // Write full output buffers in the background, one more buffer per part.
+  bool outputAsyncWrite = false;
   bool outputKeepFiles = false;
+  // Continue statements with ';' and ',' instead of repeating the subject.
+  bool outputGroupSubjects = false;
+  // Number of subject-disjoint output files, 0 writes a single output.
+  int outputShards = 0;
 
   // osmium location cache
   std::filesystem::path cache{std::filesystem::temp_directory_path()};
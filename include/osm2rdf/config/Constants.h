@@ -27,6 +27,8 @@ namespace osm2rdf::config::constants {
 
 const static inline std::string BZIP2_EXTENSION = ".bz2";
 const static inline std::string GZ_EXTENSION = ".gz";
+const static inline std::string ZSTD_EXTENSION = ".zst";
+const static inline std::string LZ4_EXTENSION = ".lz4";
 const static inline std::string STATS_EXTENSION = ".stats";
 const static inline std::string CONTAINS_STATS_EXTENSION = ".contains-stats";
 const static inline std::string JSON_EXTENSION = ".json";
@@ -66,7 +68,7 @@ const static inline std::string OUTPUT_FORMAT_INFO = "Output format:";
 const static inline std::string OUTPUT_FORMAT_OPTION_SHORT = "";
 const static inline std::string OUTPUT_FORMAT_OPTION_LONG = "output-format";
 const static inline std::string OUTPUT_FORMAT_OPTION_HELP =
-    "Output format, valid values: nt, ttl, qlever";
+    "Output format, valid values: nt, ttl, qlever, binary";
 
 const static inline std::string OUTPUT_KEEP_FILES_OPTION_SHORT = "";
 const static inline std::string OUTPUT_KEEP_FILES_OPTION_LONG =
@@ -76,11 +78,57 @@ const static inline std::string OUTPUT_KEEP_FILES_OPTION_HELP =
 const static inline std::string OUTPUT_KEEP_FILES_OPTION_INFO =
     "Keeping temporary output files";
 
+const static inline std::string OUTPUT_SHARDS_OPTION_SHORT = "";
+const static inline std::string OUTPUT_SHARDS_OPTION_LONG = "output-shards";
+const static inline std::string OUTPUT_SHARDS_OPTION_HELP =
+    "Split the output into this many files by a hash of the subject, each "
+    "subject is contained in exactly one file";
+const static inline std::string OUTPUT_SHARDS_INFO = "Output shards:";
+
+const static inline std::string OUTPUT_GROUP_SUBJECTS_OPTION_SHORT = "";
+const static inline std::string OUTPUT_GROUP_SUBJECTS_OPTION_LONG =
+    "output-group-subjects";
+const static inline std::string OUTPUT_GROUP_SUBJECTS_OPTION_HELP =
+    "Group consecutive triples with the same subject using ';' and ',' "
+    "(ttl and qlever only)";
+const static inline std::string OUTPUT_GROUP_SUBJECTS_OPTION_INFO =
+    "Grouping triples by subject";
+
 const static inline std::string OUTPUT_COMPRESS_OPTION_SHORT = "";
 const static inline std::string OUTPUT_COMPRESS_OPTION_LONG =
     "output-compression";
 const static inline std::string OUTPUT_COMPRESS_OPTION_HELP =
-    "Output file compression, valid values: none, bz2, gz";
+    "Output file compression, valid values: none, bz2, gz, zstd, lz4";
+
+const static inline std::string OUTPUT_COMPRESSION_THREADS_INFO =
+    "Output compression threads:";
+const static inline std::string OUTPUT_COMPRESSION_THREADS_OPTION_SHORT = "";
+const static inline std::string OUTPUT_COMPRESSION_THREADS_OPTION_LONG =
+    "output-compression-threads";
+const static inline std::string OUTPUT_COMPRESSION_THREADS_OPTION_HELP =
+    "Number of threads compressing full output buffers as independent "
+    "streams, 0 to compress on the writing thread. zstd splits them as "
+    "workers of its multithreaded frame compression across the parts";
+
+const static inline std::string OUTPUT_COMPRESSION_LEVEL_INFO =
+    "Output compression level:";
+const static inline std::string OUTPUT_COMPRESSION_LEVEL_OPTION_SHORT = "";
+const static inline std::string OUTPUT_COMPRESSION_LEVEL_OPTION_LONG =
+    "output-compression-level";
+const static inline std::string OUTPUT_COMPRESSION_LEVEL_OPTION_HELP =
+    "Compression level of the selected codec, 0 for the codec default "
+    "(bz2: 1-9, default 3; gz: 1-9, default 6; zstd: 1-22, default 3; "
+    "lz4: 0-12, default 0)";
+
+const static inline std::string OUTPUT_ASYNC_WRITE_INFO =
+    "Write output buffers asynchronously";
+const static inline std::string OUTPUT_ASYNC_WRITE_OPTION_SHORT = "";
+const static inline std::string OUTPUT_ASYNC_WRITE_OPTION_LONG =
+    "output-async-write";
+const static inline std::string OUTPUT_ASYNC_WRITE_OPTION_HELP =
+    "Compress and write full output buffers in the background while the "
+    "next buffer is filled. Needs a second 100 MB buffer and a writer thread "
+    "per output part, i.e. (threads + 1) * shards * 100 MB more memory";
 
 const static inline std::string STORE_LOCATIONS_INFO =
     "Storing locations osmium locations:";
@@ -88,7 +136,48 @@ const static inline std::string STORE_LOCATIONS_SHORT = "";
 const static inline std::string STORE_LOCATIONS_LONG = "store-locations";
 const static inline std::string STORE_LOCATIONS_HELP =
     "Method used to store locations, valid values: mem-flex (default), "
-    "mem-dense, disk-sparse, disk-dense ";
+    "mem-dense, mem-compressed, disk-sparse, disk-dense, disk-persistent "
+    "(kept in the cache directory and reused for an input with the same "
+    "size, modification time and first 4 MiB), disk-join (way nodes joined "
+    "by sorting in the cache directory, no node index)";
+
+const static inline std::string STORE_LOCATIONS_HUGE_PAGES_INFO =
+    "Location index pages:";
+const static inline std::string STORE_LOCATIONS_HUGE_PAGES_SHORT = "";
+const static inline std::string STORE_LOCATIONS_HUGE_PAGES_LONG =
+    "store-locations-huge-pages";
+const static inline std::string STORE_LOCATIONS_HUGE_PAGES_HELP =
+    "Pages backing mem-dense locations, valid values: none (default), thp "
+    "(transparent huge pages), 2m, 1g (reserved huge pages, falls back to "
+    "thp)";
+
+const static inline std::string STORE_LOCATIONS_NUMA_INFO =
+    "Location index NUMA placement:";
+const static inline std::string STORE_LOCATIONS_NUMA_SHORT = "";
+const static inline std::string STORE_LOCATIONS_NUMA_LONG =
+    "store-locations-numa";
+const static inline std::string STORE_LOCATIONS_NUMA_HELP =
+    "NUMA placement of mem-dense locations, valid values: local (default), "
+    "interleave (pages spread over all nodes), replicate (one copy per node)";
+
+const static inline std::string STORE_LOCATIONS_REFERENCED_ONLY_INFO =
+    "Storing only locations of referenced nodes";
+const static inline std::string STORE_LOCATIONS_REFERENCED_ONLY_SHORT = "";
+const static inline std::string STORE_LOCATIONS_REFERENCED_ONLY_LONG =
+    "store-locations-referenced-only";
+const static inline std::string STORE_LOCATIONS_REFERENCED_ONLY_HELP =
+    "Only store locations of nodes referenced by ways or relations, collected "
+    "in a bitmap over all node IDs in the first pass";
+
+const static inline std::string NODES_FIRST_PASS_INFO =
+    "Dumping nodes in the first pass";
+const static inline std::string NODES_FIRST_PASS_SHORT = "";
+const static inline std::string NODES_FIRST_PASS_LONG = "nodes-first-pass";
+const static inline std::string NODES_FIRST_PASS_HELP =
+    "Dump nodes and store their locations in the first pass, the second pass "
+    "skips the node blocks of PBF input. Not possible with mem-dense, "
+    "disk-persistent, disk-join or --" +
+    STORE_LOCATIONS_REFERENCED_ONLY_LONG;
 
 const static inline std::string NO_OSM_METADATA_INFO =
     "Not outputting OSM metadata";
@@ -117,6 +206,18 @@ const static inline std::string OGC_GEO_TRIPLES_OPTION_LONG =
 const static inline std::string OGC_GEO_TRIPLES_OPTION_HELP =
     "Writing of OGC-style geometric triples, either 'full', or 'none'";
 
+const static inline std::string GEOMETRIC_PREDICATES_INFO =
+    "Geometric predicates:";
+const static inline std::string GEOMETRIC_PREDICATES_OPTION_SHORT = "";
+const static inline std::string GEOMETRIC_PREDICATES_OPTION_LONG =
+    "geometric-predicates";
+const static inline std::string GEOMETRIC_PREDICATES_OPTION_HELP =
+    "Comma separated geometric predicates to write, out of intersects, "
+    "contains, covers, touches, equals, overlaps and crosses. This only "
+    "filters the output, all predicates are still calculated";
+const static inline std::string GEOMETRIC_PREDICATES_ALL =
+    "intersects,contains,covers,touches,equals,overlaps,crosses";
+
 const static inline std::string NO_AREA_OPTION_SHORT = "";
 const static inline std::string NO_AREA_OPTION_LONG = "no-areas";
 const static inline std::string NO_AREA_OPTION_HELP = "Ignore areas";
@@ -264,6 +365,63 @@ const static inline std::string SIMPLIFY_GEOMETRIES_OPTION_HELP =
     "perimeter or length. This only affects "
     "relationship calculations and not the geometry dump";
 
+const static inline std::string GEOMETRY_STATE_INFO =
+    "Geometry state for incremental updates:";
+const static inline std::string GEOMETRY_STATE_OPTION_SHORT = "";
+const static inline std::string GEOMETRY_STATE_OPTION_LONG = "geometry-state";
+const static inline std::string GEOMETRY_STATE_OPTION_HELP =
+    "Store the geometries and geometric relations of this run at the given "
+    "path. If the state of a previous run exists there, only relations of "
+    "changed geometries are computed: added ones are written to the output, "
+    "removed ones to <path>.removed. The previous run must have written the "
+    "same --geometric-predicates. Not possible with --aux-geo-files";
+
+const static inline std::string SORT_GEOMETRIES_INFO =
+    "Sorting geometries along a Hilbert curve";
+const static inline std::string SORT_GEOMETRIES_OPTION_SHORT = "";
+const static inline std::string SORT_GEOMETRIES_OPTION_LONG =
+    "sort-geometries";
+const static inline std::string SORT_GEOMETRIES_OPTION_HELP =
+    "Add geometries to the geometric relation calculation in the order of a "
+    "Hilbert curve through their box centers. Spatially close geometries are "
+    "then stored close to each other in the geometry cache, at the cost of an "
+    "external sort";
+
+const static inline std::string GEOMETRY_TILES_INFO =
+    "Geometric relations in tiles per axis:";
+const static inline std::string GEOMETRY_TILES_OPTION_SHORT = "";
+const static inline std::string GEOMETRY_TILES_OPTION_LONG = "geometry-tiles";
+const static inline std::string GEOMETRY_TILES_OPTION_HELP =
+    "Calculate geometric relations separately in n x n tiles (1 to 256) by "
+    "osm2rdf-tile worker processes. The tile inputs are written to the cache "
+    "directory, workers on other machines sharing it can process tiles "
+    "concurrently. Not possible with --geometry-state or --aux-geo-files";
+const static inline std::string GEOMETRY_TILE_WORKERS_INFO =
+    "Local tile workers:";
+const static inline std::string GEOMETRY_TILE_WORKERS_OPTION_SHORT = "";
+const static inline std::string GEOMETRY_TILE_WORKERS_OPTION_LONG =
+    "geometry-tile-workers";
+const static inline std::string GEOMETRY_TILE_WORKERS_OPTION_HELP =
+    "Number of local osm2rdf-tile processes sharing the threads, 0 only waits "
+    "for workers started elsewhere";
+const static inline std::string GEOMETRY_TILE_WORKER_INFO = "Tile worker:";
+const static inline std::string GEOMETRY_TILE_WORKER_OPTION_SHORT = "";
+const static inline std::string GEOMETRY_TILE_WORKER_OPTION_LONG =
+    "geometry-tile-worker";
+const static inline std::string GEOMETRY_TILE_WORKER_OPTION_HELP =
+    "Path of the osm2rdf-tile executable, by default the one next to osm2rdf "
+    "(found through /proc/self/exe, only on Linux)";
+const static inline std::string GEOMETRY_TILE_TIMEOUT_INFO =
+    "Tile worker timeout in seconds:";
+const static inline std::string GEOMETRY_TILE_TIMEOUT_OPTION_SHORT = "";
+const static inline std::string GEOMETRY_TILE_TIMEOUT_OPTION_LONG =
+    "geometry-tile-timeout";
+const static inline std::string GEOMETRY_TILE_TIMEOUT_OPTION_HELP =
+    "Seconds (at least 10) after which a tile whose worker stopped updating "
+    "its claim is processed again by a local worker, and after which osm2rdf "
+    "fails if no worker claims any of the remaining tiles. The clocks of "
+    "machines sharing the cache directory must be synchronized";
+
 const static inline std::string SIMPLIFY_GEOMETRIES_INNER_OUTER_INFO =
     "Simplifying inner/outer geometries with factor: ";
 const static inline std::string SIMPLIFY_GEOMETRIES_INNER_OUTER_OPTION_SHORT =
@@ -0,0 +1,105 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_OSM_COMPRESSEDMEMINDEX_H
+#define OSM2RDF_OSM_COMPRESSEDMEMINDEX_H
+
+#include <osmium/index/index.hpp>
+#include <osmium/index/map.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace osm2rdf::osm {
+
+// Stores locations in blocks of BLOCK_SIZE entries in ID order. The first
+// entry of a block holds the absolute coordinates, all other entries the
+// differences of ID and coordinates to the previous entry. Each of the three
+// difference streams is bit-packed with the width that minimizes the block:
+// differences that do not fit are exceptions, their low bits are packed and
+// their high bits stored separately as varints. Consecutive IDs take no bits
+// at all. A page directory narrows the binary search over the first IDs of
+// the blocks, a lookup decodes a single block.
+//
+// Entries are collected in the last block until it is full. Entries set out
+// of ID order are kept in a separate list which has to be sorted with sort()
+// before lookups, like the sparse osmium indices.
+template <typename TId, typename TValue>
+class CompressedMemIndex : public osmium::index::map::Map<TId, TValue> {
+ public:
+  static const size_t BLOCK_SIZE = 64;
+  // Number of IDs covered by each directory page.
+  static const size_t PAGE_BITS = 16;
+  // Blocks are stored in chunks of CHUNK_S bytes, a block never spans two
+  // chunks. Chunks avoid copying all data when the storage grows.
+  static const size_t CHUNK_BITS = 26;
+  static const size_t CHUNK_S = size_t{1} << CHUNK_BITS;
+  // Upper bound for an encoded block: absolute coordinates, widths and
+  // exception counts, three fully packed streams and an exception with a
+  // maximal varint for every further entry, and slack for reading 64 bits at
+  // the last byte.
+  static const size_t MAX_BLOCK_S =
+      8 + 3 + 3 + 3 * (BLOCK_SIZE - 1) * (8 + 1 + 10) + 8;
+
+  CompressedMemIndex() = default;
+
+  size_t size() const noexcept final { return _size + _unsorted.size(); }
+
+  size_t used_memory() const noexcept final;
+
+  void set(const TId id, const TValue value) final;
+
+  TValue get_noexcept(const TId id) const noexcept final;
+
+  TValue get(const TId id) const final;
+
+  void clear() final;
+
+  void sort() final;
+
+ private:
+  // Encodes the collected entries as a new block.
+  void writeBlock();
+  // Returns the block which would contain id, or the number of blocks.
+  size_t findBlock(const TId id) const noexcept;
+  // Returns the location of id in the given block, or the empty location.
+  TValue getFromBlock(size_t block, const TId id) const noexcept;
+
+  std::vector<std::unique_ptr<uint8_t[]>> _chunks;
+  // Bytes used in the last chunk.
+  size_t _chunkPos = CHUNK_S;
+  // Per block: first ID and position (chunk << CHUNK_BITS | offset).
+  std::vector<TId> _firstIds;
+  std::vector<uint64_t> _positions;
+  // Per page: index of the first block starting in this page or later.
+  std::vector<uint64_t> _pages;
+  // Entries of the block being collected.
+  std::vector<TId> _blockIds;
+  std::vector<TValue> _blockValues;
+  // Last ID set in ID order.
+  TId _lastId = 0;
+  // Number of entries set in ID order.
+  size_t _size = 0;
+  // Entries not set in ID order.
+  std::vector<std::pair<TId, TValue>> _unsorted;
+};
+}  // namespace osm2rdf::osm
+
+#endif  // OSM2RDF_OSM_COMPRESSEDMEMINDEX_H
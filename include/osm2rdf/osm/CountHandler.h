@@ -31,6 +31,8 @@ class CountHandler : public osmium::handler::Handler {
   void relation(const osmium::Relation& relation);
   void way(const osmium::Way& way);
   void prepare_for_lookup();
+  // Adds the counts and node ID range of a shard of the first pass.
+  void merge(const CountHandler& other);
 
   size_t numNodes() const;
   size_t numRelations() const;
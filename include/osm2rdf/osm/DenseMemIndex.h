@@ -22,18 +22,35 @@
 #include <osmium/index/index.hpp>
 #include <osmium/index/map.hpp>
 
+#include <cstdint>
+#include <vector>
+
+#include "osm2rdf/config/Config.h"
+
 namespace osm2rdf::osm {
 
+// Stores locations in anonymous memory indexed by ID - minNodeId.
+// Coordinates are stored xor the undefined coordinate, so untouched pages
+// read as empty and are only allocated when first written, which places
+// them according to the NUMA policy.
+//
+// With NUMA_REPLICATE, each NUMA node gets its own copy, set() writes all
+// copies and lookups read the copy of the node the thread runs on. If the
+// copies can not be bound to their nodes, a single unbound copy is kept.
 template <typename TId, typename TValue>
 class DenseMemIndex : public osmium::index::map::Map<TId, TValue> {
  public:
-  explicit DenseMemIndex(size_t minNodeId, size_t maxNodeId);
+  explicit DenseMemIndex(
+      size_t minNodeId, size_t maxNodeId,
+      osm2rdf::config::HugePages hugePages = osm2rdf::config::NO_HUGE_PAGES,
+      osm2rdf::config::NumaPlacement numa = osm2rdf::config::NUMA_LOCAL);
+  ~DenseMemIndex() override;
+  DenseMemIndex(const DenseMemIndex&) = delete;
+  DenseMemIndex& operator=(const DenseMemIndex&) = delete;
 
-  size_t size() const noexcept final { return _index.size(); }
+  size_t size() const noexcept final { return _size; }
 
-  size_t used_memory() const noexcept final {
-    return sizeof(DenseMemIndex) + _index.size() * sizeof(TValue);
-  }
+  size_t used_memory() const noexcept final;
 
   void set(const TId id, const TValue value) final;
 
@@ -45,9 +62,31 @@ class DenseMemIndex : public osmium::index::map::Map<TId, TValue> {
 
   void sort() final{};
 
+  // Smallest size of the pages backing the copies, huge pages may be
+  // unavailable.
+  size_t pageSize() const noexcept { return _pageSize; }
+
+  // Number of copies, one per NUMA node with NUMA_REPLICATE.
+  size_t replicas() const noexcept { return _replicas.size(); }
+
+  // Returns true if the pages are interleaved over several NUMA nodes.
+  bool interleaved() const noexcept { return _interleaved; }
+
  private:
+  // Returns the copy for the NUMA node of the calling thread.
+  const int32_t* replica() const noexcept;
+
+  // Releases the copies from index first on.
+  void unmap(size_t first) noexcept;
+
   size_t _offset;
-  std::vector<TValue> _index;
+  size_t _size;
+  size_t _pageSize = 0;
+  bool _interleaved = false;
+  // Coordinates of each copy, indexed by NUMA node.
+  std::vector<int32_t*> _replicas;
+  // Mapped bytes of each copy, huge pages round up differently.
+  std::vector<size_t> _bytes;
 };
 }  // namespace osm2rdf::osm
 
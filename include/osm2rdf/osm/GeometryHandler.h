@@ -20,7 +20,11 @@
 #ifndef OSM2RDF_OSM_GEOMETRYHANDLER_H_
 #define OSM2RDF_OSM_GEOMETRYHANDLER_H_
 
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -28,6 +32,7 @@
 #include "gtest/gtest_prod.h"
 #include "osm2rdf/config/Config.h"
 #include "osm2rdf/osm/Area.h"
+#include "osm2rdf/osm/GeometryState.h"
 #include "osm2rdf/ttl/Writer.h"
 #include "osm2rdf/util/CacheFile.h"
 #include "osm2rdf/util/DirectedGraph.h"
@@ -57,6 +62,14 @@ class GeometryHandler {
   // Calculate data
   void calculateRelations();
 
+  // Tile workers, see --geometry-tiles: claims a tile for this process,
+  // false if it is claimed or done already. Stale claims are reclaimed by the
+  // main process, see --geometry-tile-timeout.
+  static bool claimTile(const std::filesystem::path& tile);
+  // Calculates the relations of a tile and writes them next to it, keeping
+  // its claim fresh meanwhile.
+  void processTile(const std::filesystem::path& tile);
+
   // Global config
   osm2rdf::config::Config _config;
   osm2rdf::ttl::Writer<W>* _writer;
@@ -65,8 +78,6 @@ class GeometryHandler {
   sj::Sweeper _sweeper;
   std::vector<sj::WriteBatch> _parseBatches;
 
-  std::string areaNS(AreaFromType type) const;
-
   static ::util::geo::I32Point transform(const ::util::geo::DPoint& loc);
 
   static ::util::geo::I32Box transform(const ::util::geo::DBox& box);
@@ -75,11 +86,79 @@ class GeometryHandler {
   static ::util::geo::I32MultiPolygon transform(
       const ::util::geo::DMultiPolygon& area);
 
+  // Key of an OSM object in the sweep, see COMPACT_ID_MARKER.
+  static std::string compactId(char type, uint64_t id);
+  static std::string compactId(uint64_t stateKey);
+  // Key of an OSM object in the geometry state: type tag in the highest byte
+  // followed by the ID.
+  static uint64_t stateKey(char type, uint64_t id);
+  static uint64_t stateKey(const std::string& id);
+  // Writes the IRI for a key of the sweep.
+  void writeId(typename osm2rdf::ttl::Writer<W>::Cursor* triple,
+               const std::string& id) const;
+  void writeKey(typename osm2rdf::ttl::Writer<W>::Cursor* triple,
+                uint64_t key) const;
+
+  // Adds a geometry encoded as a record: records it in the geometry state
+  // and adds it to the sweep, if changed.
+  void addGeometry(const std::string& record, size_t t);
+  // Adds a record to the sweep, or to the spilled records if sorted.
+  void sweepRecord(std::string_view record, size_t t);
+  // Adds the spilled records to the sweep along a Hilbert curve.
+  void addSorted();
+  // Records a geometry, encoded as a state record, in the new state. Returns
+  // false if it is unchanged since the last run: the record is then spilled
+  // and only added to the sweep if it is near a changed geometry.
+  bool stateChanged(size_t t, const std::string& record);
+  // Adds an encoded record to the sweep.
+  void addRecord(std::string_view record, size_t t);
+  // Adds encoded records to the sweep in parallel, each thread a contiguous
+  // range, and passes all batches to the sweeper.
+  void addRecords(const std::vector<std::string_view>& records);
+  // Determines the changed geometries and adds spilled ones near them.
+  void addChangedNeighbours(const std::vector<StateEntry>& entries);
+  // Writes the new state, in incremental mode also the changed relations.
+  void writeState(const std::vector<StateEntry>& entries);
+  bool changed(uint64_t key) const;
+  // Whether geometries pass through records, see RecordType.
+  bool encodeRecords() const;
+
+  // Writes the spilled records into one file per tile, a geometry into each
+  // tile its box intersects. Returns the non-empty tiles.
+  std::vector<std::filesystem::path> writeTiles();
+  // Runs local workers and waits until all tiles are processed.
+  void runTiles(const std::vector<std::filesystem::path>& tiles);
+  // Writes the relations found in the tiles.
+  void mergeTiles(const std::vector<std::filesystem::path>& tiles);
+  // Calculates the relations of a claimed tile.
+  void sweepTile(const std::filesystem::path& tile);
+
   void writeRelCb(size_t t, const std::string& a, const std::string& b,
                   const std::string& pred);
   void progressCb(size_t progr);
 
   osm2rdf::util::ProgressBar _progressBar;
+
+  // Incremental updates, see --geometry-state. Everything except _state and
+  // _changed is kept per thread.
+  std::unique_ptr<GeometryState> _state;
+  std::vector<std::vector<StateEntry>> _stateEntries;
+  std::vector<std::ofstream> _stateSpills;
+  std::vector<std::ofstream> _stateRelations;
+  // Pairs (member, relation) of relation members.
+  std::vector<std::vector<std::pair<uint64_t, uint64_t>>> _stateMembers;
+  // Sorted keys of geometries whose relations are recomputed.
+  std::vector<uint64_t> _changed;
+  // Records added to the sweep later, see --sort-geometries and
+  // --geometry-tiles.
+  std::vector<std::ofstream> _recordSpills;
+
+  // Tile processed by this worker, _tiles is 0 otherwise.
+  uint32_t _tiles = 0;
+  uint32_t _tileX = 0;
+  uint32_t _tileY = 0;
+  std::unordered_map<uint64_t, StateBox> _tileBoxes;
+  std::vector<std::vector<StateRelation>> _tileRelations;
 };
 
 }  // namespace osm2rdf::osm
@@ -0,0 +1,176 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_OSM_GEOMETRYSTATE_H
+#define OSM2RDF_OSM_GEOMETRYSTATE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace osm2rdf::osm {
+
+// Bounding box of a geometry in the integer coordinates of the sweep.
+struct StateBox {
+  int32_t minX = 0;
+  int32_t minY = 0;
+  int32_t maxX = 0;
+  int32_t maxY = 0;
+  bool intersects(const StateBox& other) const noexcept {
+    return minX <= other.maxX && other.minX <= maxX && minY <= other.maxY &&
+           other.minY <= maxY;
+  }
+};
+
+// Geometry of an OSM object, identified by its key in the sweep.
+struct StateEntry {
+  uint64_t key = 0;
+  // Hash of the geometry as added to the sweep, see stateHash().
+  uint64_t hash = 0;
+  StateBox box;
+  bool operator<(const StateEntry& other) const noexcept {
+    return key < other.key;
+  }
+};
+
+// Geometric relation "a predicate b", predicate is the index of the
+// predicate in the sweep.
+struct StateRelation {
+  uint64_t a = 0;
+  uint64_t b = 0;
+  uint64_t predicate = 0;
+  bool operator<(const StateRelation& other) const noexcept {
+    return a != other.a   ? a < other.a
+           : b != other.b ? b < other.b
+                          : predicate < other.predicate;
+  }
+  bool operator==(const StateRelation& other) const noexcept {
+    return a == other.a && b == other.b && predicate == other.predicate;
+  }
+};
+
+// Returns the hash of a geometry stored in the state. The hash function is
+// fixed, unlike std::hash, and recorded in the state file.
+uint64_t stateHash(std::string_view geometry);
+
+// Geometries and geometric relations of a run, kept for incremental updates
+// in the next run. The state consists of two files:
+//
+//   <path>            magic:"OSM2RDFG" hash:"FNV1A-64" predicates:u64
+//                     count:u64 entries sorted by key
+//   <path>.relations  relations in no particular order
+//
+// predicates has bit i set if the predicate with index i is stored. The
+// entries are memory mapped and can be looked up concurrently. A state with
+// another hash function or other predicates is rejected.
+class GeometryState {
+ public:
+  // Opens the state at path for a run storing the given predicates, the
+  // state is empty if there is none.
+  GeometryState(const std::filesystem::path& path, uint64_t predicates);
+  ~GeometryState();
+  GeometryState(const GeometryState&) = delete;
+  GeometryState& operator=(const GeometryState&) = delete;
+
+  bool exists() const noexcept { return _mapped != nullptr; }
+  size_t size() const noexcept { return _size; }
+  const StateEntry* begin() const noexcept { return _entries; }
+  const StateEntry* end() const noexcept { return _entries + _size; }
+  // Returns the entry with the given key, nullptr if there is none.
+  const StateEntry* find(uint64_t key) const noexcept;
+  // Calls cb with each stored relation.
+  void forEachRelation(
+      const std::function<void(const StateRelation&)>& cb) const;
+
+  // Calls cb with each relation stored in the relations file at path.
+  static void readRelations(
+      const std::filesystem::path& path,
+      const std::function<void(const StateRelation&)>& cb);
+  // Writes entries, which have to be sorted by key, to path. An existing
+  // state at path is only replaced once all entries are written.
+  static void writeEntries(const std::filesystem::path& path,
+                           uint64_t predicates,
+                           const std::vector<StateEntry>& entries);
+
+ protected:
+  std::filesystem::path _path;
+  int _fileDescriptor = -1;
+  size_t _mappedBytes = 0;
+  void* _mapped = nullptr;
+  const StateEntry* _entries = nullptr;
+  size_t _size = 0;
+};
+
+// Suffix of files unique to this process among the hosts sharing a
+// directory: host name and process ID.
+std::string processSuffix();
+
+// Writes the relations of a new state. The file is written under a name
+// unique to the process and replaces the relations at path on close.
+class StateRelationWriter {
+ public:
+  explicit StateRelationWriter(const std::filesystem::path& path);
+  void add(const StateRelation& relation);
+  void close();
+  // Like close(), but keeps relations another writer stored at path first.
+  // Returns whether the relations were stored.
+  bool closeIfFirst();
+
+ protected:
+  // Closes the temporary file and throws if it could not be written.
+  void finish();
+
+  std::filesystem::path _path;
+  std::filesystem::path _tmpPath;
+  std::ofstream _out;
+};
+
+// Answers whether a box intersects any of a fixed set of boxes. Boxes are
+// stored in grids with cells of 2^14, 2^17, ... units, each box in the
+// finest grid in which it spans at most two cells per dimension.
+class BoxGrid {
+ public:
+  explicit BoxGrid(const std::vector<StateBox>& boxes);
+  bool intersects(const StateBox& box) const;
+  size_t size() const noexcept { return _boxes.size(); }
+
+ protected:
+  static const int FIRST_CELL_BITS = 14;
+  static const int CELL_BITS_STEP = 3;
+  static const int NUM_LEVELS = 6;
+  // Queries spanning more cells check all boxes of the level instead.
+  static const int64_t MAX_QUERY_CELLS = 1024;
+  static int cellBits(int level) {
+    return FIRST_CELL_BITS + level * CELL_BITS_STEP;
+  }
+  static uint64_t cellKey(int64_t x, int64_t y) {
+    return (static_cast<uint64_t>(x) << 32U) | static_cast<uint64_t>(y);
+  }
+  std::vector<StateBox> _boxes;
+  // Per level: box indices per cell and all box indices.
+  std::vector<std::unordered_map<uint64_t, std::vector<uint32_t>>> _cells;
+  std::vector<std::vector<uint32_t>> _levelBoxes;
+};
+
+}  // namespace osm2rdf::osm
+
+#endif  // OSM2RDF_OSM_GEOMETRYSTATE_H
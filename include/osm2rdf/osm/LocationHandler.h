@@ -20,7 +20,11 @@
 #define OSM2RDF_OSM_LOCATIONHANDLER_H_
 
 #include "osm2rdf/config/Config.h"
+#include "osm2rdf/osm/CompressedMemIndex.h"
 #include "osm2rdf/osm/DenseMemIndex.h"
+#include "osm2rdf/osm/PersistentLocationIndex.h"
+#include "osm2rdf/osm/ReferencedNodesHandler.h"
+#include "osm2rdf/osm/WayNodeJoin.h"
 #include "osm2rdf/util/CacheFile.h"
 #include "osmium/handler.hpp"
 #include "osmium/handler/node_locations_for_ways.hpp"
@@ -42,9 +46,58 @@ class LocationHandler : public osmium::handler::Handler {
   virtual void way(osmium::Way& way) = 0;
   [[nodiscard]] virtual osmium::Location get_node_location(
       const osmium::object_id_type id) const = 0;
-  // Helper creating the correct instance.
-  static LocationHandler* create(const osm2rdf::config::Config& config,
-                                 size_t nodeIdMin, size_t nodeIdMax);
+  // Returns true if node() and way() may be called concurrently for
+  // different objects, as long as all nodes are stored before the first way.
+  [[nodiscard]] virtual bool concurrent() const { return false; }
+  // Called once the locations of all nodes of the input are stored.
+  virtual void finish() {}
+  // Helper creating the correct instance. If referenced is given, only the
+  // locations of referenced nodes are stored.
+  static LocationHandler* create(
+      const osm2rdf::config::Config& config, size_t nodeIdMin,
+      size_t nodeIdMax,
+      const osm2rdf::osm::ReferencedNodesHandler* referenced = nullptr);
+};
+
+// Passes only referenced nodes to the wrapped handler, which is owned.
+class LocationHandlerFiltered : public LocationHandler {
+ public:
+  LocationHandlerFiltered(LocationHandler* handler,
+                          const osm2rdf::osm::ReferencedNodesHandler& referenced)
+      : _handler(handler), _referenced(referenced) {}
+  ~LocationHandlerFiltered() override { delete _handler; }
+  void node(const osmium::Node& node) {
+    if (_referenced.contains(node.positive_id())) {
+      _handler->node(node);
+    }
+  }
+  void way(osmium::Way& way) { _handler->way(way); }
+  [[nodiscard]] osmium::Location get_node_location(
+      const osmium::object_id_type nodeId) const {
+    return _handler->get_node_location(nodeId);
+  }
+  [[nodiscard]] bool concurrent() const { return _handler->concurrent(); }
+  void finish() { _handler->finish(); }
+
+ protected:
+  LocationHandler* _handler;
+  const osm2rdf::osm::ReferencedNodesHandler& _referenced;
+};
+
+// Reads way node locations joined by a WayNodeJoin, nodes are not stored.
+class LocationHandlerJoin : public LocationHandler {
+ public:
+  explicit LocationHandlerJoin(osm2rdf::osm::WayNodeJoin* join)
+      : _join(join) {}
+  void node(const osmium::Node& /*unused*/) {}
+  void way(osmium::Way& way) { _join->fill(way); }
+  [[nodiscard]] osmium::Location get_node_location(
+      const osmium::object_id_type nodeId) const {
+    return _join->get_node_location(nodeId);
+  }
+
+ protected:
+  osm2rdf::osm::WayNodeJoin* _join;
 };
 
 template <typename T>
@@ -117,6 +170,8 @@ class LocationHandlerImpl<osm2rdf::osm::DenseMemIndex<
   void way(osmium::Way& way);
   [[nodiscard]] osmium::Location get_node_location(
       const osmium::object_id_type nodeId) const;
+  // The index has a fixed ID range, locations are stored directly.
+  [[nodiscard]] bool concurrent() const { return true; }
 
  protected:
   osm2rdf::osm::DenseMemIndex<osmium::unsigned_object_id_type, osmium::Location>
@@ -126,8 +181,37 @@ class LocationHandlerImpl<osm2rdf::osm::DenseMemIndex<
       _handler;
 };
 
+template <>
+class LocationHandlerImpl<osm2rdf::osm::PersistentLocationIndex<
+    osmium::unsigned_object_id_type, osmium::Location>>
+    : public LocationHandler {
+ public:
+  explicit LocationHandlerImpl(const osm2rdf::config::Config& config,
+                               size_t nodeIdMin, size_t nodeIdMax);
+  // Stores node locations unless an existing index was attached.
+  void node(const osmium::Node& node);
+  void way(osmium::Way& way);
+  [[nodiscard]] osmium::Location get_node_location(
+      const osmium::object_id_type nodeId) const;
+  // The index has a fixed ID range, locations are stored directly.
+  [[nodiscard]] bool concurrent() const { return true; }
+  // Marks the index as complete for later runs.
+  void finish() { _index.finish(); }
+
+ protected:
+  osm2rdf::osm::PersistentLocationIndex<osmium::unsigned_object_id_type,
+                                        osmium::Location>
+      _index;
+  osmium::handler::NodeLocationsForWays<osm2rdf::osm::PersistentLocationIndex<
+      osmium::unsigned_object_id_type, osmium::Location>>
+      _handler;
+};
+
 using LocationHandlerRAMDense = LocationHandlerImpl<osm2rdf::osm::DenseMemIndex<
     osmium::unsigned_object_id_type, osmium::Location>>;
+using LocationHandlerRAMCompressed =
+    LocationHandlerImpl<osm2rdf::osm::CompressedMemIndex<
+        osmium::unsigned_object_id_type, osmium::Location>>;
 using LocationHandlerRAMFlex = LocationHandlerImpl<osmium::index::map::FlexMem<
     osmium::unsigned_object_id_type, osmium::Location>>;
 using LocationHandlerFSSparse =
@@ -136,6 +220,9 @@ using LocationHandlerFSSparse =
 using LocationHandlerFSDense =
     LocationHandlerImpl<osmium::index::map::DenseFileArray<
         osmium::unsigned_object_id_type, osmium::Location>>;
+using LocationHandlerFSPersistent =
+    LocationHandlerImpl<osm2rdf::osm::PersistentLocationIndex<
+        osmium::unsigned_object_id_type, osmium::Location>>;
 
 }  // namespace osm2rdf::osm
 
@@ -20,9 +20,12 @@
 #ifndef OSM2RDF_OSM_OSMIUMHANDLER_H
 #define OSM2RDF_OSM_OSMIUMHANDLER_H
 
+#include <vector>
+
 #include "osm2rdf/config/Config.h"
 #include "osm2rdf/osm/FactHandler.h"
 #include "osm2rdf/osm/GeometryHandler.h"
+#include "osm2rdf/osm/Relation.h"
 #include "osm2rdf/ttl/Writer.h"
 #include "osm2rdf/util/ProgressBar.h"
 #include "osmium/handler.hpp"
@@ -59,11 +62,17 @@ class OsmiumHandler : public osmium::handler::Handler {
   [[nodiscard]] size_t wayGeometriesHandled() const;
 
  protected:
+  // Builds the geometry of the relation, stores it for parent relations and
+  // dumps the relation.
+  void handleRelation(osm2rdf::osm::Relation* relation);
+
   osm2rdf::config::Config _config;
   osm2rdf::osm::FactHandler<W>* _factHandler;
   osm2rdf::osm::GeometryHandler<W>* _geometryHandler;
 
   osm2rdf::osm::RelationHandler _relationHandler;
+  // Relations with a nested level, handled after all other objects.
+  std::vector<osm2rdf::osm::Relation> _nestedRelations;
   osm2rdf::util::ProgressBar _progressBar;
   size_t _areasSeen = 0;
   size_t _areasDumped = 0;
@@ -0,0 +1,82 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_OSM_PBFBLOCKS_H
+#define OSM2RDF_OSM_PBFBLOCKS_H
+
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace osm2rdf::osm {
+
+// Offsets of the blobs of a PBF file, read from the blob headers without
+// decompressing any blob. The file has to start with the OSMHeader blob.
+class PbfBlocks {
+ public:
+  explicit PbfBlocks(const std::filesystem::path& path);
+
+  // End of the OSMHeader blob.
+  uint64_t headerEnd() const noexcept { return _headerEnd; }
+  // Start of each OSMData blob in file order.
+  const std::vector<uint64_t>& dataOffsets() const noexcept {
+    return _dataOffsets;
+  }
+  uint64_t fileSize() const noexcept { return _fileSize; }
+
+ protected:
+  uint64_t _headerEnd = 0;
+  std::vector<uint64_t> _dataOffsets;
+  uint64_t _fileSize = 0;
+};
+
+// Streams the OSMHeader blob of a PBF file followed by all blobs from offset
+// on through a pipe, so the remaining blocks can be read like a PBF file
+// without reading or decompressing the skipped ones.
+class PbfSection {
+ public:
+  PbfSection(const std::filesystem::path& path, uint64_t headerEnd,
+             uint64_t offset);
+  ~PbfSection();
+  PbfSection(const PbfSection&) = delete;
+  PbfSection& operator=(const PbfSection&) = delete;
+
+  // Path of the read end of the pipe.
+  std::string path() const;
+
+  // Waits for the section to be streamed after it was read, throws if the
+  // file could not be read or the pipe not be written.
+  void close();
+
+ protected:
+  void feed(const std::filesystem::path& path, uint64_t headerEnd,
+            uint64_t offset);
+
+  int _readFileDescriptor = -1;
+  int _writeFileDescriptor = -1;
+  std::thread _feeder;
+  // Error of the feeder, the reader only sees a truncated file.
+  std::exception_ptr _error;
+};
+
+}  // namespace osm2rdf::osm
+
+#endif  // OSM2RDF_OSM_PBFBLOCKS_H
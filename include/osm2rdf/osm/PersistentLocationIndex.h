@@ -0,0 +1,103 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_OSM_PERSISTENTLOCATIONINDEX_H
+#define OSM2RDF_OSM_PERSISTENTLOCATIONINDEX_H
+
+#include <osmium/index/index.hpp>
+#include <osmium/index/map.hpp>
+
+#include <cstdint>
+#include <filesystem>
+
+namespace osm2rdf::osm {
+
+// Dense location index in a memory mapped file which is kept after the run.
+// The file starts with a header recording the checksum of the input file and
+// the node ID range:
+//
+//   magic:"OSM2RDFN" version:u32 complete:u32 checksum:u64 minNodeId:u64
+//   maxNodeId:u64 padding to 64 bytes
+//
+// followed by one location per ID. Coordinates are stored xor the undefined
+// coordinate, unset entries are zero and take no space in sparse files.
+//
+// If a complete file for the same input and ID range exists, it is attached
+// read-only and set() does nothing. Otherwise a new file is created, which is
+// only attached by later runs after finish() was called.
+template <typename TId, typename TValue>
+class PersistentLocationIndex : public osmium::index::map::Map<TId, TValue> {
+ public:
+  PersistentLocationIndex(const std::filesystem::path& path, uint64_t checksum,
+                          size_t minNodeId, size_t maxNodeId);
+  ~PersistentLocationIndex() override;
+  PersistentLocationIndex(const PersistentLocationIndex&) = delete;
+  PersistentLocationIndex& operator=(const PersistentLocationIndex&) = delete;
+
+  // Returns true if an existing index was attached.
+  bool readOnly() const noexcept { return _readOnly; }
+
+  // Marks a new file as complete, to be called once all locations are set.
+  void finish();
+
+  size_t size() const noexcept final { return _size; }
+
+  size_t used_memory() const noexcept final { return 0; }
+
+  void set(const TId id, const TValue value) final;
+
+  TValue get_noexcept(const TId id) const noexcept final;
+
+  TValue get(const TId id) const final;
+
+  void clear() final;
+
+  void sort() final{};
+
+  // Checksum of the size, modification time and first 4 MiB of the given
+  // file. Reading the whole planet on each run would cost
+  // as much as the first pass.
+  static uint64_t checksum(const std::filesystem::path& path);
+
+ private:
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t complete;
+    uint64_t checksum;
+    uint64_t minNodeId;
+    uint64_t maxNodeId;
+    char padding[24];
+  };
+  // Attaches the file at path if it matches header, returns false otherwise.
+  bool attach(const std::filesystem::path& path, const Header& header);
+  // Creates a new file at path with the given header.
+  void create(const std::filesystem::path& path, const Header& header);
+
+  size_t _offset;
+  size_t _size;
+  bool _readOnly = false;
+  int _fileDescriptor = -1;
+  size_t _mappedBytes = 0;
+  void* _mapped = nullptr;
+  // Coordinates of the first ID, directly after the header.
+  int32_t* _data = nullptr;
+};
+}  // namespace osm2rdf::osm
+
+#endif  // OSM2RDF_OSM_PERSISTENTLOCATIONINDEX_H
@@ -0,0 +1,59 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_OSM_REFERENCEDNODESHANDLER_H
+#define OSM2RDF_OSM_REFERENCEDNODESHANDLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "osmium/handler.hpp"
+#include "osmium/osm/relation.hpp"
+#include "osmium/osm/way.hpp"
+
+namespace osm2rdf::osm {
+
+// Collects the IDs of all nodes referenced by ways or as relation members in
+// a bitmap. Only these node locations are looked up in pass 2.
+class ReferencedNodesHandler : public osmium::handler::Handler {
+ public:
+  void relation(const osmium::Relation& relation);
+  void way(const osmium::Way& way);
+
+  // Returns true if the node is referenced by a way or relation.
+  [[nodiscard]] bool contains(uint64_t nodeId) const noexcept {
+    const uint64_t word = nodeId >> WORD_BITS;
+    return word < _bits.size() && ((_bits[word] >> (nodeId & WORD_MASK)) & 1U);
+  }
+
+  // Number of distinct referenced nodes.
+  [[nodiscard]] size_t size() const noexcept { return _size; }
+
+ protected:
+  static const uint64_t WORD_BITS = 6;
+  static const uint64_t WORD_MASK = (uint64_t{1} << WORD_BITS) - 1;
+
+  void add(uint64_t nodeId);
+
+  std::vector<uint64_t> _bits;
+  size_t _size = 0;
+};
+}  // namespace osm2rdf::osm
+
+#endif  // OSM2RDF_OSM_REFERENCEDNODESHANDLER_H
@@ -19,31 +19,81 @@
 #ifndef OSM2RDF_OSM_RELATIONHANDLER_H
 #define OSM2RDF_OSM_RELATIONHANDLER_H
 
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
 #include "osm2rdf/config/Config.h"
 #include "osm2rdf/osm/LocationHandler.h"
+#include "osm2rdf/util/DirectedGraph.h"
+#include "util/geo/Geo.h"
 
 namespace osm2rdf::osm {
 
+// Geometry of a relation which is a member of other relations.
+struct RelationGeometry {
+  ::util::geo::DCollection geom;
+  bool complete = false;
+};
+
 class RelationHandler : public osmium::handler::Handler {
  public:
+  static const uint32_t NO_NESTED_LEVEL = std::numeric_limits<uint32_t>::max();
   explicit RelationHandler(const osm2rdf::config::Config& config);
   void relation(const osmium::Relation& relation);
   void way(const osmium::Way& way);
   void prepare_for_lookup();
+  // Adds the relation members collected by a shard of the first pass. Only
+  // valid before prepare_for_lookup.
+  void merge(const RelationHandler& other);
   void setLocationHandler(osm2rdf::osm::LocationHandler* locationHandler);
   bool hasLocationHandler() const;
   osmium::Location get_node_location(const uint64_t nodeId) const;
-  std::vector<uint64_t> get_noderefs_of_way(const uint64_t wayId);
+  std::vector<uint64_t> get_noderefs_of_way(const uint64_t wayId) const;
+  // Decodes the node refs of the way into nodeRefs, which is cleared first.
+  // Empty if the way is unknown.
+  void get_noderefs_of_way(const uint64_t wayId,
+                           std::vector<uint64_t>* nodeRefs) const;
+  // Level of the relation in the graph of relation members: 0 for member
+  // relations without relation members, otherwise one more than the highest
+  // level of its relation members. NO_NESTED_LEVEL for relations not in the
+  // graph and for relations in or above a cycle.
+  uint32_t nestedLevel(const uint64_t relationId) const;
+  // Stores the geometry of a relation with a nested level for its parents.
+  // Only writes the slot reserved for the relation, so relations of the same
+  // level can be stored concurrently.
+  void setRelationGeometry(const uint64_t relationId,
+                           const ::util::geo::DCollection& geom,
+                           bool complete);
+  // Returns the stored geometry of the relation, nullptr if it has no nested
+  // level.
+  const RelationGeometry* get_relation_geometry(
+      const uint64_t relationId) const;
 
  private:
-  std::vector<uint32_t> getCompressedIDs(const osmium::Way& way) const;
-  std::vector<uint64_t> getNodeRefs(const std::vector<uint32_t>& refs) const;
+  void appendVarint(uint64_t value);
 
  protected:
   osm2rdf::config::Config _config;
   osm2rdf::osm::LocationHandler* _locationHandler = nullptr;
-  std::unordered_map<uint32_t, std::vector<uint32_t>> _ways32;
-  std::unordered_map<uint64_t, std::vector<uint32_t>> _ways64;
+  // Way members of non-area relations, sorted and unique after the first
+  // pass.
+  std::vector<uint64_t> _wayIds;
+  // Per way in _wayIds: range of its node refs in _nodeRefs. Ranges are
+  // assigned in the order the ways arrive.
+  struct NodeRefRange {
+    uint64_t begin = 0;
+    uint64_t end = 0;
+  };
+  std::vector<NodeRefRange> _nodeRefRanges;
+  // Node refs of all ways as zigzag and varint encoded differences to the
+  // previous ref of the same way.
+  std::vector<uint8_t> _nodeRefs;
+  // Edges from relations to their relation members.
+  osm2rdf::util::DirectedGraph<uint64_t> _relationGraph;
+  std::unordered_map<uint64_t, uint32_t> _nestedLevels;
+  std::unordered_map<uint64_t, RelationGeometry> _relationGeometries;
   bool _firstPassDone = false;
 };
 }
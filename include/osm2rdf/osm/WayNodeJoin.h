@@ -0,0 +1,85 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_OSM_WAYNODEJOIN_H
+#define OSM2RDF_OSM_WAYNODEJOIN_H
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "osm2rdf/config/Config.h"
+#include "osm2rdf/util/ExternalSorter.h"
+#include "osmium/handler.hpp"
+#include "osmium/osm/location.hpp"
+#include "osmium/osm/relation.hpp"
+#include "osmium/osm/way.hpp"
+
+namespace osm2rdf::osm {
+
+// Resolves way node locations with a sort-merge join instead of a location
+// index over all nodes:
+//
+//  1. Pass 1 numbers all way node refs in input order and collects
+//     (node ID, ref number) records.
+//  2. join() sorts these by node ID, merges them with the nodes of the input
+//     file and sorts the resulting (ref number, location) records back into
+//     input order.
+//  3. Pass 2 reads the locations sequentially while the ways arrive in the
+//     same order.
+//
+// Sorting spills to the cache directory. Relations need random lookups, so
+// locations of their node members and the nodes of their member ways are
+// kept in memory.
+class WayNodeJoin : public osmium::handler::Handler {
+ public:
+  explicit WayNodeJoin(const osm2rdf::config::Config& config);
+
+  // Pass 1: collect refs.
+  void relation(const osmium::Relation& relation);
+  void way(const osmium::Way& way);
+
+  // Joins the collected refs with the nodes of the input file, which has to
+  // be sorted by ID.
+  void join();
+
+  // Pass 2: sets the node locations of the next way. Ways have to be passed
+  // in the order of pass 1.
+  void fill(osmium::Way& way);
+  // Returns the location of a node referenced by a relation.
+  [[nodiscard]] osmium::Location get_node_location(uint64_t nodeId) const;
+
+  // Number of way node refs.
+  [[nodiscard]] uint64_t numRefs() const noexcept { return _numRefs; }
+
+ protected:
+  osm2rdf::config::Config _config;
+  std::unique_ptr<osm2rdf::util::ExternalSorter> _refsByNode;
+  std::unique_ptr<osm2rdf::util::ExternalSorter> _locationsByRef;
+  uint64_t _numRefs = 0;
+  // Number of refs filled in pass 2.
+  uint64_t _nextRef = 0;
+  // Members of non-area relations, sorted by join().
+  std::vector<uint64_t> _relationNodes;
+  std::vector<uint64_t> _relationWays;
+  std::unordered_map<uint64_t, osmium::Location> _relationLocations;
+};
+}  // namespace osm2rdf::osm
+
+#endif  // OSM2RDF_OSM_WAYNODEJOIN_H
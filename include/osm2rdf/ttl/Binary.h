@@ -0,0 +1,119 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_TTL_BINARY_H_
+#define OSM2RDF_TTL_BINARY_H_
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Binary triple stream written by Writer<format::BINARY>:
+//
+//   stream  ::= record*
+//   record  ::= HEADER | DEFINE | TRIPLE
+//   HEADER  ::= "OSM2RDFB" version:u8 slotBits:u8
+//   DEFINE  ::= 'D' part:varint slot:u32 length:varint term:u8[length]
+//   TRIPLE  ::= 'T' part:varint s:u32 p:u32 o:u32
+//
+// Terms use N-Triples syntax. Each output part has its own table of
+// 2^slotBits term slots, DEFINE stores a term in a slot of its part and
+// TRIPLE references three slots. Parts may be interleaved in any way as long
+// as the records of each part keep their order, a reader keeps one table per
+// part. Slots 0, 1 and 2 hold terms too long for the table and are redefined
+// for each use as subject, predicate and object. Integers are little endian,
+// varints use 7 bits per byte, least significant group first.
+
+namespace osm2rdf::ttl::binary {
+
+const static inline std::string MAGIC = "OSM2RDFB";
+const static uint8_t VERSION = 1;
+const static uint8_t SLOT_BITS = 16;
+// Limits accepted by the decoder.
+const static uint8_t MAX_SLOT_BITS = 24;
+const static uint64_t MAX_PARTS = 1U << 16U;
+const static char DEFINE = 'D';
+const static char TRIPLE = 'T';
+// Number of slots reserved for uncached terms.
+const static uint32_t SCRATCH_SLOTS = 3;
+// Longer terms (mostly geometries) are not cached.
+const static size_t MAX_CACHED_TERM_LENGTH = 256;
+
+// Appends the stream header to out.
+void writeHeader(std::string* out);
+
+// Encodes the triples of a single output part. Terms of the current triple
+// are collected with append and endTerm, encodeTriple then returns all
+// records required for the triple.
+class Encoder {
+ public:
+  explicit Encoder(size_t part);
+  // Appends to the current term.
+  void append(std::string_view s) { _terms.append(s); }
+  void append(char c) { _terms.push_back(c); }
+  // Finishes subject or predicate of the current triple.
+  void endTerm();
+  // Encodes the collected terms as triple. The result is valid until the
+  // next call.
+  std::string_view encodeTriple();
+  // Encodes the given terms as triple.
+  std::string_view encodeTriple(std::string_view s, std::string_view p,
+                                std::string_view o);
+
+ protected:
+  // Returns the slot holding term t, appends a DEFINE record if needed.
+  uint32_t lookup(std::string_view t, uint32_t position);
+  void writeVarint(uint64_t v);
+  void writeUint32(uint32_t v);
+
+  // Encoded part number.
+  std::string _part;
+  // Cached term per slot.
+  std::vector<std::string> _slots;
+  // Terms of the current triple and the end of subject and predicate.
+  std::string _terms;
+  size_t _ends[2] = {0, 0};
+  size_t _numEnds = 0;
+  // Slots of the current triple.
+  uint32_t _ids[3] = {0, 0, 0};
+  // Encoded records.
+  std::string _records;
+};
+
+// Decodes a binary triple stream into N-Triples.
+class Decoder {
+ public:
+  // Writes each triple in in as N-Triples line to out. Throws
+  // std::runtime_error for malformed input.
+  void decode(std::istream& in, std::ostream& out);
+
+ protected:
+  uint64_t readVarint(std::istream& in);
+  uint32_t readUint32(std::istream& in);
+  std::vector<std::string>& table(uint64_t part);
+
+  uint8_t _slotBits = 0;
+  std::vector<std::vector<std::string>> _tables;
+};
+
+}  // namespace osm2rdf::ttl::binary
+
+#endif  // OSM2RDF_TTL_BINARY_H_
@@ -74,6 +74,8 @@ inline std::string IRI__OSM2RDF_MEMBER__ROLE;
 inline std::string IRI__OSM2RDF_MEMBER__POS;
 inline std::string IRI__OSMMETA_CHANGESET;
 inline std::string IRI__OSM2RDF__LENGTH;
+inline std::string IRI__OSM2RDF__AREA;
+inline std::string IRI__OSM2RDF__COMPLETE_GEOMETRY;
 inline std::string IRI__OSMMETA_TIMESTAMP;
 inline std::string IRI__OSMMETA_USER;
 inline std::string IRI__OSMMETA_UID;
@@ -92,6 +94,9 @@ inline std::string IRI__OSM_TAG;
 inline std::string IRI__OSM_WAY;
 inline std::string IRI__OSM_USER;
 inline std::string IRI__OSM_CHANGESET;
+inline std::string IRI__OSMREL_MEMBER;
+inline std::string IRI__OSMKEY_KEY;
+inline std::string IRI__OSMKEY_VALUE;
 
 inline std::string IRI__RDF_TYPE;
 
@@ -105,6 +110,16 @@ inline std::string IRI__XSD_BOOLEAN;
 inline std::string IRI__XSD_YEAR;
 inline std::string IRI__XSD_YEAR_MONTH;
 
+// Datatype suffixes of typed literals, e.g. "^^xsd:integer"
+inline std::string LITERAL_SUFFIX__GEOSPARQL__WKT_LITERAL;
+inline std::string LITERAL_SUFFIX__XSD_DATE;
+inline std::string LITERAL_SUFFIX__XSD_DATE_TIME;
+inline std::string LITERAL_SUFFIX__XSD_DECIMAL;
+inline std::string LITERAL_SUFFIX__XSD_DOUBLE;
+inline std::string LITERAL_SUFFIX__XSD_INTEGER;
+inline std::string LITERAL_SUFFIX__XSD_YEAR;
+inline std::string LITERAL_SUFFIX__XSD_YEAR_MONTH;
+
 inline std::string LITERAL__FALSE;
 inline std::string LITERAL__TRUE;
 
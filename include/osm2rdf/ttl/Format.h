@@ -26,6 +26,8 @@ namespace osm2rdf::ttl::format {
 struct QLEVER {};
 struct TTL {};
 struct NT {};
+// Binary triple stream, see osm2rdf/ttl/Binary.h
+struct BINARY {};
 }  // namespace osm2rdf::ttl::format
 
 #endif  // OSM2RDF_TTL_OUTPUTFORMAT_H_
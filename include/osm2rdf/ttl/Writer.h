@@ -76,6 +76,7 @@ static const int MASK_BITS_OF_ONE_BYTE = k0xFF;
 static const int UTF8_BYTES_LONG = 8;
 static const int UTF8_BYTES_SHORT = 4;
 #include <string>
+#include <vector>
 
 #include "gtest/gtest_prod.h"
 #include "osm2rdf/config/Config.h"
@@ -86,6 +87,7 @@ static const int UTF8_BYTES_SHORT = 4;
 #include "osm2rdf/osm/Tag.h"
 #include "osm2rdf/osm/TagList.h"
 #include "osm2rdf/osm/Way.h"
+#include "osm2rdf/ttl/Binary.h"
 #include "osm2rdf/ttl/Constants.h"
 #include "osm2rdf/util/Output.h"
 
@@ -103,6 +105,10 @@ class Writer {
   // Write the header (does nothing for NT)
   void writeHeader();
 
+  // Terminates the open statement of each part if subjects are grouped. Must
+  // be called before the output is closed.
+  void closeGroups();
+
   // Write a single RDF line. The contents of s, p, and o are not checked.
   void writeTriple(const std::string& s, const std::string& p,
                    const std::string& o);
@@ -129,6 +135,38 @@ class Writer {
                                 const std::string& a, const std::string& b,
                                 size_t part);
 
+  // Appends the terms of a single triple directly to an output part without
+  // building intermediate strings. Terms are separated by a space, end()
+  // finishes the line:
+  //   writer.triple().term(subj).term(pred).integerLiteral(42, suffix).end();
+  class Cursor {
+   public:
+    Cursor(Writer<T>* writer, size_t part);
+    // Appends an already formatted term, e.g. a generated constant.
+    Cursor& term(std::string_view t);
+    // Appends the IRI from prefix p and value v, see writeIRI.
+    Cursor& iri(std::string_view p, uint64_t v);
+    Cursor& iri(std::string_view p, std::string_view v);
+    Cursor& iriUnsafe(std::string_view p, std::string_view v);
+    // Appends the (escaped) string literal v.
+    Cursor& literal(std::string_view v);
+    // Appends the literal v followed by the datatype suffix s.
+    Cursor& literalUnsafe(std::string_view v, std::string_view s);
+    Cursor& integerLiteral(int64_t v, std::string_view s);
+    Cursor& doubleLiteral(double v, std::string_view s);
+    // Terminates the triple.
+    void end();
+
+   protected:
+    void separate();
+    Writer<T>* _writer;
+    size_t _part;
+    bool _first = true;
+  };
+  // Starts a new triple in the output part of the current thread.
+  Cursor triple();
+  Cursor triple(size_t part);
+
   // addPrefix adds the given prefix and value. If the prefix already exists
   // false is returned.
   bool addPrefix(const std::string& prefix, std::string_view value);
@@ -172,6 +210,11 @@ class Writer {
   void writeLiteral(std::string_view v, size_t part);
   void writeLiteralUnsafe(std::string_view v, std::string_view s, size_t part);
 
+  // Writes integer and double values as typed literals with datatype suffix
+  // s. Doubles are formatted like std::to_string.
+  void writeIntegerLiteral(int64_t v, std::string_view s, size_t part);
+  void writeDoubleLiteral(double v, std::string_view s, size_t part);
+
   // -------------------------------------------------------------------------
   // Following functions are used by the ones above. These functions implement
   // the grammars.
@@ -195,6 +238,7 @@ class Writer {
   FRIEND_TEST(WriterGrammarTTL, RULE_18_IRIREF);
 
   std::string IRIREFUnsafe(std::string_view p, std::string_view v);
+  void writeIRIREFUnsafe(std::string_view p, std::string_view v, size_t part);
 
   std::string PrefixedNameUnsafe(std::string_view p, std::string_view v);
   std::string PrefixedName(std::string_view p, std::string_view v);
@@ -243,6 +287,28 @@ class Writer {
   FRIEND_TEST(WriterGrammarTTL, RULE_26_UCHAR_UTF8);
 
  protected:
+  // Appends s to the current triple in the given part.
+  void put(std::string_view s, size_t part);
+  void put(char c, size_t part);
+  // Separates two terms of the current triple.
+  void writeSeparator(size_t part);
+  // Terminates the current triple.
+  void writeTripleEnd(size_t part);
+  // Writes the triple collected in _pending for the given part.
+  void writeCollectedTriple(size_t part);
+  // Writes a complete triple into the output part of its subject.
+  void writeTerms(std::string_view s, std::string_view p, std::string_view o,
+                  size_t part);
+  // Writes a complete triple into output part outPart, continuing the open
+  // statement if it has the same subject.
+  void writeGroupedTriple(std::string_view s, std::string_view p,
+                          std::string_view o, size_t outPart);
+  // Returns the output part for a triple with subject s written by part.
+  size_t outputPart(std::string_view s, size_t part) const;
+  // Creates the per part state of the format, i.e. the term dictionaries for
+  // format::BINARY and the open statements for grouped subjects.
+  void initParts();
+
   // Config
   const osm2rdf::config::Config _config;
 
@@ -252,12 +318,34 @@ class Writer {
   // Output
   osm2rdf::util::Output* _out;
 
-  // Counter
+  // Counter, blank nodes per part, lines per output part.
   uint64_t* _blankNodeCount;
   uint64_t* _headerLines;
   uint64_t* _lineCount;
   // Number of parts.
   std::size_t _numOuts;
+  // Number of output shards, each shard has _numOuts output parts.
+  std::size_t _numShards;
+  // Term dictionary per output part, only used by format::BINARY.
+  std::vector<osm2rdf::ttl::binary::Encoder> _encoders;
+  // Terms of the current triple and the end of subject and predicate.
+  struct PendingTriple {
+    std::string terms;
+    size_t ends[2] = {0, 0};
+    size_t numEnds = 0;
+  };
+  // Current triple per part, only collected if the subject has to be known
+  // before anything is written.
+  std::vector<PendingTriple> _pending;
+  // Statement of an output part which is continued with ';' and ',' as long
+  // as the subject does not change.
+  struct Group {
+    std::string subject;
+    std::string predicate;
+    bool open = false;
+  };
+  // Open statement per output part, empty unless subjects are grouped.
+  std::vector<Group> _groups;
 };
 }  // namespace osm2rdf::ttl
 
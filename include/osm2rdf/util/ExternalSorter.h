@@ -0,0 +1,93 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_UTIL_EXTERNALSORTER_H_
+#define OSM2RDF_UTIL_EXTERNALSORTER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+namespace osm2rdf::util {
+
+// Sorts (key, value) records which may not fit into memory. Up to
+// maxRecords records are sorted in memory, larger inputs are written as
+// sorted runs next to prefix and merged on reading.
+class ExternalSorter {
+ public:
+  struct Record {
+    uint64_t key;
+    uint64_t value;
+
+    bool operator<(const Record& other) const noexcept {
+      return key < other.key || (key == other.key && value < other.value);
+    }
+  };
+
+  ExternalSorter(const std::filesystem::path& prefix, size_t maxRecords);
+  // Removes all runs.
+  ~ExternalSorter();
+  ExternalSorter(const ExternalSorter&) = delete;
+  ExternalSorter& operator=(const ExternalSorter&) = delete;
+
+  // Adds a record, only allowed before finish().
+  void add(uint64_t key, uint64_t value);
+  // Sorts the remaining records and prepares reading.
+  void finish();
+  // Stores the next record by (key, value) in record, returns false at the
+  // end.
+  bool next(Record* record);
+
+  // Number of records added.
+  [[nodiscard]] size_t size() const noexcept { return _size; }
+  // Number of runs written to disk.
+  [[nodiscard]] size_t numRuns() const noexcept { return _runPaths.size(); }
+
+ protected:
+  // Records read from each run at once.
+  static const size_t READ_BLOCK_SIZE = 1U << 16U;
+
+  struct Run {
+    std::ifstream in;
+    std::vector<Record> block;
+    size_t pos = 0;
+  };
+
+  // Sorts the buffer and writes it as a new run.
+  void spill();
+  // Reads the next block of run, returns false at its end.
+  bool refill(Run* run);
+
+  std::filesystem::path _prefix;
+  size_t _maxRecords;
+  size_t _size = 0;
+  std::vector<Record> _buffer;
+  // Position in _buffer if no run was written.
+  size_t _bufferPos = 0;
+  std::vector<std::filesystem::path> _runPaths;
+  std::vector<std::unique_ptr<Run>> _runs;
+  // Min heap of run indices by their current record.
+  std::vector<size_t> _heap;
+};
+
+}  // namespace osm2rdf::util
+
+#endif  // OSM2RDF_UTIL_EXTERNALSORTER_H_
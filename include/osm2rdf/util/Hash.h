@@ -0,0 +1,35 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef OSM2RDF_UTIL_HASH_H_
+#define OSM2RDF_UTIL_HASH_H_
+
+#include <cstdint>
+#include <string_view>
+
+namespace osm2rdf::util {
+
+// 64-bit FNV-1a offset basis, the hash of no data.
+const uint64_t FNV1A_BASIS = 0xcbf29ce484222325ULL;
+
+// Returns the 64-bit FNV-1a hash of data, continuing from hash. Unlike
+// std::hash the result is fixed and may be stored in files.
+uint64_t fnv1a(std::string_view data, uint64_t hash = FNV1A_BASIS);
+
+}  // namespace osm2rdf::util
+
+#endif  // OSM2RDF_UTIL_HASH_H_
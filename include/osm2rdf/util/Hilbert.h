@@ -0,0 +1,35 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_UTIL_HILBERT_H_
+#define OSM2RDF_UTIL_HILBERT_H_
+
+#include <cstdint>
+
+namespace osm2rdf::util {
+
+// Returns the position of (x, y) on the Hilbert curve through the
+// 2^32 x 2^32 grid. Points close on the curve are close in the plane.
+uint64_t hilbertKey(uint32_t x, uint32_t y);
+
+// Same for signed coordinates, which are shifted to be non-negative.
+uint64_t hilbertKey(int32_t x, int32_t y);
+
+}  // namespace osm2rdf::util
+
+#endif  // OSM2RDF_UTIL_HILBERT_H_
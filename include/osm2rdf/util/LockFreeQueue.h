@@ -0,0 +1,111 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_UTIL_LOCKFREEQUEUE_H_
+#define OSM2RDF_UTIL_LOCKFREEQUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace osm2rdf::util {
+
+// Bounded multi-producer multi-consumer queue without locks (Dmitry Vyukov's
+// design). Each cell carries a sequence number telling whether it is ready
+// for the next push or pop, so producers and consumers only contend on
+// their respective position counter.
+template <typename T>
+class LockFreeQueue {
+ public:
+  // Creates a queue holding at least capacity elements.
+  explicit LockFreeQueue(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) {
+      size <<= 1U;
+    }
+    _mask = size - 1;
+    _cells = std::make_unique<Cell[]>(size);
+    for (size_t i = 0; i < size; ++i) {
+      _cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  // Appends value, returns false if the queue is full.
+  bool push(const T& value) {
+    size_t pos = _pushPos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+      cell = &_cells[pos & _mask];
+      size_t seq = cell->seq.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+      if (diff == 0) {
+        if (_pushPos.compare_exchange_weak(pos, pos + 1,
+                                           std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = _pushPos.load(std::memory_order_relaxed);
+      }
+    }
+    cell->value = value;
+    cell->seq.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Removes the oldest element into value, returns false if the queue is
+  // empty.
+  bool pop(T* value) {
+    size_t pos = _popPos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+      cell = &_cells[pos & _mask];
+      size_t seq = cell->seq.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+      if (diff == 0) {
+        if (_popPos.compare_exchange_weak(pos, pos + 1,
+                                          std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = _popPos.load(std::memory_order_relaxed);
+      }
+    }
+    *value = cell->value;
+    cell->seq.store(pos + _mask + 1, std::memory_order_release);
+    return true;
+  }
+
+ protected:
+  struct Cell {
+    std::atomic<size_t> seq;
+    T value;
+  };
+  std::unique_ptr<Cell[]> _cells;
+  size_t _mask;
+  // Separate cache lines for producers and consumers.
+  alignas(64) std::atomic<size_t> _pushPos{0};
+  alignas(64) std::atomic<size_t> _popPos{0};
+};
+
+}  // namespace osm2rdf::util
+
+#endif  // OSM2RDF_UTIL_LOCKFREEQUEUE_H_
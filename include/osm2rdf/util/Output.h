@@ -19,14 +19,30 @@
 #ifndef OSM2RDF_UTIL_OUTPUT_H
 #define OSM2RDF_UTIL_OUTPUT_H
 
-#include <bzlib.h>
-#include <zlib.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include "osm2rdf/config/Config.h"
+#include "osm2rdf/util/OutputCodec.h"
+#include "osm2rdf/util/StdoutSink.h"
 
 static const size_t BUFFER_S = 1024 * 1024 * 100;
+// Fill level at which a part hands its buffer to the stdout writer.
+static const size_t STDOUT_CHUNK_S = 1024 * 1024 * 4;
+// Full chunks waiting for the stdout writer in addition to the chunk each part
+// fills. Chunks are BUFFER_S large to hold any record, but only the pages up
+// to the first record end after STDOUT_CHUNK_S are touched.
+static const size_t STDOUT_QUEUED_CHUNKS = 4;
+// Full buffers of a part waiting for the I/O workers before the writing
+// thread stalls, each part fills one more buffer meanwhile.
+static const size_t ASYNC_BLOCKS_PER_PART = 1;
 
 namespace osm2rdf::util {
 
@@ -36,6 +52,9 @@ class Output {
   Output(const osm2rdf::config::Config& config, const std::string& prefix,
          size_t partCount);
   ~Output();
+  // Output to stdout is written with writev to fd instead of through
+  // std::cout, call before open().
+  void setStdoutFd(int fd) { _stdoutFd = fd; }
   // Create and open all output streams.
   bool open();
   // Close all output streams.
@@ -50,22 +69,65 @@ class Output {
   // Write a newline into the specified part.
   void writeNewLine(size_t part);
 
+  // Marks the end of a record (a line or a binary record) in the specified
+  // part. Chunks written to stdout only end at record boundaries.
+  void endRecord(size_t part);
+
   void flush();
   // Flush the given part.
   void flush(size_t part);
   // Filename for given part. Special handling for -1 (prefix) and -2 (suffix).
   std::string partFilename(int part);
+  // Filename of the given shard, see config::outputShards.
+  std::string shardFilename(size_t shard);
+  // Number of shards, the parts are split into consecutive ranges of equal
+  // size, one per shard.
+  size_t shardCount() const { return _shardCount; }
+  // Total time writing threads waited for a free buffer, valid after close.
+  double stallSeconds() const;
 
  protected:
-  // Closes and concatenates all parts without decompressing and recompressing
-  // streams.
-  void concatenate();
+  // Concatenates count parts starting at first into target without
+  // decompressing and recompressing streams.
+  void concatenate(const std::string& target, size_t first, size_t count);
+  // Copies the parts in parallel into the preallocated target file inside the
+  // kernel (reflink, copy_file_range or sendfile). Returns false if none of
+  // these is available.
+  bool concatenateZeroCopy(const std::string& target, size_t first,
+                           size_t count);
+  // Copies len bytes from inFd into outFd starting at offset. Tries a reflink
+  // first, then copy_file_range and sendfile.
+  static bool copyPart(int inFd, int outFd, size_t offset, size_t len);
+  // Streams the parts through user space into the target file.
+  bool concatenateStream(const std::string& target, size_t first,
+                         size_t count);
+
+  // A full part buffer waiting to be compressed as an independent stream.
+  struct CompressJob {
+    size_t part;
+    size_t seq;
+    unsigned char* buf;
+    size_t len;
+  };
+  // Hand the buffer of the given part to the compression workers and continue
+  // with a fresh buffer.
+  void submitBlock(size_t part);
+  // Wait until all submitted blocks are written to their part files.
+  void waitForBlocks();
+  // Waits for all submitted blocks and stops the workers.
+  void stopWorkers();
+  // Frees the part buffers and the buffers returned by the workers.
+  void releaseBuffers();
+  // Worker loop: compress blocks and append them in order to their part.
+  void compressWorker();
   // Config instance.
   const osm2rdf::config::Config _config;
   // Prefix for all filenames.
   const std::string _prefix;
   // Number of parts.
   std::size_t _partCount;
+  // Number of shards.
+  std::size_t _shardCount;
   // Number of temporary output streams.
   std::size_t _numOuts;
   // Number of digits required for _partCount.
@@ -78,15 +140,37 @@ class Output {
 
   std::vector<unsigned char*> _outBuffers;
 
-  std::vector<FILE*> _rawFiles;
-  std::vector<BZFILE*> _files;
-  std::vector<gzFile> _gzFiles;
+  // One codec per part file.
+  std::vector<std::unique_ptr<OutputCodec>> _codecs;
   std::vector<size_t> _outBufPos;
 
-  std::vector<size_t> _lines;
-
   // true if output goes to stdout
   bool _toStdOut;
+  // Writer for stdout, owns the part buffers in this case.
+  std::unique_ptr<StdoutSink> _stdoutSink;
+  // Descriptor for stdout output, -1 to write through std::cout.
+  int _stdoutFd = -1;
+
+  // true if full buffers are compressed by _compressWorkers
+  bool _parallelCompress;
+  // true if full buffers are written to the streaming codecs by
+  // _compressWorkers, one worker per part.
+  bool _asyncWrite = false;
+  std::vector<std::thread> _compressWorkers;
+  std::deque<CompressJob> _compressJobs;
+  std::mutex _compressMutex;
+  std::condition_variable _compressCv;
+  // Per part: number of blocks handed to the workers and number of blocks
+  // already appended to the part file.
+  std::vector<size_t> _blocksSubmitted;
+  std::vector<size_t> _blocksWritten;
+  size_t _blocksInFlight = 0;
+  size_t _maxBlocksInFlight = 0;
+  std::vector<unsigned char*> _freeBuffers;
+  std::string _compressError;
+  bool _stopCompressWorkers = false;
+  // Per part: time spent waiting for a free buffer.
+  std::vector<std::chrono::steady_clock::duration> _stallTimes;
 };
 
 }  // namespace osm2rdf::util
@@ -0,0 +1,174 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_UTIL_OUTPUTCODEC_H_
+#define OSM2RDF_UTIL_OUTPUTCODEC_H_
+
+#include <bzlib.h>
+#include <zlib.h>
+
+#if defined(OSM2RDF_HAVE_ZSTD)
+#include <zstd.h>
+#endif
+#if defined(OSM2RDF_HAVE_LZ4)
+#include <lz4frame.h>
+#endif
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "osm2rdf/config/Config.h"
+
+namespace osm2rdf::util {
+
+// Compression of a single output part file. Data is either written as one
+// continuous stream (write) or as independently compressed blocks
+// (compressBlock + writeBlock). All supported formats allow concatenating
+// complete streams, so both variants produce valid files.
+class OutputCodec {
+ public:
+  virtual ~OutputCodec();
+  // Returns the codec for the configured output compression, one of parts
+  // codecs writing at the same time.
+  static std::unique_ptr<OutputCodec> create(
+      const osm2rdf::config::Config& config, size_t parts = 1);
+
+  // Opens the given file. Without streaming only writeBlock is allowed.
+  void open(const std::string& filename, bool streaming);
+  // Compresses data into the open stream.
+  void write(const unsigned char* data, size_t len);
+  // Appends a block created by compressBlock.
+  void writeBlock(const std::vector<char>& block);
+  // Finishes the stream and closes the file.
+  void close();
+
+  // Compresses data into a self-contained stream stored in out. Does not
+  // touch the file and can be called concurrently.
+  virtual void compressBlock(const unsigned char* data, size_t len,
+                             std::vector<char>* out) const = 0;
+  // True if the codec distributes a single stream onto multiple threads
+  // itself.
+  [[nodiscard]] virtual bool compressesInParallel() const { return false; }
+
+ protected:
+  OutputCodec(std::string name, int level);
+  virtual void beginStream() {}
+  virtual void writeStream(const unsigned char* data, size_t len) = 0;
+  virtual void endStream() {}
+  // Writes data without compression.
+  void writeRaw(const void* data, size_t len);
+  // Throws an error for the current file.
+  [[noreturn]] void fail(const std::string& what) const;
+
+  // Name used in error messages, e.g. "bzip2 file".
+  const std::string _name;
+  // Compression level, 0 selects the codec default.
+  const int _level;
+  std::string _filename;
+  FILE* _file = nullptr;
+  bool _streaming = false;
+};
+
+// No compression.
+class NoneCodec : public OutputCodec {
+ public:
+  NoneCodec();
+  void compressBlock(const unsigned char* data, size_t len,
+                     std::vector<char>* out) const override;
+
+ protected:
+  void writeStream(const unsigned char* data, size_t len) override;
+};
+
+// bzip2, level is the block size in 100k.
+class Bzip2Codec : public OutputCodec {
+ public:
+  explicit Bzip2Codec(int level);
+  ~Bzip2Codec() override;
+  void compressBlock(const unsigned char* data, size_t len,
+                     std::vector<char>* out) const override;
+
+ protected:
+  void beginStream() override;
+  void writeStream(const unsigned char* data, size_t len) override;
+  void endStream() override;
+  BZFILE* _bzFile = nullptr;
+};
+
+// gzip, members are concatenated for block writes.
+class GzCodec : public OutputCodec {
+ public:
+  explicit GzCodec(int level);
+  ~GzCodec() override;
+  void compressBlock(const unsigned char* data, size_t len,
+                     std::vector<char>* out) const override;
+
+ protected:
+  void beginStream() override;
+  void writeStream(const unsigned char* data, size_t len) override;
+  void endStream() override;
+  void deflateStream(int flush);
+  z_stream _stream{};
+  std::vector<unsigned char> _out;
+};
+
+#if defined(OSM2RDF_HAVE_ZSTD)
+// Zstandard, a stream is a single frame compressed by `threads` workers.
+class ZstdCodec : public OutputCodec {
+ public:
+  ZstdCodec(int level, int threads);
+  ~ZstdCodec() override;
+  void compressBlock(const unsigned char* data, size_t len,
+                     std::vector<char>* out) const override;
+  [[nodiscard]] bool compressesInParallel() const override;
+
+ protected:
+  void beginStream() override;
+  void writeStream(const unsigned char* data, size_t len) override;
+  void endStream() override;
+  void compressStream(ZSTD_inBuffer* in, ZSTD_EndDirective mode);
+  const int _threads;
+  ZSTD_CCtx* _ctx = nullptr;
+  std::vector<char> _out;
+};
+#endif
+
+#if defined(OSM2RDF_HAVE_LZ4)
+// LZ4 frame format.
+class Lz4Codec : public OutputCodec {
+ public:
+  explicit Lz4Codec(int level);
+  ~Lz4Codec() override;
+  void compressBlock(const unsigned char* data, size_t len,
+                     std::vector<char>* out) const override;
+
+ protected:
+  void beginStream() override;
+  void writeStream(const unsigned char* data, size_t len) override;
+  void endStream() override;
+  LZ4F_preferences_t _prefs{};
+  LZ4F_cctx* _ctx = nullptr;
+  std::vector<char> _out;
+};
+#endif
+
+}  // namespace osm2rdf::util
+
+#endif  // OSM2RDF_UTIL_OUTPUTCODEC_H_
@@ -0,0 +1,51 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_UTIL_SIMD_H_
+#define OSM2RDF_UTIL_SIMD_H_
+
+#include <cstddef>
+#include <string_view>
+
+namespace osm2rdf::util::simd {
+
+// Instruction sets used to scan strings, ordered by width.
+enum class Level { SCALAR = 0, SSE2 = 1, AVX2 = 2 };
+
+// Returns the widest level supported by the running cpu.
+Level detectLevel();
+// Returns the level used by the find functions, detectLevel() by default.
+Level level();
+// Selects the level used by the find functions, limited to detectLevel().
+void setLevel(Level level);
+
+// The find functions return the position of the first char of s which can
+// not be copied verbatim into the respective grammar rule, s.size() if all
+// chars can.
+
+// STRING_LITERAL_QUOTE: '"', '\\', '\n' and '\r'
+size_t findLiteralEscape(std::string_view s);
+// IRIREF: #x00-#x20, '<', '>', '"', '{', '}', '|', '^', '`', '\\' and
+// non-ASCII, the caller handles UTF-8 sequences
+size_t findIRIREFEscape(std::string_view s);
+// PN_LOCAL: everything except [A-Za-z0-9_:], including non-ASCII
+size_t findPN_LOCALSpecial(std::string_view s);
+
+}  // namespace osm2rdf::util::simd
+
+#endif  // OSM2RDF_UTIL_SIMD_H_
@@ -0,0 +1,107 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef OSM2RDF_UTIL_STDOUTSINK_H_
+#define OSM2RDF_UTIL_STDOUTSINK_H_
+
+#include <sys/uio.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "osm2rdf/config/Config.h"
+#include "osm2rdf/util/LockFreeQueue.h"
+#include "osm2rdf/util/OutputCodec.h"
+
+namespace osm2rdf::util {
+
+// Streams chunks of complete lines from all output parts to stdout. A single
+// writer thread takes the chunks from a lock-free queue, optionally
+// compresses each into an independent stream and writes batches with writev
+// to a file descriptor, or through a stream.
+class StdoutSink {
+ public:
+  // Creates a sink with at most maxChunks chunks of chunkSize bytes writing
+  // to fd.
+  StdoutSink(const osm2rdf::config::Config& config, size_t chunkSize,
+             size_t maxChunks, int fd);
+  // Creates a sink with at most maxChunks chunks of chunkSize bytes writing
+  // through stream.
+  StdoutSink(const osm2rdf::config::Config& config, size_t chunkSize,
+             size_t maxChunks, std::ostream* stream);
+  ~StdoutSink();
+  // Starts the writer thread.
+  void open();
+  // Returns an empty chunk, waits if all chunks are in use.
+  unsigned char* acquire();
+  // Queues the first len bytes of chunk for output. The chunk belongs to the
+  // sink afterwards.
+  void submit(unsigned char* chunk, size_t len);
+  // Writes all queued chunks and stops the writer thread.
+  void close();
+
+ protected:
+  struct Chunk {
+    unsigned char* data;
+    size_t len;
+  };
+  // Writer thread loop.
+  void run();
+  // Writes the given chunks in order.
+  void writeChunks(const std::vector<Chunk>& chunks);
+  // Writes all iovecs to _fd, handling partial writes.
+  void writeFd(std::vector<struct iovec>* iov);
+  // Records the first error, later chunks are dropped.
+  void fail(const std::string& error);
+  // Frees all chunks returned to the pool.
+  void releaseChunks();
+  // Wakes the threads waiting for chunks in the given queue.
+  void notify(std::condition_variable* cv);
+
+  const size_t _chunkSize;
+  const size_t _maxChunks;
+  // Codec compressing the chunks, nullptr for plain output.
+  std::unique_ptr<OutputCodec> _codec;
+  // File descriptor written with writev, -1 if writing through _stream.
+  int _fd = -1;
+  std::ostream* _stream = nullptr;
+  LockFreeQueue<Chunk> _full;
+  LockFreeQueue<unsigned char*> _free;
+  std::atomic<size_t> _allocated{0};
+  std::atomic<bool> _closing{false};
+  std::atomic<bool> _failed{false};
+  std::string _error;
+  std::thread _writer;
+  // Guards the waits on the queues, the queues themselves are lock-free.
+  std::mutex _mutex;
+  // Signalled when a chunk is submitted or the sink is closed.
+  std::condition_variable _fullCv;
+  // Signalled when chunks are returned to the pool.
+  std::condition_variable _freeCv;
+  std::vector<std::vector<char>> _compressed;
+};
+
+}  // namespace osm2rdf::util
+
+#endif  // OSM2RDF_UTIL_STDOUTSINK_H_
@@ -19,7 +19,10 @@
 
 #include <filesystem>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <utility>
 
 #include "osm2rdf/config/Config.h"
 
@@ -154,11 +157,54 @@ std::string osm2rdf::config::Config::getInfo(std::string_view prefix) const {
       oss << "\n"
           << prefix << osm2rdf::config::constants::NO_WAY_GEOM_RELATIONS_INFO;
     }
+    if (!addIntersectsRelations || !addContainsRelations ||
+        !addCoversRelations || !addTouchesRelations || !addEqualsRelations ||
+        !addOverlapsRelations || !addCrossesRelations) {
+      oss << "\n"
+          << prefix << osm2rdf::config::constants::GEOMETRIC_PREDICATES_INFO;
+      const std::pair<bool, std::string_view> predicates[] = {
+          {addIntersectsRelations, "intersects"},
+          {addContainsRelations, "contains"},
+          {addCoversRelations, "covers"},
+          {addTouchesRelations, "touches"},
+          {addEqualsRelations, "equals"},
+          {addOverlapsRelations, "overlaps"},
+          {addCrossesRelations, "crosses"}};
+      for (const auto& [add, name] : predicates) {
+        if (add) {
+          oss << " " << name;
+        }
+      }
+    }
     if (simplifyGeometries > 0) {
       oss << "\n"
           << prefix << osm2rdf::config::constants::SIMPLIFY_GEOMETRIES_INFO
           << std::to_string(simplifyGeometries);
     }
+    if (!geometryState.empty()) {
+      oss << "\n"
+          << prefix << osm2rdf::config::constants::GEOMETRY_STATE_INFO << " "
+          << geometryState;
+    }
+    if (sortGeometries) {
+      oss << "\n" << prefix << osm2rdf::config::constants::SORT_GEOMETRIES_INFO;
+    }
+    if (geometryTiles > 0) {
+      oss << "\n"
+          << prefix << osm2rdf::config::constants::GEOMETRY_TILES_INFO << " "
+          << geometryTiles;
+      oss << "\n"
+          << prefix << osm2rdf::config::constants::GEOMETRY_TILE_WORKERS_INFO
+          << " " << geometryTileWorkers;
+      if (!geometryTileWorker.empty()) {
+        oss << "\n"
+            << prefix << osm2rdf::config::constants::GEOMETRY_TILE_WORKER_INFO
+            << " " << geometryTileWorker.string();
+      }
+      oss << "\n"
+          << prefix << osm2rdf::config::constants::GEOMETRY_TILE_TIMEOUT_INFO
+          << " " << geometryTileTimeout;
+    }
   }
   oss << "\n" << prefix << osm2rdf::config::constants::SECTION_MISCELLANEOUS;
   oss << "\n" << prefix << "Num Threads: " << numThreads;
@@ -168,6 +214,29 @@ std::string osm2rdf::config::Config::getInfo(std::string_view prefix) const {
         << prefix << osm2rdf::config::constants::STORE_LOCATIONS_INFO << " "
         << storeLocations;
   }
+  if (storeLocationsHugePages != NO_HUGE_PAGES) {
+    oss << "\n"
+        << prefix << osm2rdf::config::constants::STORE_LOCATIONS_HUGE_PAGES_INFO
+        << " "
+        << (storeLocationsHugePages == TRANSPARENT_HUGE_PAGES ? "thp"
+            : storeLocationsHugePages == HUGE_PAGES_2M        ? "2m"
+                                                              : "1g");
+  }
+  if (storeLocationsReferencedOnly) {
+    oss << "\n"
+        << prefix
+        << osm2rdf::config::constants::STORE_LOCATIONS_REFERENCED_ONLY_INFO;
+  }
+  if (storeLocationsNuma != NUMA_LOCAL) {
+    oss << "\n"
+        << prefix << osm2rdf::config::constants::STORE_LOCATIONS_NUMA_INFO
+        << " "
+        << (storeLocationsNuma == NUMA_INTERLEAVE ? "interleave"
+                                                 : "replicate");
+  }
+  if (nodesFirstPass) {
+    oss << "\n" << prefix << osm2rdf::config::constants::NODES_FIRST_PASS_INFO;
+  }
 
   if (writeRDFStatistics) {
     oss << "\n"
@@ -177,6 +246,32 @@ std::string osm2rdf::config::Config::getInfo(std::string_view prefix) const {
     oss << "\n"
         << prefix << osm2rdf::config::constants::OUTPUT_KEEP_FILES_OPTION_INFO;
   }
+  if (outputShards > 0) {
+    oss << "\n"
+        << prefix << osm2rdf::config::constants::OUTPUT_SHARDS_INFO << " "
+        << outputShards;
+  }
+  if (outputGroupSubjects) {
+    oss << "\n"
+        << prefix
+        << osm2rdf::config::constants::OUTPUT_GROUP_SUBJECTS_OPTION_INFO;
+  }
+  if (outputCompressionThreads > 0) {
+    oss << "\n"
+        << prefix
+        << osm2rdf::config::constants::OUTPUT_COMPRESSION_THREADS_INFO << " "
+        << outputCompressionThreads;
+  }
+  if (outputCompressionLevel != 0) {
+    oss << "\n"
+        << prefix
+        << osm2rdf::config::constants::OUTPUT_COMPRESSION_LEVEL_INFO << " "
+        << outputCompressionLevel;
+  }
+  if (outputAsyncWrite) {
+    oss << "\n"
+        << prefix << osm2rdf::config::constants::OUTPUT_ASYNC_WRITE_INFO;
+  }
 #if defined(_OPENMP)
   oss << "\n" << prefix << osm2rdf::config::constants::SECTION_OPENMP;
   oss << "\n" << prefix << "Max Threads: " << omp_get_max_threads();
@@ -198,6 +293,26 @@ void osm2rdf::config::Config::fromArgs(int argc, char** argv) {
           osm2rdf::config::constants::STORE_LOCATIONS_SHORT,
           osm2rdf::config::constants::STORE_LOCATIONS_LONG,
           osm2rdf::config::constants::STORE_LOCATIONS_HELP, "mem-flex");
+  auto storeLocationsHugePagesOp =
+      parser.add<popl::Value<std::string>, popl::Attribute::advanced>(
+          osm2rdf::config::constants::STORE_LOCATIONS_HUGE_PAGES_SHORT,
+          osm2rdf::config::constants::STORE_LOCATIONS_HUGE_PAGES_LONG,
+          osm2rdf::config::constants::STORE_LOCATIONS_HUGE_PAGES_HELP, "none");
+  auto storeLocationsNumaOp =
+      parser.add<popl::Value<std::string>, popl::Attribute::advanced>(
+          osm2rdf::config::constants::STORE_LOCATIONS_NUMA_SHORT,
+          osm2rdf::config::constants::STORE_LOCATIONS_NUMA_LONG,
+          osm2rdf::config::constants::STORE_LOCATIONS_NUMA_HELP, "local");
+
+  auto storeLocationsReferencedOnlyOp =
+      parser.add<popl::Switch, popl::Attribute::advanced>(
+          osm2rdf::config::constants::STORE_LOCATIONS_REFERENCED_ONLY_SHORT,
+          osm2rdf::config::constants::STORE_LOCATIONS_REFERENCED_ONLY_LONG,
+          osm2rdf::config::constants::STORE_LOCATIONS_REFERENCED_ONLY_HELP);
+  auto nodesFirstPassOp = parser.add<popl::Switch, popl::Attribute::advanced>(
+      osm2rdf::config::constants::NODES_FIRST_PASS_SHORT,
+      osm2rdf::config::constants::NODES_FIRST_PASS_LONG,
+      osm2rdf::config::constants::NODES_FIRST_PASS_HELP);
 
   auto noAreasOp = parser.add<popl::Switch, popl::Attribute::advanced>(
       osm2rdf::config::constants::NO_AREA_OPTION_SHORT,
@@ -268,6 +383,12 @@ void osm2rdf::config::Config::fromArgs(int argc, char** argv) {
           osm2rdf::config::constants::OGC_GEO_TRIPLES_OPTION_SHORT,
           osm2rdf::config::constants::OGC_GEO_TRIPLES_OPTION_LONG,
           osm2rdf::config::constants::OGC_GEO_TRIPLES_OPTION_HELP, "full");
+  auto geometricPredicatesOp =
+      parser.add<popl::Value<std::string>, popl::Attribute::advanced>(
+          osm2rdf::config::constants::GEOMETRIC_PREDICATES_OPTION_SHORT,
+          osm2rdf::config::constants::GEOMETRIC_PREDICATES_OPTION_LONG,
+          osm2rdf::config::constants::GEOMETRIC_PREDICATES_OPTION_HELP,
+          osm2rdf::config::constants::GEOMETRIC_PREDICATES_ALL);
 
   auto noAddCentroidsOp = parser.add<popl::Switch, popl::Attribute::advanced>(
       osm2rdf::config::constants::NO_ADD_CENTROIDS_OPTION_SHORT,
@@ -349,6 +470,39 @@ void osm2rdf::config::Config::fromArgs(int argc, char** argv) {
           osm2rdf::config::constants::SIMPLIFY_GEOMETRIES_OPTION_HELP,
           simplifyGeometries);
 
+  auto geometryStateOp =
+      parser.add<popl::Value<std::string>, popl::Attribute::advanced>(
+          osm2rdf::config::constants::GEOMETRY_STATE_OPTION_SHORT,
+          osm2rdf::config::constants::GEOMETRY_STATE_OPTION_LONG,
+          osm2rdf::config::constants::GEOMETRY_STATE_OPTION_HELP);
+  auto sortGeometriesOp = parser.add<popl::Switch, popl::Attribute::advanced>(
+      osm2rdf::config::constants::SORT_GEOMETRIES_OPTION_SHORT,
+      osm2rdf::config::constants::SORT_GEOMETRIES_OPTION_LONG,
+      osm2rdf::config::constants::SORT_GEOMETRIES_OPTION_HELP);
+  auto geometryTilesOp =
+      parser.add<popl::Value<int>, popl::Attribute::advanced>(
+          osm2rdf::config::constants::GEOMETRY_TILES_OPTION_SHORT,
+          osm2rdf::config::constants::GEOMETRY_TILES_OPTION_LONG,
+          osm2rdf::config::constants::GEOMETRY_TILES_OPTION_HELP,
+          geometryTiles);
+  auto geometryTileWorkersOp =
+      parser.add<popl::Value<int>, popl::Attribute::advanced>(
+          osm2rdf::config::constants::GEOMETRY_TILE_WORKERS_OPTION_SHORT,
+          osm2rdf::config::constants::GEOMETRY_TILE_WORKERS_OPTION_LONG,
+          osm2rdf::config::constants::GEOMETRY_TILE_WORKERS_OPTION_HELP,
+          geometryTileWorkers);
+  auto geometryTileWorkerOp =
+      parser.add<popl::Value<std::string>, popl::Attribute::expert>(
+          osm2rdf::config::constants::GEOMETRY_TILE_WORKER_OPTION_SHORT,
+          osm2rdf::config::constants::GEOMETRY_TILE_WORKER_OPTION_LONG,
+          osm2rdf::config::constants::GEOMETRY_TILE_WORKER_OPTION_HELP);
+  auto geometryTileTimeoutOp =
+      parser.add<popl::Value<int>, popl::Attribute::expert>(
+          osm2rdf::config::constants::GEOMETRY_TILE_TIMEOUT_OPTION_SHORT,
+          osm2rdf::config::constants::GEOMETRY_TILE_TIMEOUT_OPTION_LONG,
+          osm2rdf::config::constants::GEOMETRY_TILE_TIMEOUT_OPTION_HELP,
+          geometryTileTimeout);
+
   auto simplifyWKTOp =
       parser.add<popl::Value<uint16_t>, popl::Attribute::advanced>(
           osm2rdf::config::constants::SIMPLIFY_WKT_OPTION_SHORT,
@@ -385,11 +539,38 @@ void osm2rdf::config::Config::fromArgs(int argc, char** argv) {
       osm2rdf::config::constants::OUTPUT_KEEP_FILES_OPTION_SHORT,
       osm2rdf::config::constants::OUTPUT_KEEP_FILES_OPTION_LONG,
       osm2rdf::config::constants::OUTPUT_KEEP_FILES_OPTION_HELP);
+  auto outputShardsOp =
+      parser.add<popl::Value<int>, popl::Attribute::advanced>(
+          osm2rdf::config::constants::OUTPUT_SHARDS_OPTION_SHORT,
+          osm2rdf::config::constants::OUTPUT_SHARDS_OPTION_LONG,
+          osm2rdf::config::constants::OUTPUT_SHARDS_OPTION_HELP, outputShards);
+  auto outputGroupSubjectsOp =
+      parser.add<popl::Switch, popl::Attribute::advanced>(
+          osm2rdf::config::constants::OUTPUT_GROUP_SUBJECTS_OPTION_SHORT,
+          osm2rdf::config::constants::OUTPUT_GROUP_SUBJECTS_OPTION_LONG,
+          osm2rdf::config::constants::OUTPUT_GROUP_SUBJECTS_OPTION_HELP);
   auto outputCompressOp =
       parser.add<popl::Value<std::string>, popl::Attribute::advanced>(
           osm2rdf::config::constants::OUTPUT_COMPRESS_OPTION_SHORT,
           osm2rdf::config::constants::OUTPUT_COMPRESS_OPTION_LONG,
           osm2rdf::config::constants::OUTPUT_COMPRESS_OPTION_HELP, "bz2");
+  auto outputCompressionThreadsOp =
+      parser.add<popl::Value<int>, popl::Attribute::expert>(
+          osm2rdf::config::constants::OUTPUT_COMPRESSION_THREADS_OPTION_SHORT,
+          osm2rdf::config::constants::OUTPUT_COMPRESSION_THREADS_OPTION_LONG,
+          osm2rdf::config::constants::OUTPUT_COMPRESSION_THREADS_OPTION_HELP,
+          outputCompressionThreads);
+  auto outputCompressionLevelOp =
+      parser.add<popl::Value<int>, popl::Attribute::expert>(
+          osm2rdf::config::constants::OUTPUT_COMPRESSION_LEVEL_OPTION_SHORT,
+          osm2rdf::config::constants::OUTPUT_COMPRESSION_LEVEL_OPTION_LONG,
+          osm2rdf::config::constants::OUTPUT_COMPRESSION_LEVEL_OPTION_HELP,
+          outputCompressionLevel);
+  auto outputAsyncWriteOp =
+      parser.add<popl::Switch, popl::Attribute::expert>(
+          osm2rdf::config::constants::OUTPUT_ASYNC_WRITE_OPTION_SHORT,
+          osm2rdf::config::constants::OUTPUT_ASYNC_WRITE_OPTION_LONG,
+          osm2rdf::config::constants::OUTPUT_ASYNC_WRITE_OPTION_HELP);
   auto cacheOp = parser.add<popl::Value<std::string>>(
       osm2rdf::config::constants::CACHE_OPTION_SHORT,
       osm2rdf::config::constants::CACHE_OPTION_LONG,
@@ -424,6 +605,47 @@ void osm2rdf::config::Config::fromArgs(int argc, char** argv) {
     if (storeLocationsOp->is_set()) {
       storeLocations = storeLocationsOp->value();
     }
+    storeLocationsReferencedOnly = storeLocationsReferencedOnlyOp->is_set();
+    if (storeLocationsHugePagesOp->value() == "none") {
+      storeLocationsHugePages = NO_HUGE_PAGES;
+    } else if (storeLocationsHugePagesOp->value() == "thp") {
+      storeLocationsHugePages = TRANSPARENT_HUGE_PAGES;
+    } else if (storeLocationsHugePagesOp->value() == "2m") {
+      storeLocationsHugePages = HUGE_PAGES_2M;
+    } else if (storeLocationsHugePagesOp->value() == "1g") {
+      storeLocationsHugePages = HUGE_PAGES_1G;
+    } else {
+      throw popl::invalid_option(
+          storeLocationsHugePagesOp.get(),
+          popl::invalid_option::Error::invalid_argument,
+          popl::OptionName::long_name, storeLocationsHugePagesOp->value(), "");
+    }
+    // Nodes in the first pass come before the node ID range and the node
+    // refs of ways are known.
+    nodesFirstPass = nodesFirstPassOp->is_set();
+    if (nodesFirstPass &&
+        (storeLocations == "mem-dense" || storeLocations == "disk-persistent" ||
+         storeLocations == "disk-join" || storeLocationsReferencedOnly)) {
+      throw popl::invalid_option(
+          nodesFirstPassOp.get(), popl::invalid_option::Error::invalid_argument,
+          popl::OptionName::long_name,
+          storeLocationsReferencedOnly
+              ? osm2rdf::config::constants::STORE_LOCATIONS_REFERENCED_ONLY_LONG
+              : storeLocations,
+          "");
+    }
+    if (storeLocationsNumaOp->value() == "local") {
+      storeLocationsNuma = NUMA_LOCAL;
+    } else if (storeLocationsNumaOp->value() == "interleave") {
+      storeLocationsNuma = NUMA_INTERLEAVE;
+    } else if (storeLocationsNumaOp->value() == "replicate") {
+      storeLocationsNuma = NUMA_REPLICATE;
+    } else {
+      throw popl::invalid_option(
+          storeLocationsNumaOp.get(),
+          popl::invalid_option::Error::invalid_argument,
+          popl::OptionName::long_name, storeLocationsNumaOp->value(), "");
+    }
 
     // Select types to dump
     noAreaFacts = noAreaFactsOp->is_set();
@@ -451,6 +673,40 @@ void osm2rdf::config::Config::fromArgs(int argc, char** argv) {
 
     noGeometricRelations = ogcGeoTriplesMode == none;
 
+    if (geometricPredicatesOp->is_set()) {
+      addIntersectsRelations = false;
+      addContainsRelations = false;
+      addCoversRelations = false;
+      addTouchesRelations = false;
+      addEqualsRelations = false;
+      addOverlapsRelations = false;
+      addCrossesRelations = false;
+      std::istringstream predicates{geometricPredicatesOp->value()};
+      std::string predicate;
+      while (std::getline(predicates, predicate, ',')) {
+        if (predicate == "intersects") {
+          addIntersectsRelations = true;
+        } else if (predicate == "contains") {
+          addContainsRelations = true;
+        } else if (predicate == "covers") {
+          addCoversRelations = true;
+        } else if (predicate == "touches") {
+          addTouchesRelations = true;
+        } else if (predicate == "equals") {
+          addEqualsRelations = true;
+        } else if (predicate == "overlaps") {
+          addOverlapsRelations = true;
+        } else if (predicate == "crosses") {
+          addCrossesRelations = true;
+        } else {
+          throw popl::invalid_option(
+              geometricPredicatesOp.get(),
+              popl::invalid_option::Error::invalid_argument,
+              popl::OptionName::long_name, geometricPredicatesOp->value(), "");
+        }
+      }
+    }
+
     noAreaFacts |= noAreasOp->is_set();
     noAreaGeometricRelations |= noAreasOp->is_set();
     noNodeFacts |= noNodesOp->is_set();
@@ -505,6 +761,54 @@ void osm2rdf::config::Config::fromArgs(int argc, char** argv) {
       }
     }
 
+    if (geometryStateOp->is_set()) {
+      // Auxiliary geometries have no OSM ID to track them by.
+      if (!auxGeoFiles.empty()) {
+        throw popl::invalid_option(
+            geometryStateOp.get(),
+            popl::invalid_option::Error::invalid_argument,
+            popl::OptionName::long_name, geometryStateOp->value(), "");
+      }
+      geometryState = std::filesystem::absolute(geometryStateOp->value());
+    }
+    sortGeometries = sortGeometriesOp->is_set();
+    if (geometryTilesOp->is_set()) {
+      // Tiles have no shared state and are keyed by OSM IDs.
+      if (geometryTilesOp->value() < 1 || geometryTilesOp->value() > 256 ||
+          !geometryState.empty() || !auxGeoFiles.empty()) {
+        throw popl::invalid_option(
+            geometryTilesOp.get(),
+            popl::invalid_option::Error::invalid_argument,
+            popl::OptionName::long_name,
+            std::to_string(geometryTilesOp->value()), "");
+      }
+      geometryTiles = geometryTilesOp->value();
+    }
+    if (geometryTileWorkersOp->is_set()) {
+      if (geometryTileWorkersOp->value() < 0) {
+        throw popl::invalid_option(
+            geometryTileWorkersOp.get(),
+            popl::invalid_option::Error::invalid_argument,
+            popl::OptionName::long_name,
+            std::to_string(geometryTileWorkersOp->value()), "");
+      }
+      geometryTileWorkers = geometryTileWorkersOp->value();
+    }
+    if (geometryTileWorkerOp->is_set()) {
+      geometryTileWorker =
+          std::filesystem::absolute(geometryTileWorkerOp->value());
+    }
+    if (geometryTileTimeoutOp->is_set()) {
+      if (geometryTileTimeoutOp->value() < 10) {
+        throw popl::invalid_option(
+            geometryTileTimeoutOp.get(),
+            popl::invalid_option::Error::invalid_argument,
+            popl::OptionName::long_name,
+            std::to_string(geometryTileTimeoutOp->value()), "");
+      }
+      geometryTileTimeout = geometryTileTimeoutOp->value();
+    }
+
     if (numThreadsOp->is_set()) numThreads = numThreadsOp->value();
 
     writeRDFStatistics = writeRDFStatisticsOp->is_set();
@@ -518,6 +822,14 @@ void osm2rdf::config::Config::fromArgs(int argc, char** argv) {
       outputCompress = GZ;
     } else if (outputCompressOp->value() == "bz2") {
       outputCompress = BZ2;
+#if defined(OSM2RDF_HAVE_ZSTD)
+    } else if (outputCompressOp->value() == "zstd") {
+      outputCompress = ZSTD;
+#endif
+#if defined(OSM2RDF_HAVE_LZ4)
+    } else if (outputCompressOp->value() == "lz4") {
+      outputCompress = LZ4;
+#endif
     } else {
         throw popl::invalid_option(
             outputCompressOp.get(),
@@ -526,9 +838,52 @@ void osm2rdf::config::Config::fromArgs(int argc, char** argv) {
     }
 
     outputKeepFiles = outputKeepFilesOp->is_set();
+    outputGroupSubjects = outputGroupSubjectsOp->is_set();
+    outputShards = std::max(outputShardsOp->value(), 0);
+    if (outputCompressionThreadsOp->is_set()) {
+      outputCompressionThreads =
+          std::max(outputCompressionThreadsOp->value(), 0);
+    }
+    outputCompressionLevel = outputCompressionLevelOp->value();
+    outputAsyncWrite = outputAsyncWriteOp->is_set();
     if (output.empty()) {
-      outputCompress = NONE;
+      // Compress stdout only on request, each chunk is compressed
+      // independently by the stdout writer.
+      if (!outputCompressOp->is_set()) {
+        outputCompress = NONE;
+      }
       mergeOutput = util::OutputMergeMode::NONE;
+      // A single stream can not be sharded.
+      outputShards = 0;
+    }
+
+    // Valid levels of each codec, 0 always selects the codec default.
+    int minCompressionLevel = 0;
+    int maxCompressionLevel = 0;
+    switch (outputCompress) {
+      case BZ2:
+      case GZ:
+        minCompressionLevel = 1;
+        maxCompressionLevel = 9;
+        break;
+      case ZSTD:
+        minCompressionLevel = 1;
+        maxCompressionLevel = 22;
+        break;
+      case LZ4:
+        maxCompressionLevel = 12;
+        break;
+      case NONE:
+        break;
+    }
+    if (outputCompress != NONE && outputCompressionLevel != 0 &&
+        (outputCompressionLevel < minCompressionLevel ||
+         outputCompressionLevel > maxCompressionLevel)) {
+      throw popl::invalid_option(
+          outputCompressionLevelOp.get(),
+          popl::invalid_option::Error::invalid_argument,
+          popl::OptionName::long_name,
+          std::to_string(outputCompressionLevel), "");
     }
 
     // Paths for statistic files
@@ -547,6 +902,16 @@ void osm2rdf::config::Config::fromArgs(int argc, char** argv) {
       output += osm2rdf::config::constants::GZ_EXTENSION;
     }
 
+    if (outputCompress == ZSTD && !output.empty() &&
+        output.extension() != osm2rdf::config::constants::ZSTD_EXTENSION) {
+      output += osm2rdf::config::constants::ZSTD_EXTENSION;
+    }
+
+    if (outputCompress == LZ4 && !output.empty() &&
+        output.extension() != osm2rdf::config::constants::LZ4_EXTENSION) {
+      output += osm2rdf::config::constants::LZ4_EXTENSION;
+    }
+
     // osmium location cache
     cache = std::filesystem::absolute(cacheOp->value()).string();
 
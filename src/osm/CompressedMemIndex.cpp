@@ -0,0 +1,419 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/CompressedMemIndex.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "osmium/osm/location.hpp"
+
+static const int VARINT_BITS = 7;
+static const uint8_t VARINT_MASK = 0x7F;
+static const uint8_t VARINT_MORE = 0x80;
+// Difference streams of a block: IDs, x and y.
+static const size_t NUM_STREAMS = 3;
+// Size of the block header: absolute coordinates, widths and exception
+// counts.
+static const size_t HEADER_S = 8 + 2 * NUM_STREAMS;
+
+// ____________________________________________________________________________
+static uint64_t zigzag(int64_t v) {
+  return (static_cast<uint64_t>(v) << 1U) ^ static_cast<uint64_t>(v >> 63);
+}
+
+// ____________________________________________________________________________
+static int64_t unzigzag(uint64_t v) {
+  return static_cast<int64_t>(v >> 1U) ^ -static_cast<int64_t>(v & 1U);
+}
+
+// ____________________________________________________________________________
+static uint8_t* writeVarint(uint64_t v, uint8_t* out) {
+  while (v > VARINT_MASK) {
+    *out++ = static_cast<uint8_t>((v & VARINT_MASK) | VARINT_MORE);
+    v >>= VARINT_BITS;
+  }
+  *out++ = static_cast<uint8_t>(v);
+  return out;
+}
+
+// ____________________________________________________________________________
+static uint64_t readVarint(const uint8_t** pos) {
+  uint64_t v = 0;
+  for (int shift = 0;; shift += VARINT_BITS) {
+    const uint8_t b = *(*pos)++;
+    v |= static_cast<uint64_t>(b & VARINT_MASK) << shift;
+    if ((b & VARINT_MORE) == 0) {
+      return v;
+    }
+  }
+}
+
+// ____________________________________________________________________________
+static int bitLength(uint64_t v) {
+  return v == 0 ? 0 : 64 - __builtin_clzll(v);
+}
+
+// ____________________________________________________________________________
+static uint64_t lowBits(uint64_t v, int width) {
+  return width >= 64 ? v : v & ((uint64_t{1} << width) - 1);
+}
+
+// ____________________________________________________________________________
+// Returns the width in bits which minimizes the packed values plus the
+// exceptions, each an index byte and a varint of the bits above the width.
+static int packWidth(const uint64_t* values, size_t n) {
+  size_t lengths[65] = {};
+  int maxLength = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const int length = bitLength(values[i]);
+    lengths[length]++;
+    maxLength = std::max(maxLength, length);
+  }
+  int best = maxLength;
+  size_t bestCost = n * maxLength;
+  for (int width = 0; width < maxLength; ++width) {
+    size_t cost = n * width;
+    for (int length = width + 1; length <= maxLength; ++length) {
+      const int varintBytes = (length - width + VARINT_BITS - 1) / VARINT_BITS;
+      cost += lengths[length] * 8 * (1 + varintBytes);
+    }
+    if (cost < bestCost) {
+      best = width;
+      bestCost = cost;
+    }
+  }
+  return best;
+}
+
+// ____________________________________________________________________________
+// Appends values of up to 64 bits to a byte buffer, least significant bit
+// first.
+struct BitWriter {
+  uint8_t* out;
+  uint64_t bits = 0;
+  int numBits = 0;
+
+  void put(uint64_t v, int width) {
+    if (width > 32) {
+      put(v & 0xFFFFFFFFU, 32);
+      put(v >> 32U, width - 32);
+      return;
+    }
+    bits |= lowBits(v, width) << numBits;
+    numBits += width;
+    while (numBits >= 8) {
+      *out++ = static_cast<uint8_t>(bits);
+      bits >>= 8U;
+      numBits -= 8;
+    }
+  }
+
+  uint8_t* finish() {
+    if (numBits > 0) {
+      *out++ = static_cast<uint8_t>(bits);
+    }
+    return out;
+  }
+};
+
+// ____________________________________________________________________________
+// Reads values written by BitWriter, reads up to 8 bytes past the current
+// byte.
+struct BitReader {
+  const uint8_t* data;
+  size_t pos = 0;
+
+  uint64_t get(int width) {
+    if (width > 32) {
+      const uint64_t low = get(32);
+      return low | (get(width - 32) << 32U);
+    }
+    uint64_t word;
+    std::memcpy(&word, data + (pos >> 3U), sizeof(word));
+    const uint64_t v = lowBits(word >> (pos & 7U), width);
+    pos += width;
+    return v;
+  }
+};
+
+// ____________________________________________________________________________
+// Reads one difference stream, adding the high bits of the exceptions.
+struct StreamReader {
+  BitReader bits;
+  int width;
+  const uint8_t* exceptions;
+  size_t numExceptions;
+
+  uint64_t next(size_t i) {
+    uint64_t v = bits.get(width);
+    if (numExceptions > 0 && *exceptions == i) {
+      exceptions++;
+      v |= readVarint(&exceptions) << width;
+      numExceptions--;
+    }
+    return v;
+  }
+};
+
+// ____________________________________________________________________________
+template <typename TId, typename TValue>
+size_t osm2rdf::osm::CompressedMemIndex<TId, TValue>::used_memory()
+    const noexcept {
+  return sizeof(CompressedMemIndex) + _chunks.size() * CHUNK_S +
+         _firstIds.capacity() * sizeof(TId) +
+         _positions.capacity() * sizeof(uint64_t) +
+         _pages.capacity() * sizeof(uint64_t) +
+         _blockIds.capacity() * sizeof(TId) +
+         _blockValues.capacity() * sizeof(TValue) +
+         _unsorted.capacity() * sizeof(std::pair<TId, TValue>);
+}
+
+// ____________________________________________________________________________
+template <typename TId, typename TValue>
+void osm2rdf::osm::CompressedMemIndex<TId, TValue>::writeBlock() {
+  if (_chunkPos + MAX_BLOCK_S > CHUNK_S) {
+    _chunks.emplace_back(new uint8_t[CHUNK_S]);
+    _chunkPos = 0;
+  }
+  const uint64_t block = _firstIds.size();
+  const TId firstId = _blockIds[0];
+  _firstIds.push_back(firstId);
+  _positions.push_back(((_chunks.size() - 1) << CHUNK_BITS) | _chunkPos);
+  while (_pages.size() <= (firstId >> PAGE_BITS)) {
+    _pages.push_back(block);
+  }
+
+  const size_t n = _blockIds.size() - 1;
+  uint64_t deltas[NUM_STREAMS][BLOCK_SIZE - 1];
+  for (size_t i = 0; i < n; ++i) {
+    deltas[0][i] = _blockIds[i + 1] - _blockIds[i] - 1;
+    deltas[1][i] = zigzag(int64_t{_blockValues[i + 1].x()} -
+                          _blockValues[i].x());
+    deltas[2][i] = zigzag(int64_t{_blockValues[i + 1].y()} -
+                          _blockValues[i].y());
+  }
+
+  uint8_t* const start = _chunks.back().get() + _chunkPos;
+  const int32_t xy[2] = {_blockValues[0].x(), _blockValues[0].y()};
+  std::memcpy(start, xy, sizeof(xy));
+  int widths[NUM_STREAMS];
+  for (size_t s = 0; s < NUM_STREAMS; ++s) {
+    widths[s] = packWidth(deltas[s], n);
+    size_t numExceptions = 0;
+    for (size_t i = 0; i < n; ++i) {
+      numExceptions += bitLength(deltas[s][i]) > widths[s] ? 1 : 0;
+    }
+    start[sizeof(xy) + s] = static_cast<uint8_t>(widths[s]);
+    start[sizeof(xy) + NUM_STREAMS + s] = static_cast<uint8_t>(numExceptions);
+  }
+  BitWriter writer{start + HEADER_S};
+  for (size_t s = 0; s < NUM_STREAMS; ++s) {
+    for (size_t i = 0; i < n; ++i) {
+      writer.put(deltas[s][i], widths[s]);
+    }
+  }
+  uint8_t* out = writer.finish();
+  for (size_t s = 0; s < NUM_STREAMS; ++s) {
+    for (size_t i = 0; i < n; ++i) {
+      if (bitLength(deltas[s][i]) > widths[s]) {
+        *out++ = static_cast<uint8_t>(i);
+        out = writeVarint(deltas[s][i] >> widths[s], out);
+      }
+    }
+  }
+  _chunkPos += out - start;
+  _blockIds.clear();
+  _blockValues.clear();
+}
+
+// ____________________________________________________________________________
+template <typename TId, typename TValue>
+void osm2rdf::osm::CompressedMemIndex<TId, TValue>::set(const TId id,
+                                                        const TValue value) {
+  if (_size > 0 && id <= _lastId) {
+    _unsorted.emplace_back(id, value);
+    return;
+  }
+  if (_blockIds.empty()) {
+    _blockIds.reserve(BLOCK_SIZE);
+    _blockValues.reserve(BLOCK_SIZE);
+  }
+  _blockIds.push_back(id);
+  _blockValues.push_back(value);
+  if (_blockIds.size() == BLOCK_SIZE) {
+    writeBlock();
+  }
+  _lastId = id;
+  _size++;
+}
+
+// ____________________________________________________________________________
+template <typename TId, typename TValue>
+size_t osm2rdf::osm::CompressedMemIndex<TId, TValue>::findBlock(
+    const TId id) const noexcept {
+  const size_t numBlocks = _firstIds.size();
+  if (numBlocks == 0 || id < _firstIds[0]) {
+    return numBlocks;
+  }
+  // Blocks before _pages[page] start before the page, blocks from
+  // _pages[page + 1] on start after it.
+  const uint64_t page = id >> PAGE_BITS;
+  const size_t lo = page < _pages.size() ? _pages[page] : numBlocks;
+  const size_t hi = page + 1 < _pages.size() ? _pages[page + 1] : numBlocks;
+  auto it = std::upper_bound(_firstIds.begin() + lo, _firstIds.begin() + hi,
+                             id);
+  return (it - _firstIds.begin()) - 1;
+}
+
+// ____________________________________________________________________________
+template <typename TId, typename TValue>
+TValue osm2rdf::osm::CompressedMemIndex<TId, TValue>::getFromBlock(
+    size_t block, const TId id) const noexcept {
+  const uint64_t position = _positions[block];
+  const uint8_t* start =
+      _chunks[position >> CHUNK_BITS].get() + (position & (CHUNK_S - 1));
+  int32_t xy[2];
+  std::memcpy(xy, start, sizeof(xy));
+  const size_t n = BLOCK_SIZE - 1;
+
+  StreamReader streams[NUM_STREAMS];
+  size_t bitPos = 0;
+  for (size_t s = 0; s < NUM_STREAMS; ++s) {
+    streams[s].width = start[sizeof(xy) + s];
+    streams[s].numExceptions = start[sizeof(xy) + NUM_STREAMS + s];
+    streams[s].bits = BitReader{start + HEADER_S, bitPos};
+    bitPos += n * streams[s].width;
+  }
+  const uint8_t* exceptions = start + HEADER_S + (bitPos + 7) / 8;
+  for (size_t s = 0; s < NUM_STREAMS; ++s) {
+    streams[s].exceptions = exceptions;
+    for (size_t i = 0; i < streams[s].numExceptions; ++i) {
+      exceptions++;
+      readVarint(&exceptions);
+    }
+  }
+
+  // Number of differences up to the entry of id.
+  size_t count = 0;
+  const TId firstId = _firstIds[block];
+  if (streams[0].width == 0 && streams[0].numExceptions == 0) {
+    // Consecutive IDs.
+    count = id - firstId;
+    if (count > n) {
+      return osmium::index::empty_value<TValue>();
+    }
+  } else {
+    TId current = firstId;
+    while (current < id && count < n) {
+      current += 1 + streams[0].next(count);
+      count++;
+    }
+    if (current != id) {
+      return osmium::index::empty_value<TValue>();
+    }
+  }
+  int64_t x = xy[0];
+  int64_t y = xy[1];
+  for (size_t i = 0; i < count; ++i) {
+    x += unzigzag(streams[1].next(i));
+  }
+  for (size_t i = 0; i < count; ++i) {
+    y += unzigzag(streams[2].next(i));
+  }
+  return TValue{static_cast<int32_t>(x), static_cast<int32_t>(y)};
+}
+
+// ____________________________________________________________________________
+template <typename TId, typename TValue>
+TValue osm2rdf::osm::CompressedMemIndex<TId, TValue>::get_noexcept(
+    const TId id) const noexcept {
+  // Entries set again out of order replace the ones in the blocks.
+  if (!_unsorted.empty()) {
+    auto it = std::lower_bound(
+        _unsorted.begin(), _unsorted.end(), id,
+        [](const std::pair<TId, TValue>& e, TId i) { return e.first < i; });
+    if (it != _unsorted.end() && it->first == id) {
+      return it->second;
+    }
+  }
+  if (!_blockIds.empty() && id >= _blockIds[0]) {
+    auto it = std::lower_bound(_blockIds.begin(), _blockIds.end(), id);
+    if (it != _blockIds.end() && *it == id) {
+      return _blockValues[it - _blockIds.begin()];
+    }
+    return osmium::index::empty_value<TValue>();
+  }
+  const size_t block = findBlock(id);
+  if (block < _firstIds.size()) {
+    return getFromBlock(block, id);
+  }
+  return osmium::index::empty_value<TValue>();
+}
+
+// ____________________________________________________________________________
+template <typename TId, typename TValue>
+TValue osm2rdf::osm::CompressedMemIndex<TId, TValue>::get(const TId id) const {
+  const auto value = get_noexcept(id);
+  if (value == osmium::index::empty_value<TValue>()) {
+    throw osmium::not_found{id};
+  }
+  return value;
+}
+
+// ____________________________________________________________________________
+template <typename TId, typename TValue>
+void osm2rdf::osm::CompressedMemIndex<TId, TValue>::clear() {
+  _chunks.clear();
+  _chunks.shrink_to_fit();
+  _chunkPos = CHUNK_S;
+  _firstIds.clear();
+  _firstIds.shrink_to_fit();
+  _positions.clear();
+  _positions.shrink_to_fit();
+  _pages.clear();
+  _pages.shrink_to_fit();
+  _blockIds.clear();
+  _blockIds.shrink_to_fit();
+  _blockValues.clear();
+  _blockValues.shrink_to_fit();
+  _unsorted.clear();
+  _unsorted.shrink_to_fit();
+  _lastId = 0;
+  _size = 0;
+}
+
+// ____________________________________________________________________________
+template <typename TId, typename TValue>
+void osm2rdf::osm::CompressedMemIndex<TId, TValue>::sort() {
+  // Keep the value set last for each ID.
+  std::stable_sort(
+      _unsorted.begin(), _unsorted.end(),
+      [](const std::pair<TId, TValue>& a, const std::pair<TId, TValue>& b) {
+        return a.first < b.first;
+      });
+  auto last = std::unique(
+      _unsorted.rbegin(), _unsorted.rend(),
+      [](const std::pair<TId, TValue>& a, const std::pair<TId, TValue>& b) {
+        return a.first == b.first;
+      });
+  _unsorted.erase(_unsorted.begin(), last.base());
+}
+
+template class osm2rdf::osm::CompressedMemIndex<osmium::unsigned_object_id_type,
+                                                osmium::Location>;
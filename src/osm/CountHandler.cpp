@@ -16,6 +16,7 @@
 // You should have received a copy of the GNU General Public License
 // along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <algorithm>
 #include <iostream>
 
 #include "osm2rdf/osm/CountHandler.h"
@@ -23,6 +24,15 @@
 // ____________________________________________________________________________
 void osm2rdf::osm::CountHandler::prepare_for_lookup() { _firstPassDone = true; }
 
+// ____________________________________________________________________________
+void osm2rdf::osm::CountHandler::merge(const CountHandler& other) {
+  _numNodes += other._numNodes;
+  _numRelations += other._numRelations;
+  _numWays += other._numWays;
+  _minId = std::min(_minId, other._minId);
+  _maxId = std::max(_maxId, other._maxId);
+}
+
 // ____________________________________________________________________________
 void osm2rdf::osm::CountHandler::node(const osmium::Node& node) {
   if (node.positive_id() < _minId) _minId = node.positive_id();
@@ -17,14 +17,166 @@
 // along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "osm2rdf/osm/DenseMemIndex.h"
+
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <new>
+#include <string>
+
 #include "osmium/osm/node.hpp"
-#include <iostream>
+
+// Stored coordinates are xor this value, untouched entries are zero.
+static const int32_t EMPTY = osmium::Location::undefined_coordinate;
+static const size_t TRANSPARENT_HUGE_PAGE_S = size_t{1} << 21U;
+static const size_t MAX_NUMA_NODES = sizeof(unsigned long) * 8;
+// Lookups between checks of the NUMA node a thread runs on.
+static const unsigned NUMA_NODE_REFRESH = 4096;
+
+// ____________________________________________________________________________
+static size_t numaNodes() {
+  // Ranges like "0-1" or "0,2-3", only the highest node is needed.
+  std::ifstream in{"/sys/devices/system/node/online"};
+  std::string online;
+  if (!(in >> online) || online.empty()) {
+    return 1;
+  }
+  const auto pos = online.find_last_of(",-");
+  const size_t last =
+      std::stoul(pos == std::string::npos ? online : online.substr(pos + 1));
+  return std::min(last + 1, MAX_NUMA_NODES);
+}
+
+// ____________________________________________________________________________
+static bool bindMemory(void* addr, size_t bytes, int mode,
+                       unsigned long nodeMask) {
+  return syscall(SYS_mbind, addr, bytes, mode, &nodeMask, MAX_NUMA_NODES, 0) ==
+         0;
+}
+
+// ____________________________________________________________________________
+static int32_t* allocate(size_t* bytes, osm2rdf::config::HugePages hugePages,
+                         size_t* pageSize) {
+  if (hugePages == osm2rdf::config::HUGE_PAGES_2M ||
+      hugePages == osm2rdf::config::HUGE_PAGES_1G) {
+    // Reserved huge pages, fails if not enough pages are available.
+    const int shift = hugePages == osm2rdf::config::HUGE_PAGES_2M ? 21 : 30;
+    const size_t hugePageSize = size_t{1} << static_cast<size_t>(shift);
+    const size_t hugeBytes =
+        (*bytes + hugePageSize - 1) / hugePageSize * hugePageSize;
+    void* p = mmap(nullptr, hugeBytes, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB |
+                       (shift << MAP_HUGE_SHIFT),
+                   -1, 0);
+    if (p != MAP_FAILED) {
+      *bytes = hugeBytes;
+      *pageSize = hugePageSize;
+      return static_cast<int32_t*>(p);
+    }
+  }
+  void* p = mmap(nullptr, *bytes, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (p == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+  *pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  if (hugePages != osm2rdf::config::NO_HUGE_PAGES &&
+      madvise(p, *bytes, MADV_HUGEPAGE) == 0) {
+    *pageSize = TRANSPARENT_HUGE_PAGE_S;
+  }
+  return static_cast<int32_t*>(p);
+}
+
+// ____________________________________________________________________________
+template <typename TId, typename TValue>
+osm2rdf::osm::DenseMemIndex<TId, TValue>::DenseMemIndex(
+    size_t minNodeId, size_t maxNodeId, osm2rdf::config::HugePages hugePages,
+    osm2rdf::config::NumaPlacement numa)
+    : _offset(minNodeId),
+      _size(maxNodeId >= minNodeId ? maxNodeId - minNodeId + 1 : 0) {
+  const size_t nodes =
+      numa == osm2rdf::config::NUMA_LOCAL ? 1 : numaNodes();
+  const size_t copies = numa == osm2rdf::config::NUMA_REPLICATE ? nodes : 1;
+  size_t firstPageSize = 0;
+  for (size_t node = 0; node < copies; ++node) {
+    size_t bytes = std::max(_size * 2 * sizeof(int32_t), size_t{1});
+    size_t pageSize = 0;
+    int32_t* data = nullptr;
+    try {
+      data = allocate(&bytes, hugePages, &pageSize);
+    } catch (const std::bad_alloc&) {
+      unmap(0);
+      throw;
+    }
+    _replicas.push_back(data);
+    _bytes.push_back(bytes);
+    if (node == 0) {
+      firstPageSize = pageSize;
+    }
+    _pageSize = node == 0 ? pageSize : std::min(_pageSize, pageSize);
+    if (copies > 1 && !bindMemory(data, bytes, MPOL_BIND, 1UL << node)) {
+      // Copies on arbitrary nodes only cost memory. No page is touched yet,
+      // so the first copy can still be placed by the default policy.
+      unmap(1);
+      bindMemory(_replicas[0], _bytes[0], MPOL_DEFAULT, 0);
+      _pageSize = firstPageSize;
+      break;
+    }
+    if (copies == 1 && nodes > 1) {
+      _interleaved = bindMemory(data, bytes, MPOL_INTERLEAVE,
+                                nodes == MAX_NUMA_NODES ? ~0UL
+                                                        : (1UL << nodes) - 1);
+    }
+  }
+}
 
 // ____________________________________________________________________________
 template <typename TId, typename TValue>
-osm2rdf::osm::DenseMemIndex<TId, TValue>::DenseMemIndex(size_t minNodeId,
-                                                        size_t maxNodeId)
-    : _offset(minNodeId), _index(maxNodeId - minNodeId + 1) {
+size_t osm2rdf::osm::DenseMemIndex<TId, TValue>::used_memory() const noexcept {
+  size_t bytes = sizeof(DenseMemIndex);
+  for (const size_t b : _bytes) {
+    bytes += b;
+  }
+  return bytes;
+}
+
+// ____________________________________________________________________________
+template <typename TId, typename TValue>
+void osm2rdf::osm::DenseMemIndex<TId, TValue>::unmap(size_t first) noexcept {
+  for (size_t i = first; i < _replicas.size(); ++i) {
+    munmap(_replicas[i], _bytes[i]);
+  }
+  _replicas.resize(std::min(first, _replicas.size()));
+  _bytes.resize(_replicas.size());
+}
+
+// ____________________________________________________________________________
+template <typename TId, typename TValue>
+osm2rdf::osm::DenseMemIndex<TId, TValue>::~DenseMemIndex() {
+  clear();
+}
+
+// ____________________________________________________________________________
+template <typename TId, typename TValue>
+const int32_t* osm2rdf::osm::DenseMemIndex<TId, TValue>::replica()
+    const noexcept {
+  if (_replicas.size() == 1) {
+    return _replicas[0];
+  }
+  thread_local unsigned node = 0;
+  thread_local unsigned lookups = 0;
+  if (lookups++ % NUMA_NODE_REFRESH == 0) {
+    unsigned cpu = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+      node = 0;
+    }
+  }
+  return _replicas[node < _replicas.size() ? node : 0];
 }
 
 // ____________________________________________________________________________
@@ -32,26 +184,28 @@ template <typename TId, typename TValue>
 void osm2rdf::osm::DenseMemIndex<TId, TValue>::set(const TId id,
                                                    const TValue value) {
   assert(id >= _offset);
-  assert(id < _index.size() + _offset);
-  _index[id - _offset] = value;
+  assert(id < _size + _offset);
+  for (int32_t* data : _replicas) {
+    int32_t* entry = data + 2 * (id - _offset);
+    entry[0] = value.x() ^ EMPTY;
+    entry[1] = value.y() ^ EMPTY;
+  }
 }
 
 // ____________________________________________________________________________
 template <typename TId, typename TValue>
 TValue osm2rdf::osm::DenseMemIndex<TId, TValue>::get_noexcept(
     const TId id) const noexcept {
-  return _index[id - _offset];
+  if (id < _offset || id - _offset >= _size) {
+    return osmium::index::empty_value<TValue>();
+  }
+  const int32_t* entry = replica() + 2 * (id - _offset);
+  return TValue{entry[0] ^ EMPTY, entry[1] ^ EMPTY};
 }
 
 // ____________________________________________________________________________
 template <typename TId, typename TValue>
 TValue osm2rdf::osm::DenseMemIndex<TId, TValue>::get(const TId id) const {
-  if (id < _offset) {
-    throw osmium::not_found{id};
-  }
-  if (id >= _index.size() + _offset) {
-    throw osmium::not_found{id};
-  }
   const auto value = get_noexcept(id);
   if (value == osmium::index::empty_value<TValue>()) {
     throw osmium::not_found{id};
@@ -62,9 +216,11 @@ TValue osm2rdf::osm::DenseMemIndex<TId, TValue>::get(const TId id) const {
 // ____________________________________________________________________________
 template <typename TId, typename TValue>
 void osm2rdf::osm::DenseMemIndex<TId, TValue>::clear() {
-  _index.clear();
-  _index.shrink_to_fit();
+  unmap(0);
+  _replicas.shrink_to_fit();
+  _bytes.shrink_to_fit();
   _offset = 0;
+  _size = 0;
 }
 
 template class osm2rdf::osm::DenseMemIndex<osmium::unsigned_object_id_type,
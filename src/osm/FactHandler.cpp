@@ -38,7 +38,8 @@ using osm2rdf::ttl::constants::DATASET_ID;
 using osm2rdf::ttl::constants::IRI__GEOSPARQL__AS_WKT;
 using osm2rdf::ttl::constants::IRI__GEOSPARQL__HAS_CENTROID;
 using osm2rdf::ttl::constants::IRI__GEOSPARQL__HAS_GEOMETRY;
-using osm2rdf::ttl::constants::IRI__GEOSPARQL__WKT_LITERAL;
+using osm2rdf::ttl::constants::IRI__OSM2RDF__AREA;
+using osm2rdf::ttl::constants::IRI__OSM2RDF__COMPLETE_GEOMETRY;
 using osm2rdf::ttl::constants::IRI__OSM2RDF__LENGTH;
 using osm2rdf::ttl::constants::IRI__OSM2RDF_FACTS;
 using osm2rdf::ttl::constants::IRI__OSM2RDF_GEOM__CONVEX_HULL;
@@ -47,6 +48,9 @@ using osm2rdf::ttl::constants::IRI__OSM2RDF_GEOM__OBB;
 using osm2rdf::ttl::constants::IRI__OSM2RDF_MEMBER__ID;
 using osm2rdf::ttl::constants::IRI__OSM2RDF_MEMBER__POS;
 using osm2rdf::ttl::constants::IRI__OSM2RDF_MEMBER__ROLE;
+using osm2rdf::ttl::constants::IRI__OSMKEY_KEY;
+using osm2rdf::ttl::constants::IRI__OSMKEY_VALUE;
+using osm2rdf::ttl::constants::IRI__OSMREL_MEMBER;
 using osm2rdf::ttl::constants::IRI__OSM_CHANGESET;
 using osm2rdf::ttl::constants::IRI__OSM_NODE;
 using osm2rdf::ttl::constants::IRI__OSM_RELATION;
@@ -66,13 +70,14 @@ using osm2rdf::ttl::constants::IRI__OSMWAY_NODE;
 using osm2rdf::ttl::constants::IRI__OSMWAY_NODE_COUNT;
 using osm2rdf::ttl::constants::IRI__OSMWAY_UNIQUE_NODE_COUNT;
 using osm2rdf::ttl::constants::IRI__RDF_TYPE;
-using osm2rdf::ttl::constants::IRI__XSD_DATE;
-using osm2rdf::ttl::constants::IRI__XSD_DATE_TIME;
-using osm2rdf::ttl::constants::IRI__XSD_DECIMAL;
-using osm2rdf::ttl::constants::IRI__XSD_DOUBLE;
-using osm2rdf::ttl::constants::IRI__XSD_INTEGER;
-using osm2rdf::ttl::constants::IRI__XSD_YEAR;
-using osm2rdf::ttl::constants::IRI__XSD_YEAR_MONTH;
+using osm2rdf::ttl::constants::LITERAL_SUFFIX__GEOSPARQL__WKT_LITERAL;
+using osm2rdf::ttl::constants::LITERAL_SUFFIX__XSD_DATE;
+using osm2rdf::ttl::constants::LITERAL_SUFFIX__XSD_DATE_TIME;
+using osm2rdf::ttl::constants::LITERAL_SUFFIX__XSD_DECIMAL;
+using osm2rdf::ttl::constants::LITERAL_SUFFIX__XSD_DOUBLE;
+using osm2rdf::ttl::constants::LITERAL_SUFFIX__XSD_INTEGER;
+using osm2rdf::ttl::constants::LITERAL_SUFFIX__XSD_YEAR;
+using osm2rdf::ttl::constants::LITERAL_SUFFIX__XSD_YEAR_MONTH;
 using osm2rdf::ttl::constants::LITERAL__FALSE;
 using osm2rdf::ttl::constants::LITERAL__TRUE;
 using osm2rdf::ttl::constants::NAMESPACE__OSM2RDF;
@@ -80,7 +85,6 @@ using osm2rdf::ttl::constants::NAMESPACE__OSM2RDF_GEOM;
 using osm2rdf::ttl::constants::NAMESPACE__OSM2RDF_META;
 using osm2rdf::ttl::constants::NAMESPACE__OSM2RDF_TAG;
 using osm2rdf::ttl::constants::NAMESPACE__OSM_NODE;
-using osm2rdf::ttl::constants::NAMESPACE__OSM_RELATION;
 using osm2rdf::ttl::constants::NAMESPACE__OSM_TAG;
 using osm2rdf::ttl::constants::NAMESPACE__OSM_WAY;
 using osm2rdf::ttl::constants::NAMESPACE__WIKIDATA_ENTITY;
@@ -129,10 +133,12 @@ void osm2rdf::osm::FactHandler<W>::area(const osm2rdf::osm::Area& area) {
 
   // Increase default precision as areas in regbez freiburg have a 0 area
   // otherwise.
-  _writer->writeLiteralTripleUnsafe(
-      subj, _writer->generateIRIUnsafe(NAMESPACE__OSM2RDF, "area"),
-      ::util::formatFloat(area.geomArea(), AREA_PRECISION),
-      "^^" + IRI__XSD_DOUBLE);
+  _writer->triple()
+      .term(subj)
+      .term(IRI__OSM2RDF__AREA)
+      .literalUnsafe(::util::formatFloat(area.geomArea(), AREA_PRECISION),
+                     LITERAL_SUFFIX__XSD_DOUBLE)
+      .end();
 }
 
 // ____________________________________________________________________________
@@ -167,13 +173,18 @@ void osm2rdf::osm::FactHandler<W>::node(const osm2rdf::osm::Node& node) {
   const auto& hullWKT = ::util::geo::getWKT(
       ::util::geo::DPolygon{{node.geom()}, {}}, _config.wktPrecision);
 
-  _writer->writeLiteralTripleUnsafe(subj, IRI__OSM2RDF_GEOM__CONVEX_HULL,
-                                    hullWKT,
-                                    "^^" + IRI__GEOSPARQL__WKT_LITERAL);
+  _writer->triple()
+      .term(subj)
+      .term(IRI__OSM2RDF_GEOM__CONVEX_HULL)
+      .literalUnsafe(hullWKT, LITERAL_SUFFIX__GEOSPARQL__WKT_LITERAL)
+      .end();
   writeBox(subj, IRI__OSM2RDF_GEOM__ENVELOPE,
            ::util::geo::DBox{node.geom(), node.geom()});
-  _writer->writeLiteralTripleUnsafe(subj, IRI__OSM2RDF_GEOM__OBB, hullWKT,
-                                    "^^" + IRI__GEOSPARQL__WKT_LITERAL);
+  _writer->triple()
+      .term(subj)
+      .term(IRI__OSM2RDF_GEOM__OBB)
+      .literalUnsafe(hullWKT, LITERAL_SUFFIX__GEOSPARQL__WKT_LITERAL)
+      .end();
 }
 
 // ____________________________________________________________________________
@@ -191,7 +202,7 @@ void osm2rdf::osm::FactHandler<W>::relation(
 
   size_t inRelPos = 0;
   for (const auto& member : relation.members()) {
-    std::string type;
+    std::string_view type;
     switch (member.type()) {
       case osm2rdf::osm::RelationMemberType::NODE:
         type = NODE_NAMESPACE[_config.sourceDataset];
@@ -206,19 +217,24 @@ void osm2rdf::osm::FactHandler<W>::relation(
         continue;
     }
 
-    const std::string& role = member.role();
     const std::string& blankNode = _writer->generateBlankNode();
-    _writer->writeTriple(
-        subj, _writer->generateIRIUnsafe(NAMESPACE__OSM_RELATION, "member"),
-        blankNode);
-
-    _writer->writeTriple(blankNode, IRI__OSM2RDF_MEMBER__ID,
-                         _writer->generateIRI(type, member.id()));
-    _writer->writeTriple(blankNode, IRI__OSM2RDF_MEMBER__ROLE,
-                         _writer->generateLiteral(role));
-    _writer->writeLiteralTripleUnsafe(blankNode, IRI__OSM2RDF_MEMBER__POS,
-                                      std::to_string(inRelPos++),
-                                      "^^" + IRI__XSD_INTEGER);
+    _writer->writeTriple(subj, IRI__OSMREL_MEMBER, blankNode);
+
+    _writer->triple()
+        .term(blankNode)
+        .term(IRI__OSM2RDF_MEMBER__ID)
+        .iri(type, member.id())
+        .end();
+    _writer->triple()
+        .term(blankNode)
+        .term(IRI__OSM2RDF_MEMBER__ROLE)
+        .literal(member.role())
+        .end();
+    _writer->triple()
+        .term(blankNode)
+        .term(IRI__OSM2RDF_MEMBER__POS)
+        .integerLiteral(inRelPos++, LITERAL_SUFFIX__XSD_INTEGER)
+        .end();
   }
 
   if (relation.hasGeometry()) {
@@ -244,11 +260,8 @@ void osm2rdf::osm::FactHandler<W>::relation(
     writeGeometry(subj, IRI__OSM2RDF_GEOM__OBB, relation.orientedBoundingBox());
 
     _writer->writeTriple(
-        subj,
-        _writer->generateIRIUnsafe(NAMESPACE__OSM2RDF, "completeGeometry"),
-        relation.hasCompleteGeometry()
-            ? osm2rdf::ttl::constants::LITERAL__TRUE
-            : osm2rdf::ttl::constants::LITERAL__FALSE);
+        subj, IRI__OSM2RDF__COMPLETE_GEOMETRY,
+        relation.hasCompleteGeometry() ? LITERAL__TRUE : LITERAL__FALSE);
   }
 }
 
@@ -269,23 +282,27 @@ void osm2rdf::osm::FactHandler<W>::way(const osm2rdf::osm::Way& way) {
     std::string lastBlankNode;
     auto lastNode = way.nodes().front();
     for (const auto& node : way.nodes()) {
-      const std::string& blankNode = _writer->generateBlankNode();
+      std::string blankNode = _writer->generateBlankNode();
       _writer->writeTriple(subj, IRI__OSMWAY_NODE, blankNode);
 
-      _writer->writeTriple(
-          blankNode, osm2rdf::ttl::constants::IRI__OSMWAY_NODE,
-          _writer->generateIRI(NODE_NAMESPACE[_config.sourceDataset],
-                               node.id()));
+      _writer->triple()
+          .term(blankNode)
+          .term(IRI__OSMWAY_NODE)
+          .iri(NODE_NAMESPACE[_config.sourceDataset], node.id())
+          .end();
 
-      _writer->writeLiteralTripleUnsafe(blankNode, IRI__OSM2RDF_MEMBER__POS,
-                                        std::to_string(wayOrder++),
-                                        "^^" + IRI__XSD_INTEGER);
+      _writer->triple()
+          .term(blankNode)
+          .term(IRI__OSM2RDF_MEMBER__POS)
+          .integerLiteral(wayOrder++, LITERAL_SUFFIX__XSD_INTEGER)
+          .end();
 
       if (_config.addWayNodeSpatialMetadata && !lastBlankNode.empty()) {
-        _writer->writeTriple(
-            lastBlankNode, IRI__OSMWAY_NEXT_NODE,
-            _writer->generateIRI(NODE_NAMESPACE[_config.sourceDataset],
-                                 node.id()));
+        _writer->triple()
+            .term(lastBlankNode)
+            .term(IRI__OSMWAY_NEXT_NODE)
+            .iri(NODE_NAMESPACE[_config.sourceDataset], node.id())
+            .end();
         // Haversine distance
         const double distanceLat =
             (node.geom().getY() - lastNode.geom().getY()) *
@@ -301,11 +318,13 @@ void osm2rdf::osm::FactHandler<W>::way(const osm2rdf::osm::Way& way) {
         const double distance = osm2rdf::osm::constants::EARTH_RADIUS_KM *
                                 osm2rdf::osm::constants::METERS_IN_KM * 2 *
                                 asin(sqrt(haversine));
-        _writer->writeLiteralTripleUnsafe(
-            lastBlankNode, IRI__OSMWAY_NEXT_NODE_DISTANCE,
-            std::to_string(distance), "^^" + IRI__XSD_DECIMAL);
+        _writer->triple()
+            .term(lastBlankNode)
+            .term(IRI__OSMWAY_NEXT_NODE_DISTANCE)
+            .doubleLiteral(distance, LITERAL_SUFFIX__XSD_DECIMAL)
+            .end();
       }
-      lastBlankNode = blankNode;
+      lastBlankNode = std::move(blankNode);
       lastNode = node;
     }
   }
@@ -339,17 +358,23 @@ void osm2rdf::osm::FactHandler<W>::way(const osm2rdf::osm::Way& way) {
   if (_config.addWayMetadata) {
     _writer->writeTriple(subj, IRI__OSMWAY_IS_CLOSED,
                          way.closed() ? LITERAL__TRUE : LITERAL__FALSE);
-    _writer->writeLiteralTripleUnsafe(subj, IRI__OSMWAY_NODE_COUNT,
-                                      std::to_string(way.nodes().size()),
-                                      "^^" + IRI__XSD_INTEGER);
-    _writer->writeLiteralTripleUnsafe(subj, IRI__OSMWAY_UNIQUE_NODE_COUNT,
-                                      std::to_string(numUniquePoints),
-                                      "^^" + IRI__XSD_INTEGER);
+    _writer->triple()
+        .term(subj)
+        .term(IRI__OSMWAY_NODE_COUNT)
+        .integerLiteral(way.nodes().size(), LITERAL_SUFFIX__XSD_INTEGER)
+        .end();
+    _writer->triple()
+        .term(subj)
+        .term(IRI__OSMWAY_UNIQUE_NODE_COUNT)
+        .integerLiteral(numUniquePoints, LITERAL_SUFFIX__XSD_INTEGER)
+        .end();
   }
 
-  _writer->writeLiteralTripleUnsafe(
-      subj, IRI__OSM2RDF__LENGTH, std::to_string(::util::geo::len(way.geom())),
-      "^^" + osm2rdf::ttl::constants::IRI__XSD_DOUBLE);
+  _writer->triple()
+      .term(subj)
+      .term(IRI__OSM2RDF__LENGTH)
+      .doubleLiteral(::util::geo::len(way.geom()), LITERAL_SUFFIX__XSD_DOUBLE)
+      .end();
 }
 
 // ____________________________________________________________________________
@@ -369,13 +394,20 @@ void osm2rdf::osm::FactHandler<W>::writeGeometry(const std::string& subj,
       perimeter_or_length /= 2;
     } while ((::util::geo::empty(simplifiedGeom)) &&
              perimeter_or_length >= BASE_SIMPLIFICATION_FACTOR);
-    _writer->writeLiteralTripleUnsafe(
-        subj, pred, ::util::geo::getWKT(simplifiedGeom, _config.wktPrecision),
-        "^^" + IRI__GEOSPARQL__WKT_LITERAL);
+    _writer->triple()
+        .term(subj)
+        .term(pred)
+        .literalUnsafe(
+            ::util::geo::getWKT(simplifiedGeom, _config.wktPrecision),
+            LITERAL_SUFFIX__GEOSPARQL__WKT_LITERAL)
+        .end();
   } else {
-    _writer->writeLiteralTripleUnsafe(
-        subj, pred, ::util::geo::getWKT(geom, _config.wktPrecision),
-        "^^" + IRI__GEOSPARQL__WKT_LITERAL);
+    _writer->triple()
+        .term(subj)
+        .term(pred)
+        .literalUnsafe(::util::geo::getWKT(geom, _config.wktPrecision),
+                       LITERAL_SUFFIX__GEOSPARQL__WKT_LITERAL)
+        .end();
   }
 }
 
@@ -385,9 +417,12 @@ void osm2rdf::osm::FactHandler<W>::writeBox(
     const std::string& subj, const std::string& pred,
     const ::util::geo::Box<double>& box) {
   // Box can not be simplified -> output directly.
-  _writer->writeLiteralTripleUnsafe(
-      subj, pred, ::util::geo::getWKT(box, _config.wktPrecision),
-      "^^" + IRI__GEOSPARQL__WKT_LITERAL);
+  _writer->triple()
+      .term(subj)
+      .term(pred)
+      .literalUnsafe(::util::geo::getWKT(box, _config.wktPrecision),
+                     LITERAL_SUFFIX__GEOSPARQL__WKT_LITERAL)
+      .end();
 }
 
 // ____________________________________________________________________________
@@ -399,38 +434,43 @@ void osm2rdf::osm::FactHandler<W>::writeMeta(const std::string& subj,
 
   // avoid writing empty changeset IDs, drop entire triple
   if (object.changeset() != 0) {
-    _writer->writeTriple(
-        subj, IRI__OSMMETA_CHANGESET,
-        _writer->generateIRI(CHANGESET_NAMESPACE[_config.sourceDataset],
-                             object.changeset()));
+    _writer->triple()
+        .term(subj)
+        .term(IRI__OSMMETA_CHANGESET)
+        .iri(CHANGESET_NAMESPACE[_config.sourceDataset], object.changeset())
+        .end();
   }
 
   writeSecondsAsISO(subj, IRI__OSMMETA_TIMESTAMP, object.timestamp());
 
   // avoid writing empty users, drop entire triple
   if (!object.user().empty()) {
-    _writer->writeTriple(subj, IRI__OSMMETA_USER,
-                         _writer->generateLiteral(object.user(), ""));
+    _writer->triple()
+        .term(subj)
+        .term(IRI__OSMMETA_USER)
+        .literal(object.user())
+        .end();
   }
 
   // avoid writing empty user IDs, drop entire triple
   if (object.uid() != 0) {
-    _writer->writeTriple(subj, IRI__OSMMETA_UID,
-                         _writer->generateLiteral(std::to_string(object.uid()),
-                                                  "^^" + IRI__XSD_INTEGER));
+    _writer->triple()
+        .term(subj)
+        .term(IRI__OSMMETA_UID)
+        .integerLiteral(object.uid(), LITERAL_SUFFIX__XSD_INTEGER)
+        .end();
   }
 
-  _writer->writeTriple(
-      subj, IRI__OSMMETA_VERSION,
-      _writer->generateLiteralUnsafe(std::to_string(object.version()),
-                                     "^^" + IRI__XSD_INTEGER));
+  _writer->triple()
+      .term(subj)
+      .term(IRI__OSMMETA_VERSION)
+      .integerLiteral(object.version(), LITERAL_SUFFIX__XSD_INTEGER)
+      .end();
 
   // only write visibility of it is false
   if (!object.visible()) {
     _writer->writeTriple(subj, IRI__OSMMETA_VISIBLE,
-                         object.visible()
-                             ? osm2rdf::ttl::constants::LITERAL__TRUE
-                             : osm2rdf::ttl::constants::LITERAL__FALSE);
+                         object.visible() ? LITERAL__TRUE : LITERAL__FALSE);
   }
 }
 
@@ -454,10 +494,11 @@ void osm2rdf::osm::FactHandler<W>::writeTag(const std::string& subj,
 
     // if integer, dump as xsd:integer
     if (firstNonMatched != rTrimmed.c_str() && (*firstNonMatched) == 0) {
-      _writer->writeTriple(subj,
-                           _writer->generateIRIUnsafe(NAMESPACE__OSM_TAG, key),
-                           _writer->generateLiteralUnsafe(
-                               std::to_string(lvl), "^^" + IRI__XSD_INTEGER));
+      _writer->triple()
+          .term(subj)
+          .iriUnsafe(NAMESPACE__OSM_TAG, key)
+          .integerLiteral(lvl, LITERAL_SUFFIX__XSD_INTEGER)
+          .end();
     } else {
       _writer->writeUnsafeIRILiteralTriple(subj, NAMESPACE__OSM_TAG, key,
                                            value);
@@ -473,12 +514,16 @@ void osm2rdf::osm::FactHandler<W>::writeTag(const std::string& subj,
       const std::string& blankNode = _writer->generateBlankNode();
       _writer->writeTriple(subj, IRI__OSM_TAG, blankNode);
 
-      _writer->writeTriple(blankNode,
-                           _writer->generateIRI(NAMESPACE__OSM_TAG, "key"),
-                           _writer->generateLiteral(key));
-      _writer->writeTriple(blankNode,
-                           _writer->generateIRI(NAMESPACE__OSM_TAG, "value"),
-                           _writer->generateLiteral(value));
+      _writer->triple()
+          .term(blankNode)
+          .term(IRI__OSMKEY_KEY)
+          .literal(key)
+          .end();
+      _writer->triple()
+          .term(blankNode)
+          .term(IRI__OSMKEY_VALUE)
+          .literal(value)
+          .end();
     }
   }
 }
@@ -603,19 +648,23 @@ void osm2rdf::osm::FactHandler<W>::writeTagList(
         // Invalid length
         continue;
       }
-      std::string typeString[3] = {IRI__XSD_YEAR, IRI__XSD_YEAR_MONTH,
-                                   IRI__XSD_DATE};
-      _writer->writeTriple(
-          subj, _writer->generateIRIUnsafe(NAMESPACE__OSM2RDF_TAG, key),
-          _writer->generateLiteralUnsafe(
-              newValue.substr(0, newValue.size() - 1),
-              "^^" + typeString[resultType - 1]));
+      const std::string* typeSuffix[3] = {&LITERAL_SUFFIX__XSD_YEAR,
+                                          &LITERAL_SUFFIX__XSD_YEAR_MONTH,
+                                          &LITERAL_SUFFIX__XSD_DATE};
+      _writer->triple()
+          .term(subj)
+          .iriUnsafe(NAMESPACE__OSM2RDF_TAG, key)
+          .literalUnsafe(
+              std::string_view(newValue).substr(0, newValue.size() - 1),
+              *typeSuffix[resultType - 1])
+          .end();
     }
   }
-  _writer->writeTriple(
-      subj, _writer->generateIRIUnsafe(NAMESPACE__OSM2RDF, "facts"),
-      _writer->generateLiteralUnsafe(std::to_string(tagTripleCount),
-                                     "^^" + IRI__XSD_INTEGER));
+  _writer->triple()
+      .term(subj)
+      .term(IRI__OSM2RDF_FACTS)
+      .integerLiteral(tagTripleCount, LITERAL_SUFFIX__XSD_INTEGER)
+      .end();
 }
 
 // ____________________________________________________________________________
@@ -628,7 +677,11 @@ void osm2rdf::osm::FactHandler<W>::writeSecondsAsISO(const std::string& subj,
   struct tm t;
   strftime(out, 25, "%Y-%m-%dT%X", gmtime_r(&time, &t));
 
-  _writer->writeLiteralTripleUnsafe(subj, pred, out, "^^" + IRI__XSD_DATE_TIME);
+  _writer->triple()
+      .term(subj)
+      .term(pred)
+      .literalUnsafe(out, LITERAL_SUFFIX__XSD_DATE_TIME)
+      .end();
 }
 
 // ____________________________________________________________________________
@@ -646,3 +699,4 @@ bool osm2rdf::osm::FactHandler<W>::hasSuffix(const std::string& subj,
 template class osm2rdf::osm::FactHandler<osm2rdf::ttl::format::NT>;
 template class osm2rdf::osm::FactHandler<osm2rdf::ttl::format::TTL>;
 template class osm2rdf::osm::FactHandler<osm2rdf::ttl::format::QLEVER>;
+template class osm2rdf::osm::FactHandler<osm2rdf::ttl::format::BINARY>;
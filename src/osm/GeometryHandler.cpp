@@ -18,22 +18,45 @@
 // You should have received a copy of the GNU General Public License
 // along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
 #include <unistd.h>
 
 #include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <numeric>
+#include <string_view>
+#include <system_error>
 #include <thread>
 #include <utility>
 #include <vector>
 
 #include "osm2rdf/config/Config.h"
+#include "osm2rdf/config/Constants.h"
 #include "osm2rdf/osm/Area.h"
 #include "osm2rdf/osm/Constants.h"
 #include "osm2rdf/osm/FactHandler.h"
 #include "osm2rdf/osm/GeometryHandler.h"
+#include "osm2rdf/osm/GeometryState.h"
 #include "osm2rdf/ttl/Constants.h"
 #include "osm2rdf/ttl/Writer.h"
+#include "osm2rdf/util/ExternalSorter.h"
+#include "osm2rdf/util/Hilbert.h"
 #include "osm2rdf/util/ProgressBar.h"
 #include "osm2rdf/util/Time.h"
 #include "spatialjoin/BoxIds.h"
@@ -45,13 +68,338 @@
 #include "omp.h"
 #endif
 
+extern char** environ;
+
 using osm2rdf::osm::Area;
 using osm2rdf::osm::GeometryHandler;
+using osm2rdf::osm::GeometryState;
 using osm2rdf::osm::Node;
 using osm2rdf::osm::Relation;
+using osm2rdf::osm::StateBox;
+using osm2rdf::osm::StateEntry;
+using osm2rdf::osm::StateRelation;
 using osm2rdf::osm::Way;
 
 const static size_t BATCH_SIZE = 10000;
+// Records kept in memory when sorting geometries.
+const static size_t SORT_RECORDS = size_t{1} << 25U;
+// Sorted records added to the sweep in parallel at once.
+const static size_t ADD_RECORDS = size_t{1} << 18U;
+const static int SPILL_FILE_SHIFT = 48;
+// Tile files: magic, tiles per axis, x and y of the tile, records. Records
+// are sorted by the tile in the highest bits.
+const static char TILE_MAGIC[8] = {'O', 'S', 'M', '2', 'R', 'D', 'F', 'T'};
+const static int TILE_SHIFT = 48;
+const static char TILE_WORKER[] = "osm2rdf-tile";
+const static std::chrono::seconds TILE_POLL_INTERVAL{1};
+// Workers touch their claim while processing a tile, see
+// --geometry-tile-timeout.
+const static std::chrono::seconds TILE_HEARTBEAT_INTERVAL{2};
+// Local workers started on a tile whose claim stays stale.
+const static int MAX_TILE_RECLAIMS = 3;
+// Geometries are passed through the sweep with a compact key instead of their
+// IRI: this marker, a type tag and the decimal OSM ID. Keys of auxiliary
+// geometries are their IRIs and never start with the marker.
+const static char COMPACT_ID_MARKER = '\x01';
+const static char NODE_TAG = 'n';
+const static char WAY_TAG = 'w';
+const static char RELATION_TAG = 'r';
+const static int STATE_TAG_SHIFT = 56;
+
+// For the geometry state and sorting, geometries are encoded as records:
+// type, state key, box and the transformed geometry. The hash of a record
+// detects changes between runs. Records which are not added to the sweep
+// right away are spilled to disk prefixed by their size.
+enum class RecordType : uint8_t { POINT, LINE, AREA, RELATION };
+
+// ____________________________________________________________________________
+template <typename T>
+static void put(std::string* record, const T& value) {
+  record->append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// ____________________________________________________________________________
+template <typename T>
+static T get(std::string_view* record) {
+  T value;
+  std::memcpy(&value, record->data(), sizeof(T));
+  record->remove_prefix(sizeof(T));
+  return value;
+}
+
+// ____________________________________________________________________________
+template <typename L>
+static void putLine(std::string* record, const L& line, StateBox* box) {
+  put<uint32_t>(record, line.size());
+  for (const auto& point : line) {
+    put<int32_t>(record, point.getX());
+    put<int32_t>(record, point.getY());
+    box->minX = std::min(box->minX, point.getX());
+    box->minY = std::min(box->minY, point.getY());
+    box->maxX = std::max(box->maxX, point.getX());
+    box->maxY = std::max(box->maxY, point.getY());
+  }
+}
+
+// ____________________________________________________________________________
+template <typename L>
+static void getLine(std::string_view* record, L* line) {
+  line->resize(get<uint32_t>(record));
+  for (auto& point : *line) {
+    const auto x = get<int32_t>(record);
+    point = ::util::geo::I32Point{x, get<int32_t>(record)};
+  }
+}
+
+// ____________________________________________________________________________
+static std::string startRecord(RecordType type, uint64_t key) {
+  std::string record;
+  put(&record, type);
+  put(&record, key);
+  put(&record, StateBox{});
+  return record;
+}
+
+// ____________________________________________________________________________
+static StateBox emptyBox() {
+  return {std::numeric_limits<int32_t>::max(),
+          std::numeric_limits<int32_t>::max(),
+          std::numeric_limits<int32_t>::min(),
+          std::numeric_limits<int32_t>::min()};
+}
+
+// ____________________________________________________________________________
+static void setRecordBox(std::string* record, const StateBox& box) {
+  std::memcpy(record->data() + sizeof(RecordType) + sizeof(uint64_t), &box,
+              sizeof(box));
+}
+
+// ____________________________________________________________________________
+static std::string lineRecord(RecordType type, uint64_t key,
+                              const ::util::geo::I32Line& line) {
+  std::string record = startRecord(type, key);
+  StateBox box = emptyBox();
+  putLine(&record, line, &box);
+  setRecordBox(&record, box);
+  return record;
+}
+
+// ____________________________________________________________________________
+static std::string areaRecord(uint64_t key,
+                              const ::util::geo::I32MultiPolygon& area) {
+  std::string record = startRecord(RecordType::AREA, key);
+  StateBox box = emptyBox();
+  put<uint32_t>(&record, area.size());
+  for (const auto& polygon : area) {
+    putLine(&record, polygon.getOuter(), &box);
+    put<uint32_t>(&record, polygon.getInners().size());
+    for (const auto& inner : polygon.getInners()) {
+      putLine(&record, inner, &box);
+    }
+  }
+  setRecordBox(&record, box);
+  return record;
+}
+
+// ____________________________________________________________________________
+static void readRecordHeader(std::string_view* record, RecordType* type,
+                             uint64_t* key, StateBox* box) {
+  *type = get<RecordType>(record);
+  *key = get<uint64_t>(record);
+  *box = get<StateBox>(record);
+}
+
+// ____________________________________________________________________________
+static void readMembers(std::string_view record,
+                        std::vector<uint64_t>* members) {
+  RecordType type;
+  uint64_t key;
+  StateBox box;
+  readRecordHeader(&record, &type, &key, &box);
+  if (type != RecordType::RELATION) {
+    return;
+  }
+  const uint32_t numMembers = get<uint32_t>(&record);
+  for (uint32_t i = 0; i < numMembers; ++i) {
+    members->push_back(get<uint64_t>(&record));
+    // Sub ID
+    get<uint64_t>(&record);
+  }
+}
+
+// ____________________________________________________________________________
+static void readRecords(const std::filesystem::path& path,
+                        const std::function<void(std::string_view)>& cb) {
+  std::ifstream in{path, std::ios::binary};
+  std::string record;
+  uint32_t size = 0;
+  while (in.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+    record.resize(size);
+    if (!in.read(record.data(), size)) {
+      throw std::runtime_error("Truncated geometry spill " + path.string());
+    }
+    cb(record);
+  }
+}
+
+// ____________________________________________________________________________
+static std::filesystem::path stateTempPath(
+    const osm2rdf::config::Config& config, const std::string& kind, size_t i) {
+  return config.getTempPath("geometry-state", kind + "." + std::to_string(i));
+}
+
+// ____________________________________________________________________________
+// Spilled records are mapped and read back by reference: the file in the
+// highest bits, the offset in the lower ones.
+struct SpillFile {
+  char* data = nullptr;
+  size_t bytes = 0;
+};
+
+// ____________________________________________________________________________
+static std::vector<SpillFile> mapSpills(const osm2rdf::config::Config& config,
+                                        size_t count) {
+  std::vector<SpillFile> spills(count);
+  for (size_t i = 0; i < count; ++i) {
+    const auto path = stateTempPath(config, "records", i);
+    spills[i].bytes = std::filesystem::file_size(path);
+    if (spills[i].bytes == 0) {
+      continue;
+    }
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    void* mapped = MAP_FAILED;
+    if (fd >= 0) {
+      mapped =
+          ::mmap(nullptr, spills[i].bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+      ::close(fd);
+    }
+    if (mapped == MAP_FAILED) {
+      throw std::filesystem::filesystem_error(
+          "Can't map geometry spill", path,
+          std::error_code(errno, std::generic_category()));
+    }
+    ::madvise(mapped, spills[i].bytes, MADV_RANDOM);
+    spills[i].data = static_cast<char*>(mapped);
+  }
+  return spills;
+}
+
+// ____________________________________________________________________________
+static void unmapSpills(const std::vector<SpillFile>& spills) {
+  for (const auto& spill : spills) {
+    if (spill.data != nullptr) {
+      ::munmap(spill.data, spill.bytes);
+    }
+  }
+}
+
+// ____________________________________________________________________________
+static std::string_view spilledRecord(const std::vector<SpillFile>& spills,
+                                      uint64_t ref) {
+  const char* data = spills[ref >> SPILL_FILE_SHIFT].data +
+                     (ref & ((uint64_t{1} << SPILL_FILE_SHIFT) - 1));
+  uint32_t size;
+  std::memcpy(&size, data, sizeof(size));
+  return {data + sizeof(size), size};
+}
+
+// ____________________________________________________________________________
+static void forEachSpilled(
+    const std::vector<SpillFile>& spills,
+    const std::function<void(uint64_t, std::string_view)>& cb) {
+  for (size_t i = 0; i < spills.size(); ++i) {
+    for (size_t offset = 0; offset < spills[i].bytes;) {
+      const uint64_t ref =
+          (static_cast<uint64_t>(i) << SPILL_FILE_SHIFT) | offset;
+      const auto record = spilledRecord(spills, ref);
+      cb(ref, record);
+      offset += sizeof(uint32_t) + record.size();
+    }
+  }
+}
+
+// ____________________________________________________________________________
+static StateBox recordBox(std::string_view record) {
+  RecordType type;
+  uint64_t key;
+  StateBox box;
+  readRecordHeader(&record, &type, &key, &box);
+  return box;
+}
+
+// ____________________________________________________________________________
+static uint64_t hilbertKey(std::string_view record) {
+  const auto box = recordBox(record);
+  return osm2rdf::util::hilbertKey(
+      static_cast<int32_t>((int64_t{box.minX} + box.maxX) / 2),
+      static_cast<int32_t>((int64_t{box.minY} + box.maxY) / 2));
+}
+
+// ____________________________________________________________________________
+// Tile of a coordinate if the world is split into tiles parts per axis.
+static uint32_t tileOf(int32_t v, uint32_t tiles) {
+  return ((int64_t{v} - std::numeric_limits<int32_t>::min()) * tiles) >> 32U;
+}
+
+// ____________________________________________________________________________
+// Predicates of the sweep, the state stores their index. The IRIs depend on
+// the output format and are only set once the writer exists.
+static const size_t NUM_STATE_PREDICATES = 7;
+static const std::string& statePredicate(size_t i) {
+  static const std::string* const PREDICATES[NUM_STATE_PREDICATES] = {
+      &osm2rdf::ttl::constants::IRI__OPENGIS_INTERSECTS,
+      &osm2rdf::ttl::constants::IRI__OPENGIS_CONTAINS,
+      &osm2rdf::ttl::constants::IRI__OPENGIS_COVERS,
+      &osm2rdf::ttl::constants::IRI__OPENGIS_TOUCHES,
+      &osm2rdf::ttl::constants::IRI__OPENGIS_EQUALS,
+      &osm2rdf::ttl::constants::IRI__OPENGIS_OVERLAPS,
+      &osm2rdf::ttl::constants::IRI__OPENGIS_CROSSES};
+  return *PREDICATES[i];
+}
+
+// ____________________________________________________________________________
+static uint64_t statePredicateIndex(const std::string& pred) {
+  for (size_t i = 0; i < NUM_STATE_PREDICATES; ++i) {
+    if (statePredicate(i) == pred) {
+      return i;
+    }
+  }
+  throw std::runtime_error("Unknown geometric relation " + pred);
+}
+
+// ____________________________________________________________________________
+// Whether the predicate with the given index is selected, in sweep order.
+static bool statePredicateEnabled(const osm2rdf::config::Config& config,
+                                  size_t i) {
+  const bool enabled[NUM_STATE_PREDICATES] = {
+      config.addIntersectsRelations, config.addContainsRelations,
+      config.addCoversRelations,     config.addTouchesRelations,
+      config.addEqualsRelations,     config.addOverlapsRelations,
+      config.addCrossesRelations};
+  return enabled[i];
+}
+
+// ____________________________________________________________________________
+// Selected predicates as stored in the state, bit i for the predicate with
+// index i.
+static uint64_t statePredicates(const osm2rdf::config::Config& config) {
+  uint64_t predicates = 0;
+  for (size_t i = 0; i < NUM_STATE_PREDICATES; ++i) {
+    if (statePredicateEnabled(config, i)) {
+      predicates |= uint64_t{1} << i;
+    }
+  }
+  return predicates;
+}
+
+// ____________________________________________________________________________
+// Separator of a predicate in the sweep, empty if it is not selected. The
+// sweeper has no switches per predicate and still calculates it, writeRelCb
+// drops it.
+static std::string sweepPredicate(const osm2rdf::config::Config& config,
+                                  size_t i) {
+  return statePredicateEnabled(config, i) ? statePredicate(i) : "";
+}
 
 // ____________________________________________________________________________
 template <typename W>
@@ -63,13 +411,13 @@ GeometryHandler<W>::GeometryHandler(const osm2rdf::config::Config& config,
           {static_cast<size_t>(config.numThreads),
            static_cast<size_t>(config.numThreads),
            "",
-           osm2rdf::ttl::constants::IRI__OPENGIS_INTERSECTS,
-           osm2rdf::ttl::constants::IRI__OPENGIS_CONTAINS,
-           osm2rdf::ttl::constants::IRI__OPENGIS_COVERS,
-           osm2rdf::ttl::constants::IRI__OPENGIS_TOUCHES,
-           osm2rdf::ttl::constants::IRI__OPENGIS_EQUALS,
-           osm2rdf::ttl::constants::IRI__OPENGIS_OVERLAPS,
-           osm2rdf::ttl::constants::IRI__OPENGIS_CROSSES,
+           sweepPredicate(config, 0),
+           sweepPredicate(config, 1),
+           sweepPredicate(config, 2),
+           sweepPredicate(config, 3),
+           sweepPredicate(config, 4),
+           sweepPredicate(config, 5),
+           sweepPredicate(config, 6),
            "\n",
            true,
            true,
@@ -85,11 +433,44 @@ GeometryHandler<W>::GeometryHandler(const osm2rdf::config::Config& config,
            {},
            [this](size_t progr) { this->progressCb(progr); }},
           config.cache, ""),
-      _parseBatches(config.numThreads) {}
+      _parseBatches(config.numThreads) {
+  if (_config.sortGeometries || _config.geometryTiles > 0) {
+    for (int i = 0; i < _config.numThreads; ++i) {
+      _recordSpills.emplace_back(stateTempPath(_config, "records", i),
+                               std::ios::binary | std::ios::trunc);
+    }
+  }
+  if (_config.geometryState.empty()) {
+    return;
+  }
+  // A state with other predicates would report the difference as added or
+  // removed relations.
+  _state = std::make_unique<GeometryState>(_config.geometryState,
+                                           statePredicates(_config));
+  _stateEntries.resize(_config.numThreads);
+  _stateMembers.resize(_config.numThreads);
+  for (int i = 0; i < _config.numThreads; ++i) {
+    _stateSpills.emplace_back(stateTempPath(_config, "spill", i),
+                              std::ios::binary | std::ios::trunc);
+    _stateRelations.emplace_back(stateTempPath(_config, "relations", i),
+                                 std::ios::binary | std::ios::trunc);
+  }
+}
 
 // ___________________________________________________________________________
 template <typename W>
-GeometryHandler<W>::~GeometryHandler() = default;
+GeometryHandler<W>::~GeometryHandler() {
+  for (size_t i = 0; i < _recordSpills.size(); ++i) {
+    _recordSpills[i].close();
+    std::filesystem::remove(stateTempPath(_config, "records", i));
+  }
+  for (size_t i = 0; i < _stateSpills.size(); ++i) {
+    _stateSpills[i].close();
+    _stateRelations[i].close();
+    std::filesystem::remove(stateTempPath(_config, "spill", i));
+    std::filesystem::remove(stateTempPath(_config, "relations", i));
+  }
+}
 
 // ____________________________________________________________________________
 template <typename W>
@@ -98,37 +479,55 @@ void GeometryHandler<W>::relation(const Relation& rel) {
 
   if (!rel.hasGeometry()) return;
 
-  const std::string id = _writer->generateIRI(
-      osm2rdf::ttl::constants::RELATION_NAMESPACE[_config.sourceDataset],
-      rel.id());
+  const size_t t = omp_get_thread_num();
+  const auto envelope = transform(rel.envelope());
 
   size_t subId = 0;
 
   if (rel.geom().size() > 1) subId = 1;
 
+  // State keys of the members in the sweep and their sub IDs.
+  std::vector<std::pair<uint64_t, uint64_t>> members;
   for (const auto& m : rel.members()) {
     if (m.type() == osm2rdf::osm::RelationMemberType::NODE) {
-      std::string pid = _writer->generateIRI(
-          osm2rdf::ttl::constants::NODE_NAMESPACE[_config.sourceDataset],
-          m.id());
-      _sweeper.add(pid, transform(rel.envelope()), id, subId, false,
-                   _parseBatches[omp_get_thread_num()]);
+      members.emplace_back(stateKey(NODE_TAG, m.id()), subId);
     }
 
     if (m.type() == osm2rdf::osm::RelationMemberType::WAY) {
-      std::string pid = _writer->generateIRI(
-          osm2rdf::ttl::constants::WAY_NAMESPACE[_config.sourceDataset],
-          m.id());
-      _sweeper.add(pid, transform(rel.envelope()), id, subId, false,
-                   _parseBatches[omp_get_thread_num()]);
+      members.emplace_back(stateKey(WAY_TAG, m.id()), subId);
     }
 
     subId++;
   }
 
-  if (_parseBatches[omp_get_thread_num()].size() > BATCH_SIZE) {
-    _sweeper.addBatch(_parseBatches[omp_get_thread_num()]);
-    _parseBatches[omp_get_thread_num()] = {};
+  if (encodeRecords()) {
+    const uint64_t key = stateKey(RELATION_TAG, rel.id());
+    std::string record = startRecord(RecordType::RELATION, key);
+    put<uint32_t>(&record, members.size());
+    for (const auto& [member, memberSubId] : members) {
+      put(&record, member);
+      put(&record, memberSubId);
+      if (_state != nullptr && _state->exists()) {
+        _stateMembers[t].emplace_back(member, key);
+      }
+    }
+    setRecordBox(&record, {envelope.getLowerLeft().getX(),
+                           envelope.getLowerLeft().getY(),
+                           envelope.getUpperRight().getX(),
+                           envelope.getUpperRight().getY()});
+    addGeometry(record, t);
+    return;
+  }
+
+  const std::string id = compactId(RELATION_TAG, rel.id());
+  for (const auto& [member, memberSubId] : members) {
+    _sweeper.add(compactId(member), envelope, id, memberSubId, false,
+                 _parseBatches[t]);
+  }
+
+  if (_parseBatches[t].size() > BATCH_SIZE) {
+    _sweeper.addBatch(_parseBatches[t]);
+    _parseBatches[t] = {};
   }
 }
 
@@ -137,7 +536,112 @@ template <typename W>
 void GeometryHandler<W>::writeRelCb(size_t t, const std::string& a,
                                     const std::string& b,
                                     const std::string& pred) {
-  _writer->writeTriple(a, pred, b, t);
+  // Predicates which are not selected have an empty separator, see
+  // sweepPredicate.
+  if (pred.empty()) return;
+
+  if (_tiles > 0) {
+    const uint64_t keyA = stateKey(a);
+    const uint64_t keyB = stateKey(b);
+    const auto& boxA = _tileBoxes.at(keyA);
+    const auto& boxB = _tileBoxes.at(keyB);
+    // Each tile holding both geometries finds the pair, only the tile with
+    // the lower left corner of the intersection of their boxes keeps it.
+    if (tileOf(std::max(boxA.minX, boxB.minX), _tiles) != _tileX ||
+        tileOf(std::max(boxA.minY, boxB.minY), _tiles) != _tileY) {
+      return;
+    }
+    _tileRelations[t].push_back({keyA, keyB, statePredicateIndex(pred)});
+    return;
+  }
+
+  if (_state != nullptr) {
+    const StateRelation relation{stateKey(a), stateKey(b),
+                                 statePredicateIndex(pred)};
+    // In incremental mode only relations of changed geometries are kept, they
+    // are written once compared to the last run.
+    if (!_state->exists() || changed(relation.a) || changed(relation.b)) {
+      _stateRelations[t].write(reinterpret_cast<const char*>(&relation),
+                               sizeof(relation));
+    }
+    if (_state->exists()) return;
+  }
+
+  auto triple = _writer->triple(t);
+  writeId(&triple, a);
+  triple.term(pred);
+  writeId(&triple, b);
+  triple.end();
+}
+
+// ____________________________________________________________________________
+template <typename W>
+std::string GeometryHandler<W>::compactId(char type, uint64_t id) {
+  char buf[2 + std::numeric_limits<uint64_t>::digits10 + 1];
+  buf[0] = COMPACT_ID_MARKER;
+  buf[1] = type;
+  char* end = std::to_chars(buf + 2, buf + sizeof(buf), id).ptr;
+  return std::string(buf, end - buf);
+}
+
+// ____________________________________________________________________________
+template <typename W>
+std::string GeometryHandler<W>::compactId(uint64_t stateKey) {
+  return compactId(static_cast<char>(stateKey >> STATE_TAG_SHIFT),
+                   stateKey & ((uint64_t{1} << STATE_TAG_SHIFT) - 1));
+}
+
+// ____________________________________________________________________________
+template <typename W>
+uint64_t GeometryHandler<W>::stateKey(char type, uint64_t id) {
+  return (static_cast<uint64_t>(static_cast<uint8_t>(type))
+          << STATE_TAG_SHIFT) |
+         id;
+}
+
+// ____________________________________________________________________________
+template <typename W>
+uint64_t GeometryHandler<W>::stateKey(const std::string& id) {
+  // Auxiliary geometries are not possible with a geometry state.
+  assert(id.size() >= 3 && id[0] == COMPACT_ID_MARKER);
+  uint64_t osmId = 0;
+  std::from_chars(id.data() + 2, id.data() + id.size(), osmId);
+  return stateKey(id[1], osmId);
+}
+
+// ____________________________________________________________________________
+template <typename W>
+void GeometryHandler<W>::writeId(
+    typename osm2rdf::ttl::Writer<W>::Cursor* triple,
+    const std::string& id) const {
+  if (id.size() < 3 || id[0] != COMPACT_ID_MARKER) {
+    triple->term(id);
+    return;
+  }
+  writeKey(triple, stateKey(id));
+}
+
+// ____________________________________________________________________________
+template <typename W>
+void GeometryHandler<W>::writeKey(
+    typename osm2rdf::ttl::Writer<W>::Cursor* triple, uint64_t key) const {
+  const uint64_t osmId = key & ((uint64_t{1} << STATE_TAG_SHIFT) - 1);
+  switch (static_cast<char>(key >> STATE_TAG_SHIFT)) {
+    case NODE_TAG:
+      triple->iri(
+          osm2rdf::ttl::constants::NODE_NAMESPACE[_config.sourceDataset],
+          osmId);
+      break;
+    case RELATION_TAG:
+      triple->iri(
+          osm2rdf::ttl::constants::RELATION_NAMESPACE[_config.sourceDataset],
+          osmId);
+      break;
+    default:
+      triple->iri(
+          osm2rdf::ttl::constants::WAY_NAMESPACE[_config.sourceDataset],
+          osmId);
+  }
 }
 
 // ____________________________________________________________________________
@@ -197,16 +701,20 @@ template <typename W>
 // ____________________________________________________________________________
 template <typename W>
 void GeometryHandler<W>::area(const Area& area) {
-  const std::string id = _writer->generateIRI(
-      areaNS(area.fromWay() ? AreaFromType::WAY : AreaFromType::RELATION),
-      area.objId());
+  const size_t t = omp_get_thread_num();
+  const char type = area.fromWay() ? WAY_TAG : RELATION_TAG;
+  const auto geom = transform(area.geom());
+
+  if (encodeRecords()) {
+    addGeometry(areaRecord(stateKey(type, area.objId()), geom), t);
+    return;
+  }
 
-  _sweeper.add(transform(area.geom()), id, false,
-               _parseBatches[omp_get_thread_num()]);
+  _sweeper.add(geom, compactId(type, area.objId()), false, _parseBatches[t]);
 
-  if (_parseBatches[omp_get_thread_num()].size() > BATCH_SIZE) {
-    _sweeper.addBatch(_parseBatches[omp_get_thread_num()]);
-    _parseBatches[omp_get_thread_num()] = {};
+  if (_parseBatches[t].size() > BATCH_SIZE) {
+    _sweeper.addBatch(_parseBatches[t]);
+    _parseBatches[t] = {};
   }
 }
 
@@ -223,16 +731,21 @@ template <typename W>
 // ____________________________________________________________________________
 template <typename W>
 void GeometryHandler<W>::node(const Node& node) {
-  std::string id = _writer->generateIRI(
-      osm2rdf::ttl::constants::NODE_NAMESPACE[_config.sourceDataset],
-      node.id());
+  const size_t t = omp_get_thread_num();
+  const auto geom = transform(node.geom());
 
-  _sweeper.add(transform(node.geom()), id, false,
-               _parseBatches[omp_get_thread_num()]);
+  if (encodeRecords()) {
+    addGeometry(
+        lineRecord(RecordType::POINT, stateKey(NODE_TAG, node.id()), {geom}),
+        t);
+    return;
+  }
+
+  _sweeper.add(geom, compactId(NODE_TAG, node.id()), false, _parseBatches[t]);
 
-  if (_parseBatches[omp_get_thread_num()].size() > BATCH_SIZE) {
-    _sweeper.addBatch(_parseBatches[omp_get_thread_num()]);
-    _parseBatches[omp_get_thread_num()] = {};
+  if (_parseBatches[t].size() > BATCH_SIZE) {
+    _sweeper.addBatch(_parseBatches[t]);
+    _parseBatches[t] = {};
   }
 }
 
@@ -241,15 +754,20 @@ template <typename W>
 void GeometryHandler<W>::way(const Way& way) {
   if (way.isArea()) return;  // skip way relations, will be handled by area()
 
-  std::string id = _writer->generateIRI(
-      osm2rdf::ttl::constants::WAY_NAMESPACE[_config.sourceDataset], way.id());
+  const size_t t = omp_get_thread_num();
+  const auto geom = transform(way.geom());
 
-  _sweeper.add(transform(way.geom()), id, false,
-               _parseBatches[omp_get_thread_num()]);
+  if (encodeRecords()) {
+    addGeometry(
+        lineRecord(RecordType::LINE, stateKey(WAY_TAG, way.id()), geom), t);
+    return;
+  }
 
-  if (_parseBatches[omp_get_thread_num()].size() > BATCH_SIZE) {
-    _sweeper.addBatch(_parseBatches[omp_get_thread_num()]);
-    _parseBatches[omp_get_thread_num()] = {};
+  _sweeper.add(geom, compactId(WAY_TAG, way.id()), false, _parseBatches[t]);
+
+  if (_parseBatches[t].size() > BATCH_SIZE) {
+    _sweeper.addBatch(_parseBatches[t]);
+    _parseBatches[t] = {};
   }
 }
 
@@ -297,6 +815,29 @@ void GeometryHandler<W>::calculateRelations() {
     delete[] buf;
   }
 
+  if (_config.geometryTiles > 0) {
+    const auto tiles = writeTiles();
+    runTiles(tiles);
+    mergeTiles(tiles);
+    return;
+  }
+
+  std::vector<StateEntry> entries;
+  if (_state != nullptr) {
+    for (auto& threadEntries : _stateEntries) {
+      entries.insert(entries.end(), threadEntries.begin(),
+                     threadEntries.end());
+      std::vector<StateEntry>().swap(threadEntries);
+    }
+    std::sort(entries.begin(), entries.end());
+    if (_state->exists()) {
+      addChangedNeighbours(entries);
+    }
+  }
+  if (_config.sortGeometries) {
+    addSorted();
+  }
+
   _sweeper.flush();
 
   _progressBar = osm2rdf::util::ProgressBar{_sweeper.numElements(), true};
@@ -304,22 +845,792 @@ void GeometryHandler<W>::calculateRelations() {
   _sweeper.sweep();
 
   _progressBar.done();
+
+  if (_state != nullptr) {
+    writeState(entries);
+  }
+}
+
+// ____________________________________________________________________________
+template <typename W>
+void GeometryHandler<W>::addSorted() {
+  for (auto& spill : _recordSpills) {
+    spill.close();
+  }
+  const auto spills = mapSpills(_config, _recordSpills.size());
+
+  osm2rdf::util::ExternalSorter sorter{
+      _config.getTempPath("geometry-state", "sort.keys"), SORT_RECORDS};
+  forEachSpilled(spills, [&sorter](uint64_t ref, std::string_view record) {
+    sorter.add(hilbertKey(record), ref);
+  });
+  sorter.finish();
+
+  std::vector<std::string_view> records;
+  osm2rdf::util::ExternalSorter::Record ref{};
+  while (sorter.next(&ref)) {
+    records.push_back(spilledRecord(spills, ref.value));
+    if (records.size() == ADD_RECORDS) {
+      addRecords(records);
+      records.clear();
+    }
+  }
+  addRecords(records);
+
+  unmapSpills(spills);
 }
 
 // ____________________________________________________________________________
 template <typename W>
-std::string GeometryHandler<W>::areaNS(AreaFromType type) const {
+bool GeometryHandler<W>::stateChanged(size_t t, const std::string& record) {
+  std::string_view header = record;
+  RecordType type;
+  uint64_t key;
+  StateBox box;
+  readRecordHeader(&header, &type, &key, &box);
+  const uint64_t hash = stateHash(record);
+  _stateEntries[t].push_back({key, hash, box});
+
+  const auto* previous = _state->find(key);
+  if (previous == nullptr || previous->hash != hash) {
+    return true;
+  }
+  const uint32_t size = record.size();
+  _stateSpills[t].write(reinterpret_cast<const char*>(&size), sizeof(size));
+  _stateSpills[t].write(record.data(), record.size());
+  return false;
+}
+
+// ____________________________________________________________________________
+template <typename W>
+void GeometryHandler<W>::addGeometry(const std::string& record, size_t t) {
+  if (_state != nullptr && !stateChanged(t, record)) {
+    return;
+  }
+  sweepRecord(record, t);
+}
+
+// ____________________________________________________________________________
+template <typename W>
+void GeometryHandler<W>::sweepRecord(std::string_view record, size_t t) {
+  if (!_recordSpills.empty()) {
+    const uint32_t size = record.size();
+    _recordSpills[t].write(reinterpret_cast<const char*>(&size), sizeof(size));
+    _recordSpills[t].write(record.data(), record.size());
+    return;
+  }
+  addRecord(record, t);
+}
+
+// ____________________________________________________________________________
+template <typename W>
+void GeometryHandler<W>::addRecord(std::string_view record, size_t t) {
+  RecordType type;
+  uint64_t key;
+  StateBox box;
+  readRecordHeader(&record, &type, &key, &box);
+  const std::string id = compactId(key);
+  auto& batch = _parseBatches[t];
+
   switch (type) {
-    case AreaFromType::RELATION:
-      return osm2rdf::ttl::constants::RELATION_NAMESPACE[_config.sourceDataset];
-    case AreaFromType::WAY:
-      return osm2rdf::ttl::constants::WAY_NAMESPACE[_config.sourceDataset];
-    default:
-      return osm2rdf::ttl::constants::WAY_NAMESPACE[_config.sourceDataset];
+    case RecordType::POINT: {
+      ::util::geo::I32Line line;
+      getLine(&record, &line);
+      _sweeper.add(line[0], id, false, batch);
+      break;
+    }
+    case RecordType::LINE: {
+      ::util::geo::I32Line line;
+      getLine(&record, &line);
+      _sweeper.add(line, id, false, batch);
+      break;
+    }
+    case RecordType::AREA: {
+      ::util::geo::I32MultiPolygon area(get<uint32_t>(&record));
+      for (auto& polygon : area) {
+        getLine(&record, &polygon.getOuter());
+        polygon.getInners().resize(get<uint32_t>(&record));
+        for (auto& inner : polygon.getInners()) {
+          getLine(&record, &inner);
+        }
+      }
+      _sweeper.add(area, id, false, batch);
+      break;
+    }
+    case RecordType::RELATION: {
+      const ::util::geo::I32Box envelope{
+          ::util::geo::I32Point{box.minX, box.minY},
+          ::util::geo::I32Point{box.maxX, box.maxY}};
+      const uint32_t numMembers = get<uint32_t>(&record);
+      for (uint32_t i = 0; i < numMembers; ++i) {
+        const auto member = get<uint64_t>(&record);
+        const auto subId = get<uint64_t>(&record);
+        _sweeper.add(compactId(member), envelope, id, subId, false, batch);
+      }
+      break;
+    }
+  }
+
+  if (batch.size() > BATCH_SIZE) {
+    _sweeper.addBatch(batch);
+    batch = {};
+  }
+}
+
+// ____________________________________________________________________________
+template <typename W>
+void GeometryHandler<W>::addRecords(
+    const std::vector<std::string_view>& records) {
+  // Static scheduling keeps neighbouring records in the batch of one thread.
+#pragma omp parallel for num_threads(_config.numThreads) schedule(static)
+  for (size_t i = 0; i < records.size(); ++i) {
+    addRecord(records[i], omp_get_thread_num());
+  }
+  for (auto& b : _parseBatches) {
+    _sweeper.addBatch(b);
+    b = {};
+  }
+}
+
+// ____________________________________________________________________________
+template <typename W>
+void GeometryHandler<W>::addChangedNeighbours(
+    const std::vector<StateEntry>& entries) {
+  // Geometries which are new, removed or have a different hash ...
+  const auto* previous = _state->begin();
+  for (const auto& entry : entries) {
+    while (previous != _state->end() && previous->key < entry.key) {
+      _changed.push_back((previous++)->key);
+    }
+    if (previous != _state->end() && previous->key == entry.key) {
+      if ((previous++)->hash != entry.hash) {
+        _changed.push_back(entry.key);
+      }
+    } else {
+      _changed.push_back(entry.key);
+    }
+  }
+  while (previous != _state->end()) {
+    _changed.push_back((previous++)->key);
+  }
+  // ... and relations with such a member.
+  std::vector<uint64_t> relations;
+  for (const auto& pairs : _stateMembers) {
+    for (const auto& [member, relation] : pairs) {
+      if (changed(member)) {
+        relations.push_back(relation);
+      }
+    }
+  }
+  _changed.insert(_changed.end(), relations.begin(), relations.end());
+  std::sort(_changed.begin(), _changed.end());
+  _changed.erase(std::unique(_changed.begin(), _changed.end()),
+                 _changed.end());
+
+  std::cerr << osm2rdf::util::formattedTimeSpacer << "Changed geometries: "
+            << _changed.size() << " of " << entries.size() << std::endl;
+
+  // Unchanged geometries are only related differently if they intersect the
+  // box of a changed one. Relations need all of their members in the sweep.
+  std::vector<StateBox> boxes;
+  for (const auto& entry : entries) {
+    if (changed(entry.key)) {
+      boxes.push_back(entry.box);
+    }
+  }
+  const BoxGrid grid{boxes};
+
+  std::vector<std::vector<uint64_t>> members(_config.numThreads);
+  for (const auto& pairs : _stateMembers) {
+    for (const auto& [member, relation] : pairs) {
+      if (changed(relation)) {
+        members[0].push_back(member);
+      }
+    }
+  }
+  std::vector<std::vector<std::pair<uint64_t, uint64_t>>>().swap(
+      _stateMembers);
+  for (auto& spill : _stateSpills) {
+    spill.close();
+  }
+
+  const auto isNeighbour = [this, &grid](std::string_view record) {
+    RecordType type;
+    uint64_t key;
+    StateBox box;
+    readRecordHeader(&record, &type, &key, &box);
+    return changed(key) || grid.intersects(box);
+  };
+
+#pragma omp parallel for num_threads(_config.numThreads)
+  for (size_t i = 0; i < _stateSpills.size(); ++i) {
+    const size_t t = omp_get_thread_num();
+    readRecords(stateTempPath(_config, "spill", i),
+                [&](std::string_view record) {
+                  if (isNeighbour(record)) {
+                    sweepRecord(record, t);
+                    readMembers(record, &members[t]);
+                  }
+                });
+  }
+
+  for (size_t t = 1; t < members.size(); ++t) {
+    members[0].insert(members[0].end(), members[t].begin(), members[t].end());
+  }
+  std::sort(members[0].begin(), members[0].end());
+  members[0].erase(std::unique(members[0].begin(), members[0].end()),
+                   members[0].end());
+
+#pragma omp parallel for num_threads(_config.numThreads)
+  for (size_t i = 0; i < _stateSpills.size(); ++i) {
+    const size_t t = omp_get_thread_num();
+    readRecords(stateTempPath(_config, "spill", i),
+                [&](std::string_view record) {
+                  std::string_view header = record;
+                  RecordType type;
+                  uint64_t key;
+                  StateBox box;
+                  readRecordHeader(&header, &type, &key, &box);
+                  if (!isNeighbour(record) &&
+                      std::binary_search(members[0].begin(), members[0].end(),
+                                         key)) {
+                    sweepRecord(record, t);
+                  }
+                });
+  }
+
+  for (auto& b : _parseBatches) {
+    _sweeper.addBatch(b);
+    b = {};
+  }
+}
+
+// ____________________________________________________________________________
+template <typename W>
+void GeometryHandler<W>::writeState(const std::vector<StateEntry>& entries) {
+  for (auto& out : _stateRelations) {
+    out.close();
+  }
+
+  osm2rdf::osm::StateRelationWriter relations{_config.geometryState};
+  if (!_state->exists()) {
+    for (size_t i = 0; i < _stateRelations.size(); ++i) {
+      GeometryState::readRelations(
+          stateTempPath(_config, "relations", i),
+          [&relations](const StateRelation& r) { relations.add(r); });
+    }
+  } else {
+    std::vector<StateRelation> current;
+    for (size_t i = 0; i < _stateRelations.size(); ++i) {
+      GeometryState::readRelations(
+          stateTempPath(_config, "relations", i),
+          [&current](const StateRelation& r) { current.push_back(r); });
+    }
+    std::sort(current.begin(), current.end());
+    current.erase(std::unique(current.begin(), current.end()), current.end());
+
+    // Relations of unchanged geometries are kept as they are.
+    std::vector<StateRelation> previous;
+    _state->forEachRelation([this, &previous,
+                             &relations](const StateRelation& r) {
+      if (changed(r.a) || changed(r.b)) {
+        previous.push_back(r);
+      } else {
+        relations.add(r);
+      }
+    });
+    std::sort(previous.begin(), previous.end());
+    previous.erase(std::unique(previous.begin(), previous.end()),
+                   previous.end());
+    for (const auto& r : current) {
+      relations.add(r);
+    }
+
+    std::vector<StateRelation> added;
+    std::vector<StateRelation> removed;
+    std::set_difference(current.begin(), current.end(), previous.begin(),
+                        previous.end(), std::back_inserter(added));
+    std::set_difference(previous.begin(), previous.end(), current.begin(),
+                        current.end(), std::back_inserter(removed));
+
+    const auto write = [this](osm2rdf::ttl::Writer<W>* writer,
+                              const std::vector<StateRelation>& triples) {
+      for (const auto& r : triples) {
+        auto triple = writer->triple(0);
+        writeKey(&triple, r.a);
+        triple.term(statePredicate(r.predicate));
+        writeKey(&triple, r.b);
+        triple.end();
+      }
+    };
+    write(_writer, added);
+
+    osm2rdf::config::Config removedConfig = _config;
+    removedConfig.output = _config.geometryState.string() + ".removed";
+    removedConfig.outputShards = 0;
+    osm2rdf::util::Output removedOutput{removedConfig, removedConfig.output};
+    if (!removedOutput.open()) {
+      throw std::runtime_error("Can't open " + removedConfig.output.string());
+    }
+    osm2rdf::ttl::Writer<W> removedWriter{removedConfig, &removedOutput};
+    removedWriter.writeHeader();
+    write(&removedWriter, removed);
+    removedWriter.closeGroups();
+    removedOutput.close();
+
+    std::cerr << osm2rdf::util::formattedTimeSpacer
+              << "Geometric relations added: " << added.size()
+              << ", removed: " << removed.size() << std::endl;
+  }
+  relations.close();
+
+  GeometryState::writeEntries(_config.geometryState, statePredicates(_config),
+                              entries);
+}
+
+// ____________________________________________________________________________
+template <typename W>
+std::vector<std::filesystem::path> GeometryHandler<W>::writeTiles() {
+  for (auto& spill : _recordSpills) {
+    spill.close();
+  }
+  const auto spills = mapSpills(_config, _recordSpills.size());
+  const uint32_t tiles = _config.geometryTiles;
+  const auto forEachTile = [tiles](const StateBox& box,
+                                   const std::function<void(uint32_t)>& cb) {
+    for (uint32_t y = tileOf(box.minY, tiles); y <= tileOf(box.maxY, tiles);
+         ++y) {
+      for (uint32_t x = tileOf(box.minX, tiles);
+           x <= tileOf(box.maxX, tiles); ++x) {
+        cb(y * tiles + x);
+      }
+    }
+  };
+
+  // Relations need all of their members in each of their tiles.
+  std::vector<std::pair<uint64_t, uint32_t>> memberTiles;
+  std::vector<uint64_t> members;
+  forEachSpilled(spills, [&](uint64_t, std::string_view record) {
+    members.clear();
+    readMembers(record, &members);
+    if (members.empty()) {
+      return;
+    }
+    forEachTile(recordBox(record), [&](uint32_t tile) {
+      for (const auto& member : members) {
+        memberTiles.emplace_back(member, tile);
+      }
+    });
+  });
+  std::sort(memberTiles.begin(), memberTiles.end());
+  memberTiles.erase(std::unique(memberTiles.begin(), memberTiles.end()),
+                    memberTiles.end());
+
+  // Sort records by tile, within a tile along a Hilbert curve if requested.
+  osm2rdf::util::ExternalSorter sorter{
+      _config.getTempPath("geometry-tile", "keys"), SORT_RECORDS};
+  forEachSpilled(spills, [&](uint64_t ref, std::string_view record) {
+    const uint64_t order =
+        _config.sortGeometries ? hilbertKey(record) >> TILE_SHIFT : 0;
+    const auto box = recordBox(record);
+    forEachTile(box, [&](uint32_t tile) {
+      sorter.add((uint64_t{tile} << TILE_SHIFT) | order, ref);
+    });
+    std::string_view header = record;
+    RecordType type;
+    uint64_t key;
+    StateBox ignored;
+    readRecordHeader(&header, &type, &key, &ignored);
+    for (auto it = std::lower_bound(memberTiles.begin(), memberTiles.end(),
+                                    std::make_pair(key, uint32_t{0}));
+         it != memberTiles.end() && it->first == key; ++it) {
+      const uint32_t x = it->second % tiles;
+      const uint32_t y = it->second / tiles;
+      if (x < tileOf(box.minX, tiles) || x > tileOf(box.maxX, tiles) ||
+          y < tileOf(box.minY, tiles) || y > tileOf(box.maxY, tiles)) {
+        sorter.add((uint64_t{it->second} << TILE_SHIFT) | order, ref);
+      }
+    }
+  });
+  std::vector<std::pair<uint64_t, uint32_t>>().swap(memberTiles);
+  sorter.finish();
+
+  // Tiles are written under a temporary name, workers only see complete
+  // ones.
+  std::vector<std::filesystem::path> paths;
+  std::ofstream out;
+  const auto finishTile = [&out, &paths]() {
+    if (!out.is_open()) {
+      return;
+    }
+    out.close();
+    if (!out) {
+      throw std::filesystem::filesystem_error(
+          "Can't write geometry tile", paths.back(),
+          std::make_error_code(std::errc::io_error));
+    }
+    std::filesystem::rename(paths.back().string() + ".tmp", paths.back());
+  };
+  uint64_t currentTile = std::numeric_limits<uint64_t>::max();
+  osm2rdf::util::ExternalSorter::Record ref{};
+  while (sorter.next(&ref)) {
+    const uint64_t tile = ref.key >> TILE_SHIFT;
+    if (tile != currentTile) {
+      finishTile();
+      currentTile = tile;
+      paths.push_back(_config.getTempPath("geometry-tile",
+                                          std::to_string(tile) + ".records"));
+      std::filesystem::remove(paths.back().string() + ".relations");
+      std::filesystem::remove(paths.back().string() + ".claim");
+      out.open(paths.back().string() + ".tmp",
+               std::ios::binary | std::ios::trunc);
+      const uint32_t header[3] = {tiles, static_cast<uint32_t>(tile % tiles),
+                                  static_cast<uint32_t>(tile / tiles)};
+      out.write(TILE_MAGIC, sizeof(TILE_MAGIC));
+      out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    }
+    const auto record = spilledRecord(spills, ref.value);
+    const uint32_t size = record.size();
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.write(record.data(), record.size());
+  }
+  finishTile();
+  unmapSpills(spills);
+
+  std::cerr << osm2rdf::util::formattedTimeSpacer
+            << "Geometry tiles: " << paths.size() << " of " << tiles * tiles
+            << " not empty" << std::endl;
+  return paths;
+}
+
+// ____________________________________________________________________________
+static std::filesystem::path tileWorker(
+    const osm2rdf::config::Config& config) {
+  if (!config.geometryTileWorker.empty()) {
+    return config.geometryTileWorker;
+  }
+  std::error_code ec;
+  const auto exe = std::filesystem::read_symlink("/proc/self/exe", ec);
+  if (ec) {
+    throw std::runtime_error(
+        "Can't locate " + std::string{TILE_WORKER} + ", set --" +
+        osm2rdf::config::constants::GEOMETRY_TILE_WORKER_OPTION_LONG);
+  }
+  return exe.parent_path() / TILE_WORKER;
+}
+
+// ____________________________________________________________________________
+// Starts a worker on the tiles with the given number of threads.
+static pid_t spawnTileWorker(const std::filesystem::path& worker, int threads,
+                             const std::vector<std::filesystem::path>& tiles) {
+  std::vector<std::string> args = {worker.string(), "--threads",
+                                   std::to_string(threads)};
+  for (const auto& tile : tiles) {
+    args.push_back(tile.string());
+  }
+  std::vector<char*> argv;
+  for (auto& arg : args) {
+    argv.push_back(arg.data());
+  }
+  argv.push_back(nullptr);
+
+  pid_t pid;
+  const int res = ::posix_spawn(&pid, worker.c_str(), nullptr, nullptr,
+                                argv.data(), environ);
+  if (res != 0) {
+    throw std::filesystem::filesystem_error(
+        "Can't start tile worker", worker,
+        std::error_code(res, std::generic_category()));
+  }
+  return pid;
+}
+
+// ____________________________________________________________________________
+// Returns whether the worker exited, waits for it unless options is WNOHANG.
+// Throws if it failed.
+static bool tileWorkerExited(pid_t pid, int options) {
+  int status = 0;
+  if (::waitpid(pid, &status, options) != pid) {
+    return false;
+  }
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    throw std::runtime_error("Tile worker failed");
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+// Runs numWorkers workers on the tiles with threads each and waits for them.
+static void spawnTileWorkers(const std::filesystem::path& worker,
+                             int numWorkers, int threads,
+                             const std::vector<std::filesystem::path>& tiles) {
+  std::vector<pid_t> pids;
+  for (int i = 0; i < numWorkers; ++i) {
+    pids.push_back(spawnTileWorker(worker, threads, tiles));
+  }
+  bool failed = false;
+  for (const auto& pid : pids) {
+    try {
+      tileWorkerExited(pid, 0);
+    } catch (const std::runtime_error&) {
+      failed = true;
+    }
+  }
+  if (failed) {
+    throw std::runtime_error("Tile worker failed");
+  }
+}
+
+// ____________________________________________________________________________
+template <typename W>
+void GeometryHandler<W>::runTiles(
+    const std::vector<std::filesystem::path>& tiles) {
+  const int numWorkers = _config.geometryTileWorkers;
+  if (numWorkers > 0) {
+    // Workers claim tiles themselves, together with workers elsewhere.
+    spawnTileWorkers(tileWorker(_config), numWorkers,
+                     std::max(_config.numThreads / numWorkers, 1), tiles);
+  }
+
+  // Tiles claimed by workers elsewhere. A claim not touched within the
+  // timeout belongs to a stopped worker, the tile is processed again by a
+  // local worker while the stopped one may still continue: the first result
+  // is kept. The run fails if no worker makes progress on the unclaimed
+  // tiles, or if a tile is still stale after MAX_TILE_RECLAIMS local
+  // workers finished.
+  const std::chrono::seconds timeout{_config.geometryTileTimeout};
+  std::vector<size_t> pending(tiles.size());
+  std::iota(pending.begin(), pending.end(), 0);
+  // Running local worker and number of local workers per tile.
+  std::vector<pid_t> replacements(tiles.size(), 0);
+  std::vector<int> reclaims(tiles.size(), 0);
+  const auto stopReplacement = [&replacements](size_t i) {
+    if (replacements[i] != 0) {
+      ::kill(replacements[i], SIGTERM);
+      ::waitpid(replacements[i], nullptr, 0);
+      replacements[i] = 0;
+    }
+  };
+  auto lastProgress = std::chrono::steady_clock::now();
+  bool waiting = false;
+  try {
+    while (true) {
+      std::vector<size_t> unfinished;
+      size_t unclaimed = 0;
+      for (const auto i : pending) {
+        const auto& tile = tiles[i];
+        if (replacements[i] != 0) {
+          const pid_t pid = std::exchange(replacements[i], 0);
+          if (!tileWorkerExited(pid, WNOHANG)) {
+            replacements[i] = pid;
+          }
+        }
+        if (std::filesystem::exists(tile.string() + ".relations")) {
+          // A local worker may still sweep the tile if the stopped worker
+          // continued and stored its result first.
+          stopReplacement(i);
+          lastProgress = std::chrono::steady_clock::now();
+          continue;
+        }
+        unfinished.push_back(i);
+        if (replacements[i] != 0) {
+          lastProgress = std::chrono::steady_clock::now();
+          continue;
+        }
+        std::error_code ec;
+        const auto touched =
+            std::filesystem::last_write_time(tile.string() + ".claim", ec);
+        if (ec) {
+          unclaimed++;
+          continue;
+        }
+        if (std::filesystem::file_time_type::clock::now() - touched <=
+            timeout) {
+          lastProgress = std::chrono::steady_clock::now();
+          continue;
+        }
+        if (reclaims[i] == MAX_TILE_RECLAIMS) {
+          throw std::runtime_error("Geometry tile " + tile.string() +
+                                   " was not processed");
+        }
+        std::cerr << osm2rdf::util::formattedTimeSpacer
+                  << "Reclaiming stale tile " << tile << std::endl;
+        std::filesystem::remove(tile.string() + ".claim");
+        replacements[i] =
+            spawnTileWorker(tileWorker(_config), _config.numThreads, {tile});
+        reclaims[i]++;
+        lastProgress = std::chrono::steady_clock::now();
+      }
+      pending.swap(unfinished);
+      if (pending.empty()) {
+        break;
+      }
+      if (unclaimed > 0 &&
+          std::chrono::steady_clock::now() - lastProgress > timeout) {
+        throw std::runtime_error("No tile worker claimed " +
+                                 std::to_string(unclaimed) +
+                                 " geometry tiles within " +
+                                 std::to_string(timeout.count()) + " s");
+      }
+      if (!waiting) {
+        std::cerr << osm2rdf::util::formattedTimeSpacer << "Waiting for "
+                  << pending.size() << " tiles" << std::endl;
+        waiting = true;
+      }
+      std::this_thread::sleep_for(TILE_POLL_INTERVAL);
+    }
+  } catch (...) {
+    for (size_t i = 0; i < tiles.size(); ++i) {
+      stopReplacement(i);
+    }
+    throw;
   }
 }
 
+// ____________________________________________________________________________
+template <typename W>
+void GeometryHandler<W>::mergeTiles(
+    const std::vector<std::filesystem::path>& tiles) {
+#pragma omp parallel for num_threads(_config.numThreads) schedule(dynamic)
+  for (size_t i = 0; i < tiles.size(); ++i) {
+    const size_t t = omp_get_thread_num();
+    GeometryState::readRelations(
+        tiles[i].string() + ".relations", [this, t](const StateRelation& r) {
+          // Workers calculate and store all predicates.
+          if (!statePredicateEnabled(_config, r.predicate)) return;
+          auto triple = _writer->triple(t);
+          writeKey(&triple, r.a);
+          triple.term(statePredicate(r.predicate));
+          writeKey(&triple, r.b);
+          triple.end();
+        });
+  }
+
+  for (const auto& tile : tiles) {
+    std::filesystem::remove(tile);
+    std::filesystem::remove(tile.string() + ".relations");
+    std::filesystem::remove(tile.string() + ".claim");
+  }
+}
+
+// ____________________________________________________________________________
+template <typename W>
+bool GeometryHandler<W>::claimTile(const std::filesystem::path& tile) {
+  if (std::filesystem::exists(tile.string() + ".relations")) {
+    return false;
+  }
+  const std::string claim = tile.string() + ".claim";
+  const int fd = ::open(claim.c_str(), O_CREAT | O_EXCL | O_WRONLY, 0644);
+  if (fd < 0) {
+    return false;
+  }
+  ::close(fd);
+  return true;
+}
+
+// ____________________________________________________________________________
+template <typename W>
+void GeometryHandler<W>::processTile(const std::filesystem::path& tile) {
+  // Keeps the claim fresh, so the main process does not reclaim the tile.
+  const std::string claim = tile.string() + ".claim";
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool done = false;
+  std::thread heartbeat{[&]() {
+    std::unique_lock<std::mutex> lock{mutex};
+    while (!cv.wait_for(lock, TILE_HEARTBEAT_INTERVAL,
+                        [&done]() { return done; })) {
+      ::utimensat(AT_FDCWD, claim.c_str(), nullptr, 0);
+    }
+  }};
+  const auto stop = [&]() {
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      done = true;
+    }
+    cv.notify_one();
+    heartbeat.join();
+  };
+  try {
+    sweepTile(tile);
+  } catch (...) {
+    stop();
+    throw;
+  }
+  stop();
+}
+
+// ____________________________________________________________________________
+template <typename W>
+void GeometryHandler<W>::sweepTile(const std::filesystem::path& tile) {
+  std::ifstream in{tile, std::ios::binary};
+  char magic[sizeof(TILE_MAGIC)];
+  uint32_t header[3];
+  if (!in.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, TILE_MAGIC, sizeof(magic)) != 0 ||
+      !in.read(reinterpret_cast<char*>(header), sizeof(header))) {
+    throw std::runtime_error("Invalid geometry tile " + tile.string());
+  }
+  _tiles = header[0];
+  _tileX = header[1];
+  _tileY = header[2];
+  _tileRelations.resize(_config.numThreads);
+
+  std::vector<std::string> records;
+  std::vector<std::string_view> views;
+  const auto add = [&]() {
+    views.assign(records.begin(), records.end());
+    addRecords(views);
+    records.clear();
+  };
+  uint32_t size = 0;
+  while (in.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+    auto& record = records.emplace_back(size, '\0');
+    if (!in.read(record.data(), size)) {
+      throw std::runtime_error("Truncated geometry tile " + tile.string());
+    }
+    std::string_view view = record;
+    RecordType type;
+    uint64_t key;
+    StateBox box;
+    readRecordHeader(&view, &type, &key, &box);
+    _tileBoxes[key] = box;
+    if (records.size() == ADD_RECORDS) {
+      add();
+    }
+  }
+  add();
+
+  _sweeper.flush();
+  _progressBar = osm2rdf::util::ProgressBar{_sweeper.numElements(), true};
+  _sweeper.sweep();
+  _progressBar.done();
+
+  // A reclaimed tile may be processed twice, the first result is kept.
+  osm2rdf::osm::StateRelationWriter relations{tile};
+  for (const auto& threadRelations : _tileRelations) {
+    for (const auto& r : threadRelations) {
+      relations.add(r);
+    }
+  }
+  relations.closeIfFirst();
+}
+
+// ____________________________________________________________________________
+template <typename W>
+bool GeometryHandler<W>::encodeRecords() const {
+  return _state != nullptr || _config.sortGeometries ||
+         _config.geometryTiles > 0;
+}
+
+// ____________________________________________________________________________
+template <typename W>
+bool GeometryHandler<W>::changed(uint64_t key) const {
+  return std::binary_search(_changed.begin(), _changed.end(), key);
+}
+
 // ____________________________________________________________________________
 template class osm2rdf::osm::GeometryHandler<osm2rdf::ttl::format::NT>;
 template class osm2rdf::osm::GeometryHandler<osm2rdf::ttl::format::TTL>;
 template class osm2rdf::osm::GeometryHandler<osm2rdf::ttl::format::QLEVER>;
+template class osm2rdf::osm::GeometryHandler<osm2rdf::ttl::format::BINARY>;
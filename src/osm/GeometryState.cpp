@@ -0,0 +1,298 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/GeometryState.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include "osm2rdf/util/Hash.h"
+
+static const char MAGIC[8] = {'O', 'S', 'M', '2', 'R', 'D', 'F', 'G'};
+// Hash function of the entries.
+static const char HASH[8] = {'F', 'N', 'V', '1', 'A', '-', '6', '4'};
+static const size_t HEADER_S =
+    sizeof(MAGIC) + sizeof(HASH) + 2 * sizeof(uint64_t);
+static const size_t READ_BLOCK_SIZE = 65536;
+
+// ____________________________________________________________________________
+static std::filesystem::path relationsPath(const std::filesystem::path& path) {
+  return path.string() + ".relations";
+}
+
+// ____________________________________________________________________________
+uint64_t osm2rdf::osm::stateHash(std::string_view geometry) {
+  return osm2rdf::util::fnv1a(geometry);
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::GeometryState::GeometryState(const std::filesystem::path& path,
+                                           uint64_t predicates)
+    : _path(path) {
+  static_assert(sizeof(StateEntry) == 32);
+  static_assert(sizeof(StateRelation) == 24);
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return;
+  }
+  const size_t bytes = std::filesystem::file_size(path);
+  char header[HEADER_S];
+  uint64_t size = 0;
+  if (bytes < HEADER_S ||
+      ::pread(fd, header, HEADER_S, 0) != static_cast<ssize_t>(HEADER_S) ||
+      std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0) {
+    ::close(fd);
+    throw std::runtime_error("Invalid geometry state " + path.string());
+  }
+  if (std::memcmp(header + sizeof(MAGIC), HASH, sizeof(HASH)) != 0) {
+    ::close(fd);
+    throw std::runtime_error("Geometry state " + path.string() +
+                             " uses another hash function");
+  }
+  uint64_t statePredicates = 0;
+  std::memcpy(&statePredicates, header + sizeof(MAGIC) + sizeof(HASH),
+              sizeof(statePredicates));
+  if (statePredicates != predicates) {
+    ::close(fd);
+    throw std::runtime_error("Geometry state " + path.string() +
+                             " stores other geometric predicates");
+  }
+  std::memcpy(&size,
+              header + sizeof(MAGIC) + sizeof(HASH) + sizeof(statePredicates),
+              sizeof(size));
+  if (bytes != HEADER_S + size * sizeof(StateEntry)) {
+    ::close(fd);
+    throw std::runtime_error("Truncated geometry state " + path.string());
+  }
+  void* mapped = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+  if (mapped == MAP_FAILED) {
+    ::close(fd);
+    throw std::filesystem::filesystem_error(
+        "Can't map geometry state", std::filesystem::absolute(path),
+        std::error_code(errno, std::generic_category()));
+  }
+  _fileDescriptor = fd;
+  _mapped = mapped;
+  _mappedBytes = bytes;
+  _entries = reinterpret_cast<const StateEntry*>(static_cast<char*>(mapped) +
+                                                 HEADER_S);
+  _size = size;
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::GeometryState::~GeometryState() {
+  if (_mapped != nullptr) {
+    ::munmap(_mapped, _mappedBytes);
+  }
+  if (_fileDescriptor >= 0) {
+    ::close(_fileDescriptor);
+  }
+}
+
+// ____________________________________________________________________________
+const osm2rdf::osm::StateEntry* osm2rdf::osm::GeometryState::find(
+    uint64_t key) const noexcept {
+  const auto* it = std::lower_bound(
+      begin(), end(), key,
+      [](const StateEntry& entry, uint64_t k) { return entry.key < k; });
+  return it != end() && it->key == key ? it : nullptr;
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::GeometryState::forEachRelation(
+    const std::function<void(const StateRelation&)>& cb) const {
+  if (!exists()) {
+    return;
+  }
+  readRelations(relationsPath(_path), cb);
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::GeometryState::readRelations(
+    const std::filesystem::path& path,
+    const std::function<void(const StateRelation&)>& cb) {
+  std::ifstream in{path, std::ios::binary};
+  if (!in) {
+    throw std::filesystem::filesystem_error(
+        "Can't read geometry state relations", std::filesystem::absolute(path),
+        std::make_error_code(std::errc::no_such_file_or_directory));
+  }
+  std::vector<StateRelation> block(READ_BLOCK_SIZE);
+  while (in) {
+    in.read(reinterpret_cast<char*>(block.data()),
+            block.size() * sizeof(StateRelation));
+    const size_t count = in.gcount() / sizeof(StateRelation);
+    for (size_t i = 0; i < count; ++i) {
+      cb(block[i]);
+    }
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::GeometryState::writeEntries(
+    const std::filesystem::path& path, uint64_t predicates,
+    const std::vector<StateEntry>& entries) {
+  const std::filesystem::path tmpPath = path.string() + ".tmp";
+  {
+    std::ofstream out{tmpPath, std::ios::binary | std::ios::trunc};
+    const uint64_t size = entries.size();
+    out.write(MAGIC, sizeof(MAGIC));
+    out.write(HASH, sizeof(HASH));
+    out.write(reinterpret_cast<const char*>(&predicates), sizeof(predicates));
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.write(reinterpret_cast<const char*>(entries.data()),
+              entries.size() * sizeof(StateEntry));
+    if (!out) {
+      throw std::filesystem::filesystem_error(
+          "Can't write geometry state", std::filesystem::absolute(tmpPath),
+          std::make_error_code(std::errc::io_error));
+    }
+  }
+  // A state which is still mapped keeps its content.
+  std::filesystem::rename(tmpPath, path);
+}
+
+// ____________________________________________________________________________
+std::string osm2rdf::osm::processSuffix() {
+  char host[256] = {};
+  ::gethostname(host, sizeof(host) - 1);
+  return "." + std::string{host} + "." + std::to_string(::getpid());
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::StateRelationWriter::StateRelationWriter(
+    const std::filesystem::path& path)
+    : _path(relationsPath(path)),
+      _tmpPath(_path.string() + ".tmp" + processSuffix()) {
+  _out.open(_tmpPath, std::ios::binary | std::ios::trunc);
+  if (!_out) {
+    throw std::filesystem::filesystem_error(
+        "Can't open geometry state relations",
+        std::filesystem::absolute(_tmpPath),
+        std::make_error_code(std::errc::permission_denied));
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::StateRelationWriter::add(const StateRelation& relation) {
+  _out.write(reinterpret_cast<const char*>(&relation), sizeof(relation));
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::StateRelationWriter::finish() {
+  _out.close();
+  if (!_out) {
+    std::filesystem::remove(_tmpPath);
+    throw std::filesystem::filesystem_error(
+        "Can't write geometry state relations",
+        std::filesystem::absolute(_tmpPath),
+        std::make_error_code(std::errc::io_error));
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::StateRelationWriter::close() {
+  finish();
+  std::filesystem::rename(_tmpPath, _path);
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::osm::StateRelationWriter::closeIfFirst() {
+  finish();
+  // Unlike rename, link fails if the relations exist.
+  const int res = ::link(_tmpPath.c_str(), _path.c_str());
+  const int error = errno;
+  std::filesystem::remove(_tmpPath);
+  if (res == 0) {
+    return true;
+  }
+  if (error == EEXIST) {
+    return false;
+  }
+  throw std::filesystem::filesystem_error(
+      "Can't store geometry state relations", std::filesystem::absolute(_path),
+      std::error_code(error, std::generic_category()));
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::BoxGrid::BoxGrid(const std::vector<StateBox>& boxes)
+    : _boxes(boxes), _cells(NUM_LEVELS), _levelBoxes(NUM_LEVELS) {
+  for (size_t i = 0; i < _boxes.size(); ++i) {
+    const auto& box = _boxes[i];
+    const int64_t extent =
+        std::max(int64_t{box.maxX} - box.minX, int64_t{box.maxY} - box.minY);
+    int level = 0;
+    while (level + 1 < NUM_LEVELS && extent > (int64_t{1} << cellBits(level))) {
+      level++;
+    }
+    const int bits = cellBits(level);
+    _levelBoxes[level].push_back(i);
+    // Shift coordinates to be non-negative.
+    for (int64_t x = (int64_t{box.minX} - INT32_MIN) >> bits;
+         x <= (int64_t{box.maxX} - INT32_MIN) >> bits; ++x) {
+      for (int64_t y = (int64_t{box.minY} - INT32_MIN) >> bits;
+           y <= (int64_t{box.maxY} - INT32_MIN) >> bits; ++y) {
+        _cells[level][cellKey(x, y)].push_back(i);
+      }
+    }
+  }
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::osm::BoxGrid::intersects(const StateBox& box) const {
+  for (int level = 0; level < NUM_LEVELS; ++level) {
+    if (_levelBoxes[level].empty()) {
+      continue;
+    }
+    const int bits = cellBits(level);
+    const int64_t minX = (int64_t{box.minX} - INT32_MIN) >> bits;
+    const int64_t maxX = (int64_t{box.maxX} - INT32_MIN) >> bits;
+    const int64_t minY = (int64_t{box.minY} - INT32_MIN) >> bits;
+    const int64_t maxY = (int64_t{box.maxY} - INT32_MIN) >> bits;
+    if ((maxX - minX + 1) * (maxY - minY + 1) > MAX_QUERY_CELLS) {
+      for (const auto& i : _levelBoxes[level]) {
+        if (_boxes[i].intersects(box)) {
+          return true;
+        }
+      }
+      continue;
+    }
+    for (int64_t x = minX; x <= maxX; ++x) {
+      for (int64_t y = minY; y <= maxY; ++y) {
+        const auto it = _cells[level].find(cellKey(x, y));
+        if (it == _cells[level].end()) {
+          continue;
+        }
+        for (const auto& i : it->second) {
+          if (_boxes[i].intersects(box)) {
+            return true;
+          }
+        }
+      }
+    }
+  }
+  return false;
+}
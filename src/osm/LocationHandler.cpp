@@ -20,6 +20,7 @@
 
 #include "osm2rdf/config/Config.h"
 #include "osm2rdf/osm/LocationHandler.h"
+#include "osm2rdf/util/Time.h"
 #include "osmium/handler/node_locations_for_ways.hpp"
 #include "osmium/index/map/dense_file_array.hpp"
 #include "osmium/index/map/flex_mem.hpp"
@@ -27,7 +28,13 @@
 
 // ____________________________________________________________________________
 osm2rdf::osm::LocationHandler* osm2rdf::osm::LocationHandler::create(
-    const osm2rdf::config::Config& config, size_t nodeIdMin, size_t nodeIdMax) {
+    const osm2rdf::config::Config& config, size_t nodeIdMin, size_t nodeIdMax,
+    const osm2rdf::osm::ReferencedNodesHandler* referenced) {
+  if (referenced != nullptr) {
+    return new osm2rdf::osm::LocationHandlerFiltered(
+        create(config, nodeIdMin, nodeIdMax), *referenced);
+  }
+
   if (config.storeLocations == "disk-sparse") {
     return new osm2rdf::osm::LocationHandlerFSSparse(config, nodeIdMin,
                                                      nodeIdMax);
@@ -38,11 +45,21 @@ osm2rdf::osm::LocationHandler* osm2rdf::osm::LocationHandler::create(
                                                     nodeIdMax);
   }
 
+  if (config.storeLocations == "disk-persistent") {
+    return new osm2rdf::osm::LocationHandlerFSPersistent(config, nodeIdMin,
+                                                         nodeIdMax);
+  }
+
   if (config.storeLocations == "mem-dense") {
     return new osm2rdf::osm::LocationHandlerRAMDense(config, nodeIdMin,
                                                      nodeIdMax);
   }
 
+  if (config.storeLocations == "mem-compressed") {
+    return new osm2rdf::osm::LocationHandlerRAMCompressed(config, nodeIdMin,
+                                                          nodeIdMax);
+  }
+
   return new osm2rdf::osm::LocationHandlerRAMFlex(config, nodeIdMin, nodeIdMax);
 }
 
@@ -138,17 +155,30 @@ osm2rdf::osm::LocationHandlerImpl<osmium::index::map::DenseFileArray<
 // ____________________________________________________________________________
 osm2rdf::osm::LocationHandlerImpl<osm2rdf::osm::DenseMemIndex<
     osmium::unsigned_object_id_type, osmium::Location>>::
-    LocationHandlerImpl(const osm2rdf::config::Config&, size_t nodeIdMin,
-                        size_t nodeIdMax)
-    : _index(nodeIdMin, nodeIdMax), _handler(_index) {
+    LocationHandlerImpl(const osm2rdf::config::Config& config,
+                        size_t nodeIdMin, size_t nodeIdMax)
+    : _index(nodeIdMin, nodeIdMax, config.storeLocationsHugePages,
+             config.storeLocationsNuma),
+      _handler(_index) {
   _handler.ignore_errors();
+  if (config.storeLocationsHugePages != osm2rdf::config::NO_HUGE_PAGES ||
+      config.storeLocationsNuma != osm2rdf::config::NUMA_LOCAL) {
+    std::cerr << osm2rdf::util::currentTimeFormatted()
+              << "Location index page size: " << _index.pageSize()
+              << " bytes, copies: " << _index.replicas()
+              << (_index.interleaved() ? ", interleaved" : "") << std::endl;
+  }
 }
 
 // ____________________________________________________________________________
 void osm2rdf::osm::LocationHandlerImpl<osm2rdf::osm::DenseMemIndex<
     osmium::unsigned_object_id_type,
     osmium::Location>>::node(const osmium::Node& node) {
-  _handler.node(node);
+  // Bypasses _handler, which tracks the last ID and can't be shared between
+  // threads. Negative IDs are not stored, as by _handler.
+  if (node.id() >= 0) {
+    _index.set(node.positive_id(), node.location());
+  }
 }
 
 // ____________________________________________________________________________
@@ -163,3 +193,53 @@ osmium::Location osm2rdf::osm::LocationHandlerImpl<osm2rdf::osm::DenseMemIndex<
     get_node_location(const osmium::object_id_type nodeId) const {
   return _handler.get_node_location(nodeId);
 }
+
+// ____________________________________________________________________________
+osm2rdf::osm::LocationHandlerImpl<osm2rdf::osm::PersistentLocationIndex<
+    osmium::unsigned_object_id_type, osmium::Location>>::
+    LocationHandlerImpl(const osm2rdf::config::Config& config,
+                        size_t nodeIdMin, size_t nodeIdMax)
+    : _index(config.getTempPath(
+                 "osmium",
+                 config.input.filename().string() +
+                     (config.storeLocationsReferencedOnly
+                          ? ".n2l.referenced.persistent"
+                          : ".n2l.persistent")),
+             osm2rdf::osm::PersistentLocationIndex<
+                 osmium::unsigned_object_id_type,
+                 osmium::Location>::checksum(config.input),
+             nodeIdMin, nodeIdMax),
+      _handler(_index) {
+  _handler.ignore_errors();
+  if (_index.readOnly()) {
+    std::cerr << osm2rdf::util::currentTimeFormatted()
+              << "Attached existing node location index" << std::endl;
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::LocationHandlerImpl<osm2rdf::osm::PersistentLocationIndex<
+    osmium::unsigned_object_id_type,
+    osmium::Location>>::node(const osmium::Node& node) {
+  if (_index.readOnly()) {
+    return;
+  }
+  // See the DenseMemIndex variant.
+  if (node.id() >= 0) {
+    _index.set(node.positive_id(), node.location());
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::LocationHandlerImpl<osm2rdf::osm::PersistentLocationIndex<
+    osmium::unsigned_object_id_type, osmium::Location>>::way(osmium::Way& way) {
+  _handler.way(way);
+}
+
+// ____________________________________________________________________________
+osmium::Location
+osm2rdf::osm::LocationHandlerImpl<osm2rdf::osm::PersistentLocationIndex<
+    osmium::unsigned_object_id_type, osmium::Location>>::
+    get_node_location(const osmium::object_id_type nodeId) const {
+  return _handler.get_node_location(nodeId);
+}
@@ -17,12 +17,19 @@
 // You should have received a copy of the GNU General Public License
 // along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 #include "osm2rdf/osm/CountHandler.h"
 #include "osm2rdf/osm/FactHandler.h"
 #include "osm2rdf/osm/GeometryHandler.h"
 #include "osm2rdf/osm/LocationHandler.h"
 #include "osm2rdf/osm/OsmiumHandler.h"
+#include "osm2rdf/osm/PbfBlocks.h"
+#include "osm2rdf/osm/ReferencedNodesHandler.h"
 #include "osm2rdf/osm/RelationHandler.h"
+#include "osm2rdf/osm/WayNodeJoin.h"
 #include "osm2rdf/util/ProgressBar.h"
 #include "osm2rdf/util/Time.h"
 #include "osmium/area/assembler.hpp"
@@ -34,6 +41,9 @@
 #include "omp.h"
 #endif
 
+// Objects per task when storing locations and resolving way node refs.
+static const size_t LOCATION_GRAIN_SIZE = 4096;
+
 // ____________________________________________________________________________
 template <typename W>
 osm2rdf::osm::OsmiumHandler<W>::OsmiumHandler(
@@ -57,6 +67,24 @@ void osm2rdf::osm::OsmiumHandler<W>::handle() {
     osmium::area::MultipolygonManager<osmium::area::Assembler> mp_manager{
         assembler_config};
     osm2rdf::osm::CountHandler countHandler(_config);
+    osm2rdf::osm::ReferencedNodesHandler referencedNodes;
+    std::unique_ptr<osm2rdf::osm::WayNodeJoin> wayNodeJoin;
+    if (_config.storeLocations == "disk-join") {
+      wayNodeJoin = std::make_unique<osm2rdf::osm::WayNodeJoin>(_config);
+    }
+    // Location stores used with --nodes-first-pass do not depend on the node
+    // ID range.
+    std::unique_ptr<osm2rdf::osm::LocationHandler> locationHandler;
+    if (_config.nodesFirstPass) {
+      locationHandler.reset(
+          osm2rdf::osm::LocationHandler::create(_config, 0, 0));
+    }
+    // Buffers read in the first pass and the leading ones only with nodes.
+    size_t numBuffers = 0;
+    size_t numNodeBuffers = 0;
+    // Nodes handled in the first pass are shown by the progress bar of the
+    // reader.
+    _progressBar = osm2rdf::util::ProgressBar{0, false};
 
     // read relations for areas
     {
@@ -64,18 +92,92 @@ void osm2rdf::osm::OsmiumHandler<W>::handle() {
       std::cerr << osm2rdf::util::currentTimeFormatted()
                 << "OSM Pass 1 ... (Count objects, Relations for areas"
                 << ", Relation members)" << std::endl;
-      osmium::io::ReaderWithProgressBar reader{true, input_file,
-                                               osmium::osm_entity_bits::object};
+      osmium::thread::Pool pool(std::max(_config.numThreads - 2, 1),
+                                osmium::thread::Pool::default_queue_size);
+
+#if defined(_OPENMP)
+      omp_set_num_threads(_config.numThreads);
+#endif
+
+      osmium::io::ReaderWithProgressBar reader{
+          true, input_file, osmium::osm_entity_bits::object, pool};
+      // Counts and relation members are collected per thread and merged
+      // after the pass.
+      std::vector<osm2rdf::osm::CountHandler> countShards(
+          _config.numThreads, osm2rdf::osm::CountHandler{_config});
+      std::vector<osm2rdf::osm::RelationHandler> relationShards(
+          _config.numThreads, osm2rdf::osm::RelationHandler{_config});
+#pragma omp parallel
       {
-        while (auto buf = reader.read()) {
-          osmium::apply(buf, mp_manager, _relationHandler, countHandler);
+#pragma omp single
+        {
+          while (auto buf = reader.read()) {
+            // The multipolygon manager, the referenced nodes and the join
+            // see the buffers in input order.
+            osmium::apply(buf, mp_manager);
+            if (_config.storeLocationsReferencedOnly) {
+              osmium::apply(buf, referencedNodes);
+            }
+            if (wayNodeJoin) {
+              osmium::apply(buf, *wayNodeJoin);
+            }
+            if (locationHandler) {
+              bool onlyNodes = true;
+              for (const auto& object : buf.select<osmium::OSMObject>()) {
+                if (object.type() != osmium::item_type::node) {
+                  onlyNodes = false;
+                  continue;
+                }
+                const auto& node = static_cast<const osmium::Node&>(object);
+                locationHandler->node(node);
+                this->node(node);
+              }
+              if (onlyNodes && numNodeBuffers == numBuffers) {
+                numNodeBuffers++;
+              }
+              numBuffers++;
+            }
+            auto shard =
+                std::make_shared<osmium::memory::Buffer>(std::move(buf));
+#pragma omp task firstprivate(shard)
+            {
+              int thread = 0;
+#if defined(_OPENMP)
+              thread = omp_get_thread_num();
+#endif
+              osmium::apply(*shard, countShards[thread],
+                            relationShards[thread]);
+            }
+          }
         }
       }
       reader.close();
+      for (size_t i = 0; i < countShards.size(); ++i) {
+        countHandler.merge(countShards[i]);
+        _relationHandler.merge(relationShards[i]);
+      }
+      countShards.clear();
+      relationShards.clear();
       mp_manager.prepare_for_lookup();
       _relationHandler.prepare_for_lookup();
       std::cerr << osm2rdf::util::currentTimeFormatted() << "... done"
                 << std::endl;
+      if (_config.storeLocationsReferencedOnly) {
+        std::cerr << osm2rdf::util::currentTimeFormatted()
+                  << "referenced nodes: " << referencedNodes.size()
+                  << std::endl;
+      }
+    }
+
+    // join way node refs with node locations
+    if (wayNodeJoin) {
+      std::cerr << std::endl;
+      std::cerr << osm2rdf::util::currentTimeFormatted()
+                << "OSM Pass 1b ... (Join " << wayNodeJoin->numRefs()
+                << " way node refs)" << std::endl;
+      wayNodeJoin->join();
+      std::cerr << osm2rdf::util::currentTimeFormatted() << "... done"
+                << std::endl;
     }
 
     // store data
@@ -90,18 +192,54 @@ void osm2rdf::osm::OsmiumHandler<W>::handle() {
       omp_set_num_threads(_config.numThreads);
 #endif
 
-      osmium::io::Reader reader{input_file, osmium::osm_entity_bits::object,
-                                pool};
-      osm2rdf::osm::LocationHandler* locationHandler =
-          osm2rdf::osm::LocationHandler::create(
-              _config, countHandler.minNodeId(), countHandler.maxNodeId());
-      _relationHandler.setLocationHandler(locationHandler);
+      // Nodes are already handled with --nodes-first-pass. For PBF input the
+      // leading blocks with only nodes are not even read again, if each
+      // buffer of the first pass matches one data block.
+      osmium::io::File pass2File = input_file;
+      osmium::osm_entity_bits::type pass2Entities =
+          osmium::osm_entity_bits::object;
+      std::unique_ptr<osm2rdf::osm::PbfSection> pbfSection;
+      if (_config.nodesFirstPass) {
+        pass2Entities =
+            osmium::osm_entity_bits::way | osmium::osm_entity_bits::relation;
+        if (input_file.format() == osmium::io::file_format::pbf &&
+            numNodeBuffers > 0) {
+          const osm2rdf::osm::PbfBlocks blocks{_config.input};
+          if (blocks.dataOffsets().size() == numBuffers) {
+            pbfSection = std::make_unique<osm2rdf::osm::PbfSection>(
+                _config.input, blocks.headerEnd(),
+                numNodeBuffers < numBuffers
+                    ? blocks.dataOffsets()[numNodeBuffers]
+                    : blocks.fileSize());
+            pass2File = osmium::io::File{pbfSection->path(), "pbf"};
+            std::cerr << osm2rdf::util::currentTimeFormatted()
+                      << "skipping " << numNodeBuffers << " of " << numBuffers
+                      << " blocks with only nodes" << std::endl;
+          }
+        }
+      }
+
+      osmium::io::Reader reader{pass2File, pass2Entities, pool};
+      if (!locationHandler) {
+        locationHandler.reset(
+            wayNodeJoin ? new osm2rdf::osm::LocationHandlerJoin(
+                              wayNodeJoin.get())
+                        : osm2rdf::osm::LocationHandler::create(
+                              _config, countHandler.minNodeId(),
+                              countHandler.maxNodeId(),
+                              _config.storeLocationsReferencedOnly
+                                  ? &referencedNodes
+                                  : nullptr));
+      }
+      _relationHandler.setLocationHandler(locationHandler.get());
 
       size_t numTasks = 0;
-      if (!_config.noFacts && !_config.noNodeFacts) {
+      if (!_config.nodesFirstPass && !_config.noFacts &&
+          !_config.noNodeFacts) {
         numTasks += countHandler.numNodes();
       }
-      if (!_config.noGeometricRelations && !_config.noNodeGeometricRelations) {
+      if (!_config.nodesFirstPass && !_config.noGeometricRelations &&
+          !_config.noNodeGeometricRelations) {
         numTasks += countHandler.numNodes();
       }
       if (!_config.noFacts && !_config.noRelationFacts) {
@@ -118,6 +256,7 @@ void osm2rdf::osm::OsmiumHandler<W>::handle() {
         numTasks += countHandler.numWays();
       }
 
+      _numTasksDone = 0;
       _progressBar = osm2rdf::util::ProgressBar{numTasks, true};
       _progressBar.update(_numTasksDone);
 
@@ -125,18 +264,97 @@ void osm2rdf::osm::OsmiumHandler<W>::handle() {
       {
 #pragma omp single
         {
+          std::vector<const osmium::Node*> nodes;
+          std::vector<osmium::Way*> ways;
+          bool parallelLocations = locationHandler->concurrent();
+          bool waysSeen = false;
           while (auto buf = reader.read()) {
+            if (parallelLocations) {
+              // Nodes have to precede ways, in the buffer and the input, as
+              // ways only read locations stored before.
+              nodes.clear();
+              ways.clear();
+              for (auto& object : buf.select<osmium::OSMObject>()) {
+                if (object.type() == osmium::item_type::node) {
+                  if (waysSeen || !ways.empty()) {
+                    parallelLocations = false;
+                    break;
+                  }
+                  nodes.push_back(static_cast<const osmium::Node*>(&object));
+                } else if (object.type() == osmium::item_type::way) {
+                  ways.push_back(static_cast<osmium::Way*>(&object));
+                }
+              }
+              waysSeen |= !ways.empty();
+              if (!parallelLocations) {
+                std::cerr << osm2rdf::util::currentTimeFormatted()
+                          << "Input is not sorted, storing locations "
+                             "sequentially"
+                          << std::endl;
+              }
+            }
+            if (!parallelLocations) {
+              osmium::apply(
+                  buf, *locationHandler, _relationHandler,
+                  mp_manager.handler([&](osmium::memory::Buffer&& buffer) {
+                    osmium::apply(buffer, *this);
+                  }),
+                  *this);
+              continue;
+            }
+            // Store locations and resolve way node refs of this buffer in
+            // parallel. Each taskloop waits for its tasks, so ways only read
+            // finished locations.
+#pragma omp taskloop grainsize(LOCATION_GRAIN_SIZE)
+            for (size_t i = 0; i < nodes.size(); ++i) {
+              locationHandler->node(*nodes[i]);
+            }
+#pragma omp taskloop grainsize(LOCATION_GRAIN_SIZE)
+            for (size_t i = 0; i < ways.size(); ++i) {
+              locationHandler->way(*ways[i]);
+            }
             osmium::apply(
-                buf, *locationHandler, _relationHandler,
+                buf, _relationHandler,
                 mp_manager.handler([&](osmium::memory::Buffer&& buffer) {
                   osmium::apply(buffer, *this);
                 }),
                 *this);
           }
+          // Relations containing or contained in other relations are built
+          // level by level, so members are stored before their parents.
+          std::stable_sort(_nestedRelations.begin(), _nestedRelations.end(),
+                           [&](const osm2rdf::osm::Relation& a,
+                               const osm2rdf::osm::Relation& b) {
+                             return _relationHandler.nestedLevel(a.id()) <
+                                    _relationHandler.nestedLevel(b.id());
+                           });
+          size_t levelBegin = 0;
+          while (levelBegin < _nestedRelations.size()) {
+            const uint32_t level =
+                _relationHandler.nestedLevel(_nestedRelations[levelBegin].id());
+            size_t levelEnd = levelBegin;
+            while (levelEnd < _nestedRelations.size() &&
+                   _relationHandler.nestedLevel(
+                       _nestedRelations[levelEnd].id()) == level) {
+              levelEnd++;
+            }
+#pragma omp taskloop
+            for (size_t i = levelBegin; i < levelEnd; ++i) {
+              handleRelation(&_nestedRelations[i]);
+            }
+            levelBegin = levelEnd;
+          }
+          _nestedRelations.clear();
         }
       }
       reader.close();
-      delete locationHandler;
+      if (pbfSection) {
+        pbfSection->close();
+      }
+      // All nodes are stored once pass 2 completed.
+      locationHandler->finish();
+      _relationHandler.setLocationHandler(nullptr);
+      locationHandler.reset();
       _progressBar.done();
 
       std::cerr << osm2rdf::util::currentTimeFormatted() << "... done"
@@ -234,7 +452,10 @@ void osm2rdf::osm::OsmiumHandler<W>::relation(
     const osmium::Relation& relation) {
   _relationsSeen++;
 
-  if (!_config.addUntaggedRelations && relation.tags().empty()) {
+  // Untagged relations are still needed for the geometry of their parents.
+  const bool nested = _relationHandler.nestedLevel(relation.positive_id()) !=
+                      osm2rdf::osm::RelationHandler::NO_NESTED_LEVEL;
+  if (!nested && !_config.addUntaggedRelations && relation.tags().empty()) {
     return;
   }
 
@@ -242,28 +463,12 @@ void osm2rdf::osm::OsmiumHandler<W>::relation(
     // only task this away if we actually build the relation geometries,
     // otherwise this just adds multithreading overhead for nothing
     auto osmRelation = osm2rdf::osm::Relation(relation);
-#pragma omp task
-    {
-      if (!osmRelation.isArea() && _relationHandler.hasLocationHandler()) {
-        osmRelation.buildGeometry(_relationHandler);
-      }
-
-      if (!_config.noFacts && !_config.noRelationFacts) {
-        _factHandler->relation(osmRelation);
-#pragma omp critical(progress)
-        {
-          _relationsDumped++;
-          _progressBar.update(_numTasksDone++);
-        }
-      }
-
-      if (!_config.noGeometricRelations &&
-          !_config.noRelationGeometricRelations) {
-        _geometryHandler->relation(osmRelation);
-#pragma omp critical(progress)
-        _progressBar.update(_numTasksDone++);
-      }
+    if (nested) {
+      _nestedRelations.push_back(std::move(osmRelation));
+      return;
     }
+#pragma omp task
+    { handleRelation(&osmRelation); }
   } catch (const osmium::invalid_location& e) {
     if (!_config.noFacts && !_config.noRelationFacts) {
       _progressBar.update(_numTasksDone++);
@@ -277,6 +482,36 @@ void osm2rdf::osm::OsmiumHandler<W>::relation(
   }
 }
 
+// ____________________________________________________________________________
+template <typename W>
+void osm2rdf::osm::OsmiumHandler<W>::handleRelation(
+    osm2rdf::osm::Relation* relation) {
+  if (!relation->isArea() && _relationHandler.hasLocationHandler()) {
+    relation->buildGeometry(_relationHandler);
+  }
+  _relationHandler.setRelationGeometry(relation->id(), relation->geom(),
+                                       relation->hasCompleteGeometry());
+
+  if (!_config.addUntaggedRelations && relation->tags().empty()) {
+    return;
+  }
+
+  if (!_config.noFacts && !_config.noRelationFacts) {
+    _factHandler->relation(*relation);
+#pragma omp critical(progress)
+    {
+      _relationsDumped++;
+      _progressBar.update(_numTasksDone++);
+    }
+  }
+
+  if (!_config.noGeometricRelations && !_config.noRelationGeometricRelations) {
+    _geometryHandler->relation(*relation);
+#pragma omp critical(progress)
+    _progressBar.update(_numTasksDone++);
+  }
+}
+
 // ____________________________________________________________________________
 template <typename W>
 void osm2rdf::osm::OsmiumHandler<W>::way(const osmium::Way& way) {
@@ -399,3 +634,4 @@ size_t osm2rdf::osm::OsmiumHandler<W>::wayGeometriesHandled() const {
 template class osm2rdf::osm::OsmiumHandler<osm2rdf::ttl::format::NT>;
 template class osm2rdf::osm::OsmiumHandler<osm2rdf::ttl::format::TTL>;
 template class osm2rdf::osm::OsmiumHandler<osm2rdf::ttl::format::QLEVER>;
+template class osm2rdf::osm::OsmiumHandler<osm2rdf::ttl::format::BINARY>;
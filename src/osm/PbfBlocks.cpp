@@ -0,0 +1,251 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/PbfBlocks.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+
+// Limit of the size of a blob header in the PBF format.
+static const uint32_t MAX_BLOB_HEADER_S = 64 * 1024;
+static const size_t FEED_BUFFER_S = 1024 * 1024;
+
+// ____________________________________________________________________________
+static uint64_t readVarint(const uint8_t** pos, const uint8_t* end) {
+  uint64_t v = 0;
+  for (int shift = 0; *pos < end && shift < 64; shift += 7) {
+    const uint8_t b = *(*pos)++;
+    v |= static_cast<uint64_t>(b & 0x7FU) << shift;
+    if ((b & 0x80U) == 0) {
+      return v;
+    }
+  }
+  throw std::runtime_error("Invalid varint in PBF blob header");
+}
+
+// ____________________________________________________________________________
+static void readFully(int fd, void* data, size_t size, uint64_t offset) {
+  auto* pos = static_cast<char*>(data);
+  while (size > 0) {
+    const ssize_t n = ::pread(fd, pos, size, static_cast<off_t>(offset));
+    if (n <= 0) {
+      throw std::runtime_error("Truncated PBF file");
+    }
+    pos += n;
+    size -= n;
+    offset += n;
+  }
+}
+
+// ____________________________________________________________________________
+// Reads the header of the blob at offset, returns its type and the offset of
+// the next blob.
+static std::string readBlobHeader(int fd, uint64_t offset, uint64_t* next) {
+  uint8_t sizeBytes[4];
+  readFully(fd, sizeBytes, sizeof(sizeBytes), offset);
+  const uint32_t headerSize = (uint32_t{sizeBytes[0]} << 24U) |
+                              (uint32_t{sizeBytes[1]} << 16U) |
+                              (uint32_t{sizeBytes[2]} << 8U) | sizeBytes[3];
+  if (headerSize > MAX_BLOB_HEADER_S) {
+    throw std::runtime_error("PBF blob header too large");
+  }
+  std::vector<uint8_t> header(headerSize);
+  readFully(fd, header.data(), headerSize, offset + sizeof(sizeBytes));
+
+  // BlobHeader: 1 type (string), 2 indexdata (bytes), 3 datasize (int32)
+  std::string type;
+  uint64_t dataSize = 0;
+  const uint8_t* pos = header.data();
+  const uint8_t* end = header.data() + header.size();
+  while (pos < end) {
+    const uint64_t key = readVarint(&pos, end);
+    const uint64_t field = key >> 3U;
+    switch (key & 0x7U) {
+      case 0: {
+        const uint64_t value = readVarint(&pos, end);
+        if (field == 3) {
+          dataSize = value;
+        }
+        break;
+      }
+      case 1:
+        pos += 8;
+        break;
+      case 2: {
+        const uint64_t length = readVarint(&pos, end);
+        if (length > static_cast<uint64_t>(end - pos)) {
+          throw std::runtime_error("Invalid PBF blob header");
+        }
+        if (field == 1) {
+          type.assign(reinterpret_cast<const char*>(pos), length);
+        }
+        pos += length;
+        break;
+      }
+      case 5:
+        pos += 4;
+        break;
+      default:
+        throw std::runtime_error("Invalid PBF blob header");
+    }
+  }
+  *next = offset + sizeof(sizeBytes) + headerSize + dataSize;
+  return type;
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::PbfBlocks::PbfBlocks(const std::filesystem::path& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    throw std::filesystem::filesystem_error(
+        "Can't open PBF file", std::filesystem::absolute(path),
+        std::error_code(errno, std::generic_category()));
+  }
+  try {
+    _fileSize = std::filesystem::file_size(path);
+    uint64_t offset = 0;
+    while (offset < _fileSize) {
+      uint64_t next = 0;
+      const auto type = readBlobHeader(fd, offset, &next);
+      if (offset == 0 && type != "OSMHeader") {
+        throw std::runtime_error("PBF file does not start with OSMHeader");
+      }
+      if (offset == 0) {
+        _headerEnd = next;
+      } else if (type == "OSMData") {
+        _dataOffsets.push_back(offset);
+      }
+      offset = next;
+    }
+    if (offset != _fileSize) {
+      throw std::runtime_error("Truncated PBF file");
+    }
+  } catch (...) {
+    ::close(fd);
+    throw;
+  }
+  ::close(fd);
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::PbfSection::PbfSection(const std::filesystem::path& path,
+                                     uint64_t headerEnd, uint64_t offset) {
+  int fds[2];
+  if (::pipe(fds) != 0) {
+    throw std::system_error(errno, std::generic_category(),
+                            "Can't create pipe for PBF section");
+  }
+  _readFileDescriptor = fds[0];
+  _writeFileDescriptor = fds[1];
+  _feeder = std::thread(&PbfSection::feed, this, path, headerEnd, offset);
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::PbfSection::~PbfSection() {
+  // Without readers left, a feeder still writing fails with EPIPE.
+  if (_readFileDescriptor != -1) {
+    ::close(_readFileDescriptor);
+  }
+  if (_feeder.joinable()) {
+    _feeder.join();
+  }
+}
+
+// ____________________________________________________________________________
+std::string osm2rdf::osm::PbfSection::path() const {
+  return "/proc/self/fd/" + std::to_string(_readFileDescriptor);
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::PbfSection::close() {
+  ::close(_readFileDescriptor);
+  _readFileDescriptor = -1;
+  _feeder.join();
+  if (_error) {
+    std::rethrow_exception(_error);
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::PbfSection::feed(const std::filesystem::path& path,
+                                    uint64_t headerEnd, uint64_t offset) {
+  // Report a closed pipe as EPIPE instead of terminating.
+  sigset_t sigpipe;
+  sigemptyset(&sigpipe);
+  sigaddset(&sigpipe, SIGPIPE);
+  pthread_sigmask(SIG_BLOCK, &sigpipe, nullptr);
+
+  int fd = -1;
+  std::vector<char> buffer(FEED_BUFFER_S);
+  // Copies [begin, end) of the file into the pipe.
+  const auto copy = [&](uint64_t begin, uint64_t end) {
+    while (begin < end) {
+      const size_t size = std::min<uint64_t>(buffer.size(), end - begin);
+      const ssize_t n =
+          ::pread(fd, buffer.data(), size, static_cast<off_t>(begin));
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n < 0) {
+        throw std::filesystem::filesystem_error(
+            "Can't read PBF file", std::filesystem::absolute(path),
+            std::error_code(errno, std::generic_category()));
+      }
+      if (n == 0) {
+        throw std::runtime_error("Truncated PBF file");
+      }
+      for (ssize_t written = 0; written < n;) {
+        const ssize_t w = ::write(_writeFileDescriptor, buffer.data() + written,
+                                  n - written);
+        if (w < 0 && errno == EINTR) {
+          continue;
+        }
+        if (w < 0) {
+          throw std::system_error(errno, std::generic_category(),
+                                  "Can't write PBF section");
+        }
+        written += w;
+      }
+      begin += n;
+    }
+  };
+  try {
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+      throw std::filesystem::filesystem_error(
+          "Can't open PBF file", std::filesystem::absolute(path),
+          std::error_code(errno, std::generic_category()));
+    }
+    const uint64_t fileSize = std::filesystem::file_size(path);
+    copy(0, headerEnd);
+    copy(offset, fileSize);
+  } catch (...) {
+    _error = std::current_exception();
+  }
+  if (fd != -1) {
+    ::close(fd);
+  }
+  // The reader sees the end of the file, or a truncated one on errors.
+  ::close(_writeFileDescriptor);
+}
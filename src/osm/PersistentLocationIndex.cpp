@@ -0,0 +1,213 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/PersistentLocationIndex.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "osm2rdf/util/Hash.h"
+#include "osmium/osm/location.hpp"
+
+static const char MAGIC[8] = {'O', 'S', 'M', '2', 'R', 'D', 'F', 'N'};
+// Version 2 checksums the first block with FNV-1a instead of std::hash.
+static const uint32_t VERSION = 2;
+static const size_t CHECKSUM_BLOCK_S = 4 * 1024 * 1024;
+// Stored coordinates are xor this value, unset entries are zero.
+static const int32_t EMPTY = osmium::Location::undefined_coordinate;
+
+// ____________________________________________________________________________
+template <typename TId, typename TValue>
+osm2rdf::osm::PersistentLocationIndex<TId, TValue>::PersistentLocationIndex(
+    const std::filesystem::path& path, uint64_t checksum, size_t minNodeId,
+    size_t maxNodeId)
+    : _offset(minNodeId),
+      _size(maxNodeId >= minNodeId ? maxNodeId - minNodeId + 1 : 0) {
+  static_assert(sizeof(Header) == 64);
+  Header header{};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.checksum = checksum;
+  header.minNodeId = minNodeId;
+  header.maxNodeId = maxNodeId;
+  _mappedBytes = sizeof(Header) + _size * 2 * sizeof(int32_t);
+  if (!attach(path, header)) {
+    create(path, header);
+  }
+  _data = reinterpret_cast<int32_t*>(static_cast<char*>(_mapped) +
+                                     sizeof(Header));
+}
+
+// ____________________________________________________________________________
+template <typename TId, typename TValue>
+osm2rdf::osm::PersistentLocationIndex<TId,
+                                      TValue>::~PersistentLocationIndex() {
+  if (_mapped != nullptr) {
+    ::munmap(_mapped, _mappedBytes);
+  }
+  if (_fileDescriptor >= 0) {
+    ::close(_fileDescriptor);
+  }
+}
+
+// ____________________________________________________________________________
+template <typename TId, typename TValue>
+void osm2rdf::osm::PersistentLocationIndex<TId, TValue>::finish() {
+  if (_readOnly || _mapped == nullptr) {
+    return;
+  }
+  // Locations are written before the file is marked as complete.
+  ::msync(_mapped, _mappedBytes, MS_SYNC);
+  static_cast<Header*>(_mapped)->complete = 1;
+  ::msync(_mapped, _mappedBytes, MS_SYNC);
+}
+
+// ____________________________________________________________________________
+template <typename TId, typename TValue>
+bool osm2rdf::osm::PersistentLocationIndex<TId, TValue>::attach(
+    const std::filesystem::path& path, const Header& header) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return false;
+  }
+  Header existing{};
+  if (::pread(fd, &existing, sizeof(existing), 0) !=
+          static_cast<ssize_t>(sizeof(existing)) ||
+      std::memcmp(existing.magic, header.magic, sizeof(MAGIC)) != 0 ||
+      existing.version != header.version || existing.complete != 1 ||
+      existing.checksum != header.checksum ||
+      existing.minNodeId != header.minNodeId ||
+      existing.maxNodeId != header.maxNodeId ||
+      std::filesystem::file_size(path) != _mappedBytes) {
+    ::close(fd);
+    return false;
+  }
+  void* mapped = ::mmap(nullptr, _mappedBytes, PROT_READ, MAP_SHARED, fd, 0);
+  if (mapped == MAP_FAILED) {
+    ::close(fd);
+    return false;
+  }
+  _fileDescriptor = fd;
+  _mapped = mapped;
+  _readOnly = true;
+  return true;
+}
+
+// ____________________________________________________________________________
+template <typename TId, typename TValue>
+void osm2rdf::osm::PersistentLocationIndex<TId, TValue>::create(
+    const std::filesystem::path& path, const Header& header) {
+  const int RWRWRW = 0666;
+  _fileDescriptor = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, RWRWRW);
+  if (_fileDescriptor == -1) {
+    throw std::filesystem::filesystem_error(
+        "Can't open PersistentLocationIndex", std::filesystem::absolute(path),
+        std::error_code(errno, std::generic_category()));
+  }
+  // The file is sparse, unset entries are zero and need no initialization.
+  if (::ftruncate(_fileDescriptor, static_cast<off_t>(_mappedBytes)) != 0) {
+    throw std::filesystem::filesystem_error(
+        "Can't resize PersistentLocationIndex", std::filesystem::absolute(path),
+        std::error_code(errno, std::generic_category()));
+  }
+  _mapped = ::mmap(nullptr, _mappedBytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                   _fileDescriptor, 0);
+  if (_mapped == MAP_FAILED) {
+    _mapped = nullptr;
+    throw std::filesystem::filesystem_error(
+        "Can't map PersistentLocationIndex", std::filesystem::absolute(path),
+        std::error_code(errno, std::generic_category()));
+  }
+  std::memcpy(_mapped, &header, sizeof(header));
+}
+
+// ____________________________________________________________________________
+template <typename TId, typename TValue>
+void osm2rdf::osm::PersistentLocationIndex<TId, TValue>::set(
+    const TId id, const TValue value) {
+  if (_readOnly || id < _offset || id - _offset >= _size) {
+    return;
+  }
+  int32_t* entry = _data + 2 * (id - _offset);
+  entry[0] = value.x() ^ EMPTY;
+  entry[1] = value.y() ^ EMPTY;
+}
+
+// ____________________________________________________________________________
+template <typename TId, typename TValue>
+TValue osm2rdf::osm::PersistentLocationIndex<TId, TValue>::get_noexcept(
+    const TId id) const noexcept {
+  if (id < _offset || id - _offset >= _size) {
+    return osmium::index::empty_value<TValue>();
+  }
+  const int32_t* entry = _data + 2 * (id - _offset);
+  return TValue{entry[0] ^ EMPTY, entry[1] ^ EMPTY};
+}
+
+// ____________________________________________________________________________
+template <typename TId, typename TValue>
+TValue osm2rdf::osm::PersistentLocationIndex<TId, TValue>::get(
+    const TId id) const {
+  const auto value = get_noexcept(id);
+  if (value == osmium::index::empty_value<TValue>()) {
+    throw osmium::not_found{id};
+  }
+  return value;
+}
+
+// ____________________________________________________________________________
+template <typename TId, typename TValue>
+void osm2rdf::osm::PersistentLocationIndex<TId, TValue>::clear() {
+  if (_readOnly || _size == 0) {
+    return;
+  }
+  std::memset(_data, 0, _size * 2 * sizeof(int32_t));
+}
+
+// ____________________________________________________________________________
+template <typename TId, typename TValue>
+uint64_t osm2rdf::osm::PersistentLocationIndex<TId, TValue>::checksum(
+    const std::filesystem::path& path) {
+  std::ifstream in{path, std::ios::binary};
+  if (!in) {
+    throw std::filesystem::filesystem_error(
+        "Can't read file for checksum", std::filesystem::absolute(path),
+        std::make_error_code(std::errc::no_such_file_or_directory));
+  }
+  const uint64_t stat[2] = {
+      std::filesystem::file_size(path),
+      static_cast<uint64_t>(
+          std::filesystem::last_write_time(path).time_since_epoch().count())};
+  std::vector<char> block(CHECKSUM_BLOCK_S);
+  in.read(block.data(), block.size());
+  const auto count = static_cast<size_t>(in.gcount());
+  return osm2rdf::util::fnv1a(
+      std::string_view(block.data(), count),
+      osm2rdf::util::fnv1a(std::string_view(
+          reinterpret_cast<const char*>(stat), sizeof(stat))));
+}
+
+template class osm2rdf::osm::PersistentLocationIndex<
+    osmium::unsigned_object_id_type, osmium::Location>;
@@ -0,0 +1,51 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/ReferencedNodesHandler.h"
+
+// ____________________________________________________________________________
+void osm2rdf::osm::ReferencedNodesHandler::add(uint64_t nodeId) {
+  const uint64_t word = nodeId >> WORD_BITS;
+  if (word >= _bits.size()) {
+    // Grow by an eighth, the bitmap is close to its final size once the first
+    // ways arrive.
+    _bits.resize(word + 1 + (word >> 3U));
+  }
+  const uint64_t bit = uint64_t{1} << (nodeId & WORD_MASK);
+  if ((_bits[word] & bit) == 0) {
+    _bits[word] |= bit;
+    _size++;
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::ReferencedNodesHandler::relation(
+    const osmium::Relation& relation) {
+  for (const auto& member : relation.cmembers()) {
+    if (member.type() == osmium::item_type::node) {
+      add(member.positive_ref());
+    }
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::ReferencedNodesHandler::way(const osmium::Way& way) {
+  for (const auto& nodeRef : way.nodes()) {
+    add(nodeRef.positive_ref());
+  }
+}
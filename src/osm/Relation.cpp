@@ -136,9 +136,10 @@ const ::util::geo::DPoint osm2rdf::osm::Relation::centroid() const noexcept {
 void osm2rdf::osm::Relation::buildGeometry(
     osm2rdf::osm::RelationHandler& relationHandler) {
   _hasCompleteGeometry = true;
+  std::vector<uint64_t> nodeRefs;
   for (const auto& member : _members) {
     if (member.type() == RelationMemberType::WAY) {
-      const auto& nodeRefs = relationHandler.get_noderefs_of_way(member.id());
+      relationHandler.get_noderefs_of_way(member.id(), &nodeRefs);
       if (nodeRefs.empty()) {
         _hasCompleteGeometry = false;
       }
@@ -163,8 +164,17 @@ void osm2rdf::osm::Relation::buildGeometry(
         _hasCompleteGeometry = false;
       }
     } else if (member.type() == RelationMemberType::RELATION) {
-      // Mark relations containing relations as incomplete for now.
-      _hasCompleteGeometry = false;
+      // Member relations are built before their parents, relations without a
+      // stored geometry (e.g. in a cycle) stay incomplete.
+      const auto* memberGeom =
+          relationHandler.get_relation_geometry(member.id());
+      if (memberGeom == nullptr || !memberGeom->complete) {
+        _hasCompleteGeometry = false;
+      }
+      if (memberGeom != nullptr) {
+        _geom.insert(_geom.end(), memberGeom->geom.begin(),
+                     memberGeom->geom.end());
+      }
     }
   }
 
@@ -16,7 +16,9 @@
 // You should have received a copy of the GNU General Public License
 // along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <algorithm>
 #include <iostream>
+#include <queue>
 
 #include "osm2rdf/osm/RelationHandler.h"
 
@@ -30,6 +32,93 @@ osm2rdf::osm::RelationHandler::RelationHandler(
 // ____________________________________________________________________________
 void osm2rdf::osm::RelationHandler::prepare_for_lookup() {
   _firstPassDone = true;
+  std::sort(_wayIds.begin(), _wayIds.end());
+  _wayIds.erase(std::unique(_wayIds.begin(), _wayIds.end()), _wayIds.end());
+  _wayIds.shrink_to_fit();
+  _nodeRefRanges.resize(_wayIds.size());
+
+  // Assign levels in topological order of the relation member graph (Kahn's
+  // algorithm). Relations in a cycle, or containing one, never reach zero
+  // unresolved members and keep NO_NESTED_LEVEL.
+  const auto vertices = _relationGraph.getVertices();
+  std::unordered_map<uint64_t, size_t> unresolved;
+  std::unordered_map<uint64_t, std::vector<uint64_t>> parents;
+  std::queue<uint64_t> resolved;
+  for (const auto& vertex : vertices) {
+    const auto members = _relationGraph.getEdges(vertex);
+    unresolved[vertex] = members.size();
+    for (const auto& member : members) {
+      parents[member].push_back(vertex);
+    }
+  }
+  for (const auto& vertex : vertices) {
+    if (unresolved[vertex] == 0) {
+      _nestedLevels[vertex] = 0;
+      resolved.push(vertex);
+    }
+  }
+  while (!resolved.empty()) {
+    const uint64_t member = resolved.front();
+    resolved.pop();
+    const uint32_t level = _nestedLevels[member];
+    for (const auto& parent : parents[member]) {
+      auto& parentLevel = _nestedLevels[parent];
+      parentLevel = std::max(parentLevel, level + 1);
+      if (--unresolved[parent] == 0) {
+        resolved.push(parent);
+      }
+    }
+  }
+  for (auto it = _nestedLevels.begin(); it != _nestedLevels.end();) {
+    if (unresolved[it->first] != 0) {
+      it = _nestedLevels.erase(it);
+    } else {
+      // Reserve slots for member relations so geometries can be stored
+      // without locking.
+      if (parents.find(it->first) != parents.end()) {
+        _relationGeometries[it->first];
+      }
+      ++it;
+    }
+  }
+  _relationGraph = osm2rdf::util::DirectedGraph<uint64_t>{};
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::RelationHandler::merge(const RelationHandler& other) {
+  _wayIds.insert(_wayIds.end(), other._wayIds.begin(), other._wayIds.end());
+  for (const auto& vertex : other._relationGraph.getVertices()) {
+    for (const auto& member : other._relationGraph.getEdges(vertex)) {
+      _relationGraph.addEdge(vertex, member);
+    }
+  }
+}
+
+// ____________________________________________________________________________
+uint32_t osm2rdf::osm::RelationHandler::nestedLevel(
+    const uint64_t relationId) const {
+  const auto it = _nestedLevels.find(relationId);
+  return it == _nestedLevels.end() ? NO_NESTED_LEVEL : it->second;
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::RelationHandler::setRelationGeometry(
+    const uint64_t relationId, const ::util::geo::DCollection& geom,
+    bool complete) {
+  const auto it = _relationGeometries.find(relationId);
+  if (it == _relationGeometries.end()) {
+    return;
+  }
+  it->second.geom = geom;
+  it->second.complete = complete;
+}
+
+// ____________________________________________________________________________
+const osm2rdf::osm::RelationGeometry*
+osm2rdf::osm::RelationHandler::get_relation_geometry(
+    const uint64_t relationId) const {
+  const auto it = _relationGeometries.find(relationId);
+  return it == _relationGeometries.end() ? nullptr : &it->second;
 }
 
 // ____________________________________________________________________________
@@ -50,35 +139,37 @@ osmium::Location osm2rdf::osm::RelationHandler::get_node_location(
 }
 
 // ____________________________________________________________________________
-std::vector<uint64_t> osm2rdf::osm::RelationHandler::getNodeRefs(
-    const std::vector<uint32_t>& refs) const {
-  std::vector<uint64_t> ret;
-  ret.reserve(refs.size());
-
-  for (size_t i = 0; i < refs.size(); i++) {
-    if (refs[i] >> 31 == 0) {
-      ret.push_back(refs[i]);
-    } else {
-      uint64_t fullId;
-
-      fullId = static_cast<uint64_t>(refs[i] << 1 >> 1) << 32;
-      fullId += refs[i + 1];
-
-      ret.push_back(fullId);
-      i++;
-    }
-  }
-
-  return ret;
+std::vector<uint64_t> osm2rdf::osm::RelationHandler::get_noderefs_of_way(
+    const uint64_t wayId) const {
+  std::vector<uint64_t> nodeRefs;
+  get_noderefs_of_way(wayId, &nodeRefs);
+  return nodeRefs;
 }
 
 // ____________________________________________________________________________
-std::vector<uint64_t> osm2rdf::osm::RelationHandler::get_noderefs_of_way(
-    const uint64_t wayId) {
-  if (wayId > std::numeric_limits<uint32_t>::max()) {
-    return getNodeRefs(_ways64[wayId]);
-  } else {
-    return getNodeRefs(_ways32[wayId]);
+void osm2rdf::osm::RelationHandler::get_noderefs_of_way(
+    const uint64_t wayId, std::vector<uint64_t>* nodeRefs) const {
+  nodeRefs->clear();
+  const auto it = std::lower_bound(_wayIds.begin(), _wayIds.end(), wayId);
+  if (it == _wayIds.end() || *it != wayId) {
+    return;
+  }
+  const auto& range = _nodeRefRanges[it - _wayIds.begin()];
+  const uint8_t* pos = _nodeRefs.data() + range.begin;
+  const uint8_t* end = _nodeRefs.data() + range.end;
+  uint64_t nodeRef = 0;
+  while (pos < end) {
+    uint64_t delta = 0;
+    for (int shift = 0;; shift += 7) {
+      const uint8_t b = *pos++;
+      delta |= static_cast<uint64_t>(b & 0x7FU) << shift;
+      if ((b & 0x80U) == 0) {
+        break;
+      }
+    }
+    // Undo the zigzag encoding.
+    nodeRef += (delta >> 1U) ^ -(delta & 1U);
+    nodeRefs->push_back(nodeRef);
   }
 }
 
@@ -98,41 +189,21 @@ void osm2rdf::osm::RelationHandler::relation(const osmium::Relation& relation) {
 
   for (const auto& relationMember : relation.cmembers()) {
     if (relationMember.type() == osmium::item_type::way) {
-      if (relationMember.positive_ref() >
-          std::numeric_limits<uint32_t>::max()) {
-        _ways64[relationMember.positive_ref()] = {};
-      } else {
-        _ways32[relationMember.positive_ref()] = {};
-      }
+      _wayIds.push_back(relationMember.positive_ref());
+    } else if (relationMember.type() == osmium::item_type::relation) {
+      _relationGraph.addEdge(relation.positive_id(),
+                             relationMember.positive_ref());
     }
   }
 }
 
 // ____________________________________________________________________________
-std::vector<uint32_t> osm2rdf::osm::RelationHandler::getCompressedIDs(
-    const osmium::Way& way) const {
-  std::vector<uint32_t> compressed;
-  compressed.reserve(way.nodes().size() / 2);
-
-  for (const auto& nodeRef : way.nodes()) {
-    size_t nid = nodeRef.positive_ref();
-    if (nid <= std::numeric_limits<int32_t>::max()) {
-      // handle normally
-      compressed.push_back(nid);
-    } else if (nid <=
-               (static_cast<size_t>(std::numeric_limits<int64_t>::max()))) {
-      // handle with continuation
-      int32_t lower = nid << 32 >> 32;
-      int32_t upper = nid >> 32;
-      upper = upper | (1 << 31);
-      compressed.push_back(upper);
-      compressed.push_back(lower);
-    } else {
-      throw std::out_of_range("Node ID is too large");
-    }
+void osm2rdf::osm::RelationHandler::appendVarint(uint64_t value) {
+  while (value > 0x7FU) {
+    _nodeRefs.push_back(static_cast<uint8_t>((value & 0x7FU) | 0x80U));
+    value >>= 7U;
   }
-
-  return compressed;
+  _nodeRefs.push_back(static_cast<uint8_t>(value));
 }
 
 // ____________________________________________________________________________
@@ -141,13 +212,19 @@ void osm2rdf::osm::RelationHandler::way(const osmium::Way& way) {
     return;
   }
 
-  if (way.positive_id() > std::numeric_limits<uint32_t>::max()) {
-    if (_ways64.find(way.positive_id()) != _ways64.end()) {
-      _ways64[way.positive_id()] = std::move(getCompressedIDs(way));
-    }
-  } else {
-    if (_ways32.find(way.positive_id()) != _ways32.end()) {
-      _ways32[way.positive_id()] = std::move(getCompressedIDs(way));
-    }
+  const auto it =
+      std::lower_bound(_wayIds.begin(), _wayIds.end(), way.positive_id());
+  if (it == _wayIds.end() || *it != way.positive_id()) {
+    return;
+  }
+  auto& range = _nodeRefRanges[it - _wayIds.begin()];
+  range.begin = _nodeRefs.size();
+  uint64_t previous = 0;
+  for (const auto& nodeRef : way.nodes()) {
+    const auto delta = static_cast<int64_t>(nodeRef.positive_ref() - previous);
+    appendVarint((static_cast<uint64_t>(delta) << 1U) ^
+                 static_cast<uint64_t>(delta >> 63));
+    previous = nodeRef.positive_ref();
   }
+  range.end = _nodeRefs.size();
 }
@@ -0,0 +1,157 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/WayNodeJoin.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "osmium/io/any_input.hpp"
+#include "osmium/io/reader_with_progress_bar.hpp"
+#include "osmium/osm/node.hpp"
+
+// Records kept in memory by each sorter, 512 MiB.
+static const size_t SORT_RECORDS = size_t{1} << 25U;
+// Sorts after all node IDs, used for refs which are never found.
+static const uint64_t NO_NODE = std::numeric_limits<uint64_t>::max();
+
+// ____________________________________________________________________________
+static uint64_t pack(const osmium::Location& location) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(location.x())) << 32U) |
+         static_cast<uint32_t>(location.y());
+}
+
+// ____________________________________________________________________________
+static osmium::Location unpack(uint64_t value) {
+  return osmium::Location{static_cast<int32_t>(value >> 32U),
+                          static_cast<int32_t>(value & 0xFFFFFFFFU)};
+}
+
+// ____________________________________________________________________________
+osm2rdf::osm::WayNodeJoin::WayNodeJoin(const osm2rdf::config::Config& config)
+    : _config(config),
+      _refsByNode(std::make_unique<osm2rdf::util::ExternalSorter>(
+          config.getTempPath("osmium", "join.refs"), SORT_RECORDS)),
+      _locationsByRef(std::make_unique<osm2rdf::util::ExternalSorter>(
+          config.getTempPath("osmium", "join.locations"), SORT_RECORDS)) {}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::WayNodeJoin::relation(const osmium::Relation& relation) {
+  // Area relations are assembled from their ways, as in RelationHandler.
+  for (const auto& tag : relation.tags()) {
+    if (strcmp(tag.key(), "type") == 0 &&
+        (strcmp(tag.value(), "multipolygon") == 0 ||
+         strcmp(tag.value(), "boundary") == 0)) {
+      return;
+    }
+  }
+  for (const auto& member : relation.cmembers()) {
+    if (member.type() == osmium::item_type::node) {
+      _relationNodes.push_back(member.positive_ref());
+    } else if (member.type() == osmium::item_type::way) {
+      _relationWays.push_back(member.positive_ref());
+    }
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::WayNodeJoin::way(const osmium::Way& way) {
+  for (const auto& nodeRef : way.nodes()) {
+    _refsByNode->add(nodeRef.ref() < 0 ? NO_NODE : nodeRef.positive_ref(),
+                     _numRefs++);
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::WayNodeJoin::join() {
+  for (auto* ids : {&_relationNodes, &_relationWays}) {
+    std::sort(ids->begin(), ids->end());
+    ids->erase(std::unique(ids->begin(), ids->end()), ids->end());
+  }
+  _refsByNode->finish();
+
+  osm2rdf::util::ExternalSorter::Record ref{};
+  bool hasRef = _refsByNode->next(&ref);
+  auto relationNode = _relationNodes.begin();
+  uint64_t lastId = 0;
+  osmium::io::ReaderWithProgressBar reader{true, osmium::io::File{_config.input},
+                                           osmium::osm_entity_bits::node};
+  while (auto buf = reader.read()) {
+    for (const auto& node : buf.select<osmium::Node>()) {
+      if (node.id() < 0) {
+        continue;
+      }
+      const uint64_t id = node.positive_id();
+      if (id < lastId) {
+        throw std::runtime_error(
+            "Joining way nodes needs input sorted by node ID");
+      }
+      lastId = id;
+      // Refs to nodes missing in the input get an undefined location.
+      for (; hasRef && ref.key < id; hasRef = _refsByNode->next(&ref)) {
+        _locationsByRef->add(ref.value, pack(osmium::Location{}));
+      }
+      for (; hasRef && ref.key == id; hasRef = _refsByNode->next(&ref)) {
+        _locationsByRef->add(ref.value, pack(node.location()));
+      }
+      while (relationNode != _relationNodes.end() && *relationNode < id) {
+        ++relationNode;
+      }
+      if (relationNode != _relationNodes.end() && *relationNode == id) {
+        _relationLocations[id] = node.location();
+      }
+    }
+  }
+  reader.close();
+  for (; hasRef; hasRef = _refsByNode->next(&ref)) {
+    _locationsByRef->add(ref.value, pack(osmium::Location{}));
+  }
+  // Removes the runs of the first sort.
+  _refsByNode.reset();
+  _locationsByRef->finish();
+}
+
+// ____________________________________________________________________________
+void osm2rdf::osm::WayNodeJoin::fill(osmium::Way& way) {
+  const bool relationWay = std::binary_search(
+      _relationWays.begin(), _relationWays.end(), way.positive_id());
+  osm2rdf::util::ExternalSorter::Record record{};
+  for (auto& nodeRef : way.nodes()) {
+    if (!_locationsByRef->next(&record) || record.key != _nextRef) {
+      throw std::runtime_error("Ways differ from the first pass");
+    }
+    _nextRef++;
+    const osmium::Location location = unpack(record.value);
+    nodeRef.set_location(location);
+    if (relationWay && nodeRef.ref() >= 0 && location.valid()) {
+      _relationLocations[nodeRef.positive_ref()] = location;
+    }
+  }
+}
+
+// ____________________________________________________________________________
+osmium::Location osm2rdf::osm::WayNodeJoin::get_node_location(
+    uint64_t nodeId) const {
+  const auto it = _relationLocations.find(nodeId);
+  if (it == _relationLocations.end()) {
+    return osmium::Location{};
+  }
+  return it->second;
+}
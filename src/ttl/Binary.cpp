@@ -0,0 +1,221 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/ttl/Binary.h"
+
+#include <cassert>
+#include <functional>
+#include <stdexcept>
+
+static const int VARINT_BITS = 7;
+static const uint8_t VARINT_MASK = 0x7F;
+static const uint8_t VARINT_MORE = 0x80;
+static const int UINT32_BYTES = 4;
+static const int NUM_BITS_IN_BYTE = 8;
+static const uint32_t BYTE_MASK = 0xFF;
+
+// ____________________________________________________________________________
+void osm2rdf::ttl::binary::writeHeader(std::string* out) {
+  out->append(MAGIC);
+  out->push_back(static_cast<char>(VERSION));
+  out->push_back(static_cast<char>(SLOT_BITS));
+}
+
+// ____________________________________________________________________________
+osm2rdf::ttl::binary::Encoder::Encoder(size_t part)
+    : _slots(1U << SLOT_BITS) {
+  // Encode the part number once, it prefixes each record.
+  _records.clear();
+  writeVarint(part);
+  _part = _records;
+  _records.clear();
+}
+
+// ____________________________________________________________________________
+void osm2rdf::ttl::binary::Encoder::endTerm() {
+  assert(_numEnds < 2);
+  _ends[_numEnds++] = _terms.size();
+}
+
+// ____________________________________________________________________________
+std::string_view osm2rdf::ttl::binary::Encoder::encodeTriple() {
+  assert(_numEnds == 2);
+  std::string_view terms{_terms};
+  encodeTriple(terms.substr(0, _ends[0]),
+               terms.substr(_ends[0], _ends[1] - _ends[0]),
+               terms.substr(_ends[1]));
+  _terms.clear();
+  _numEnds = 0;
+  return _records;
+}
+
+// ____________________________________________________________________________
+std::string_view osm2rdf::ttl::binary::Encoder::encodeTriple(
+    std::string_view s, std::string_view p, std::string_view o) {
+  _records.clear();
+  _ids[0] = lookup(s, 0);
+  _ids[1] = lookup(p, 1);
+  _ids[2] = lookup(o, 2);
+  _records.push_back(TRIPLE);
+  _records.append(_part);
+  for (const auto id : _ids) {
+    writeUint32(id);
+  }
+  return _records;
+}
+
+// ____________________________________________________________________________
+uint32_t osm2rdf::ttl::binary::Encoder::lookup(std::string_view t,
+                                               uint32_t position) {
+  uint32_t slot = position;
+  if (t.size() <= MAX_CACHED_TERM_LENGTH) {
+    uint32_t cached =
+        SCRATCH_SLOTS + std::hash<std::string_view>{}(t) %
+                            (_slots.size() - SCRATCH_SLOTS);
+    if (_slots[cached] == t && !t.empty()) {
+      return cached;
+    }
+    // Never replace a term used earlier in the same triple.
+    bool used = false;
+    for (uint32_t i = 0; i < position; ++i) {
+      used |= _ids[i] == cached;
+    }
+    if (!used) {
+      _slots[cached].assign(t);
+      slot = cached;
+    }
+  }
+  _records.push_back(DEFINE);
+  _records.append(_part);
+  writeUint32(slot);
+  writeVarint(t.size());
+  _records.append(t);
+  return slot;
+}
+
+// ____________________________________________________________________________
+void osm2rdf::ttl::binary::Encoder::writeVarint(uint64_t v) {
+  while (v > VARINT_MASK) {
+    _records.push_back(static_cast<char>((v & VARINT_MASK) | VARINT_MORE));
+    v >>= VARINT_BITS;
+  }
+  _records.push_back(static_cast<char>(v));
+}
+
+// ____________________________________________________________________________
+void osm2rdf::ttl::binary::Encoder::writeUint32(uint32_t v) {
+  for (int i = 0; i < UINT32_BYTES; ++i) {
+    _records.push_back(static_cast<char>(v & BYTE_MASK));
+    v >>= NUM_BITS_IN_BYTE;
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::ttl::binary::Decoder::decode(std::istream& in,
+                                           std::ostream& out) {
+  std::string magic(MAGIC.size() - 1, '\0');
+  int type;
+  while ((type = in.get()) != std::istream::traits_type::eof()) {
+    if (type == MAGIC[0]) {
+      in.read(magic.data(), static_cast<std::streamsize>(magic.size()));
+      if (!in || magic != MAGIC.substr(1)) {
+        throw std::runtime_error("Invalid binary header");
+      }
+      const int version = in.get();
+      const int slotBits = in.get();
+      if (version != VERSION || slotBits <= 0 || slotBits > MAX_SLOT_BITS ||
+          (_slotBits != 0 && _slotBits != slotBits)) {
+        throw std::runtime_error("Unsupported binary version " +
+                                 std::to_string(version));
+      }
+      _slotBits = static_cast<uint8_t>(slotBits);
+      continue;
+    }
+    if (_slotBits == 0) {
+      throw std::runtime_error("Missing binary header");
+    }
+    auto& slots = table(readVarint(in));
+    if (type == DEFINE) {
+      uint32_t slot = readUint32(in);
+      uint64_t length = readVarint(in);
+      if (slot >= slots.size()) {
+        throw std::runtime_error("Invalid slot " + std::to_string(slot));
+      }
+      slots[slot].resize(length);
+      in.read(slots[slot].data(), static_cast<std::streamsize>(length));
+      if (!in) {
+        throw std::runtime_error("Unexpected end of binary stream");
+      }
+    } else if (type == TRIPLE) {
+      for (int i = 0; i < 3; ++i) {
+        uint32_t slot = readUint32(in);
+        if (slot >= slots.size() || slots[slot].empty()) {
+          throw std::runtime_error("Undefined slot " + std::to_string(slot));
+        }
+        out << slots[slot] << (i < 2 ? " " : " .\n");
+      }
+    } else {
+      throw std::runtime_error("Unknown binary record type " +
+                               std::to_string(type));
+    }
+  }
+}
+
+// ____________________________________________________________________________
+uint64_t osm2rdf::ttl::binary::Decoder::readVarint(std::istream& in) {
+  uint64_t v = 0;
+  for (int shift = 0; shift < 64; shift += VARINT_BITS) {
+    int c = in.get();
+    if (c == std::istream::traits_type::eof()) {
+      throw std::runtime_error("Unexpected end of binary stream");
+    }
+    v |= static_cast<uint64_t>(c & VARINT_MASK) << shift;
+    if ((c & VARINT_MORE) == 0) {
+      return v;
+    }
+  }
+  throw std::runtime_error("Invalid varint in binary stream");
+}
+
+// ____________________________________________________________________________
+uint32_t osm2rdf::ttl::binary::Decoder::readUint32(std::istream& in) {
+  unsigned char bytes[UINT32_BYTES];
+  in.read(reinterpret_cast<char*>(bytes), UINT32_BYTES);
+  if (!in) {
+    throw std::runtime_error("Unexpected end of binary stream");
+  }
+  uint32_t v = 0;
+  for (int i = UINT32_BYTES - 1; i >= 0; --i) {
+    v = (v << NUM_BITS_IN_BYTE) | bytes[i];
+  }
+  return v;
+}
+
+// ____________________________________________________________________________
+std::vector<std::string>& osm2rdf::ttl::binary::Decoder::table(uint64_t part) {
+  if (part >= MAX_PARTS) {
+    throw std::runtime_error("Invalid part " + std::to_string(part));
+  }
+  if (part >= _tables.size()) {
+    _tables.resize(part + 1);
+  }
+  if (_tables[part].empty()) {
+    _tables[part].resize(uint64_t{1} << _slotBits);
+  }
+  return _tables[part];
+}
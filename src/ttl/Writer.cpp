@@ -18,10 +18,14 @@
 // along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <algorithm>
-#include <iomanip>
+#include <cassert>
+#include <charconv>
+#include <cstdio>
+#include <functional>
 #include <iostream>
 #include <string>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
 #include "osm2rdf/ttl/Writer.h"
@@ -30,8 +34,18 @@
 #endif
 #include "osm2rdf/config/Config.h"
 #include "osm2rdf/ttl/Constants.h"
+#include "osm2rdf/util/Hash.h"
+#include "osm2rdf/util/Simd.h"
 #include "osmium/osm/item_type.hpp"
 
+// Maximal number of decimal digits of an (u)int64_t including the sign.
+static const int UINT64_DIGITS = 20;
+// Buffer size for doubles formatted with %f, larger values fall back to
+// std::to_string.
+static const int DOUBLE_CHARS = 64;
+// Lowercase hex digits used by UCHAR and PERCENT.
+static const char HEX_DIGITS[] = "0123456789abcdef";
+
 // ____________________________________________________________________________
 template <typename T>
 osm2rdf::ttl::Writer<T>::Writer(const osm2rdf::config::Config& config,
@@ -132,6 +146,10 @@ osm2rdf::ttl::Writer<T>::Writer(const osm2rdf::config::Config& config,
       generateIRI(osm2rdf::ttl::constants::NAMESPACE__OSM2RDF_GEOM, "envelope");
   osm2rdf::ttl::constants::IRI__OSM2RDF__LENGTH =
       generateIRI(osm2rdf::ttl::constants::NAMESPACE__OSM2RDF, "length");
+  osm2rdf::ttl::constants::IRI__OSM2RDF__AREA =
+      generateIRI(osm2rdf::ttl::constants::NAMESPACE__OSM2RDF, "area");
+  osm2rdf::ttl::constants::IRI__OSM2RDF__COMPLETE_GEOMETRY = generateIRI(
+      osm2rdf::ttl::constants::NAMESPACE__OSM2RDF, "completeGeometry");
   osm2rdf::ttl::constants::IRI__OSM2RDF_GEOM__OBB =
       generateIRI(osm2rdf::ttl::constants::NAMESPACE__OSM2RDF_GEOM, "obb");
   osm2rdf::ttl::constants::IRI__OSM2RDF_MEMBER__ID =
@@ -174,6 +192,12 @@ osm2rdf::ttl::Writer<T>::Writer(const osm2rdf::config::Config& config,
       generateIRI(osm2rdf::ttl::constants::NAMESPACE__OSM, "tag");
   osm2rdf::ttl::constants::IRI__OSM_WAY =
       generateIRI(osm2rdf::ttl::constants::NAMESPACE__OSM, "way");
+  osm2rdf::ttl::constants::IRI__OSMREL_MEMBER =
+      generateIRI(osm2rdf::ttl::constants::NAMESPACE__OSM_RELATION, "member");
+  osm2rdf::ttl::constants::IRI__OSMKEY_KEY =
+      generateIRI(osm2rdf::ttl::constants::NAMESPACE__OSM_TAG, "key");
+  osm2rdf::ttl::constants::IRI__OSMKEY_VALUE =
+      generateIRI(osm2rdf::ttl::constants::NAMESPACE__OSM_TAG, "value");
   osm2rdf::ttl::constants::IRI__RDF_TYPE =
       generateIRI(osm2rdf::ttl::constants::NAMESPACE__RDF, "type");
   osm2rdf::ttl::constants::IRI__OSM2RDF_FACTS =
@@ -198,6 +222,23 @@ osm2rdf::ttl::Writer<T>::Writer(const osm2rdf::config::Config& config,
   osm2rdf::ttl::constants::IRI__XSD_YEAR_MONTH =
       generateIRI(osm2rdf::ttl::constants::NAMESPACE__XML_SCHEMA, "gYearMonth");
 
+  osm2rdf::ttl::constants::LITERAL_SUFFIX__GEOSPARQL__WKT_LITERAL =
+      "^^" + osm2rdf::ttl::constants::IRI__GEOSPARQL__WKT_LITERAL;
+  osm2rdf::ttl::constants::LITERAL_SUFFIX__XSD_DATE =
+      "^^" + osm2rdf::ttl::constants::IRI__XSD_DATE;
+  osm2rdf::ttl::constants::LITERAL_SUFFIX__XSD_DATE_TIME =
+      "^^" + osm2rdf::ttl::constants::IRI__XSD_DATE_TIME;
+  osm2rdf::ttl::constants::LITERAL_SUFFIX__XSD_DECIMAL =
+      "^^" + osm2rdf::ttl::constants::IRI__XSD_DECIMAL;
+  osm2rdf::ttl::constants::LITERAL_SUFFIX__XSD_DOUBLE =
+      "^^" + osm2rdf::ttl::constants::IRI__XSD_DOUBLE;
+  osm2rdf::ttl::constants::LITERAL_SUFFIX__XSD_INTEGER =
+      "^^" + osm2rdf::ttl::constants::IRI__XSD_INTEGER;
+  osm2rdf::ttl::constants::LITERAL_SUFFIX__XSD_YEAR =
+      "^^" + osm2rdf::ttl::constants::IRI__XSD_YEAR;
+  osm2rdf::ttl::constants::LITERAL_SUFFIX__XSD_YEAR_MONTH =
+      "^^" + osm2rdf::ttl::constants::IRI__XSD_YEAR_MONTH;
+
   osm2rdf::ttl::constants::LITERAL__FALSE =
       generateLiteral("false", "^^" + osm2rdf::ttl::constants::IRI__XSD_BOOLEAN);
   osm2rdf::ttl::constants::LITERAL__TRUE =
@@ -205,14 +246,19 @@ osm2rdf::ttl::Writer<T>::Writer(const osm2rdf::config::Config& config,
 
   // Prepare statistic variables
   _numOuts = config.numThreads + 1;
+  _numShards = std::max(config.outputShards, 1);
   _blankNodeCount = new uint64_t[_numOuts];
-  _headerLines = new uint64_t[_numOuts];
-  _lineCount = new uint64_t[_numOuts];
+  // Lines are counted per output part, which gives the counts per shard.
+  _headerLines = new uint64_t[_numOuts * _numShards];
+  _lineCount = new uint64_t[_numOuts * _numShards];
   for (size_t i = 0; i < _numOuts; ++i) {
     _blankNodeCount[i] = 0;
+  }
+  for (size_t i = 0; i < _numOuts * _numShards; ++i) {
     _headerLines[i] = 0;
     _lineCount[i] = 0;
   }
+  initParts();
 }
 
 // ____________________________________________________________________________
@@ -251,12 +297,20 @@ void osm2rdf::ttl::Writer<T>::writeStatisticJson(
     const std::filesystem::path& output) {
   // Combine data from threads.
   uint64_t blankNodeCount = 0;
-  uint64_t headerLines = 0;
-  uint64_t lineCount = 0;
   for (size_t i = 0; i < _numOuts; ++i) {
     blankNodeCount += _blankNodeCount[i];
-    headerLines += _headerLines[i];
-    lineCount += _lineCount[i];
+  }
+  std::vector<uint64_t> shardHeaderLines(_numShards, 0);
+  std::vector<uint64_t> shardLineCount(_numShards, 0);
+  for (size_t i = 0; i < _numOuts * _numShards; ++i) {
+    shardHeaderLines[i / _numOuts] += _headerLines[i];
+    shardLineCount[i / _numOuts] += _lineCount[i];
+  }
+  uint64_t headerLines = 0;
+  uint64_t lineCount = 0;
+  for (size_t i = 0; i < _numShards; ++i) {
+    headerLines += shardHeaderLines[i];
+    lineCount += shardLineCount[i];
   }
 
   // Write json
@@ -265,7 +319,20 @@ void osm2rdf::ttl::Writer<T>::writeStatisticJson(
   out << "  \"blankNodes\": " << blankNodeCount << "," << std::endl;
   out << "  \"header\": " << headerLines << "," << std::endl;
   out << "  \"lines\": " << lineCount << "," << std::endl;
-  out << "  \"triples\": " << lineCount - headerLines << std::endl;
+  out << "  \"triples\": " << lineCount - headerLines;
+  if (_numShards > 1) {
+    // Each shard repeats the header.
+    out << "," << std::endl;
+    out << "  \"shards\": [" << std::endl;
+    for (size_t i = 0; i < _numShards; ++i) {
+      out << "    {\"header\": " << shardHeaderLines[i]
+          << ", \"lines\": " << shardLineCount[i]
+          << ", \"triples\": " << shardLineCount[i] - shardHeaderLines[i]
+          << "}" << (i + 1 < _numShards ? "," : "") << std::endl;
+    }
+    out << "  ]";
+  }
+  out << std::endl;
   out << "}" << std::endl;
   out.close();
 }
@@ -273,17 +340,53 @@ void osm2rdf::ttl::Writer<T>::writeStatisticJson(
 // ____________________________________________________________________________
 template <typename T>
 void osm2rdf::ttl::Writer<T>::writeHeader() {
-  for (const auto& [prefix, iriref] : _prefixes) {
-    writeTriple("@prefix", prefix + ":", "<" + iriref + ">", 0);
-    _headerLines[0]++;
+  // Written directly, prefix declarations are never grouped. Each shard
+  // starts with all prefixes.
+  for (size_t shard = 0; shard < _numShards; ++shard) {
+    const size_t part = shard * _numOuts;
+    for (const auto& [prefix, iriref] : _prefixes) {
+      _out->write("@prefix ", part);
+      _out->write(prefix, part);
+      _out->write(": <", part);
+      _out->write(iriref, part);
+      _out->write("> .", part);
+      _out->writeNewLine(part);
+      _lineCount[part]++;
+      _headerLines[part]++;
+    }
   }
   _out->flush();
 }
 
+// ____________________________________________________________________________
+template <typename T>
+void osm2rdf::ttl::Writer<T>::closeGroups() {
+  for (size_t i = 0; i < _groups.size(); ++i) {
+    if (_groups[i].open) {
+      _out->write(" .", i);
+      _out->writeNewLine(i);
+      _groups[i].open = false;
+    }
+  }
+}
+
 // ____________________________________________________________________________
 template <>
 void osm2rdf::ttl::Writer<osm2rdf::ttl::format::NT>::writeHeader() {}
 
+// ____________________________________________________________________________
+template <>
+void osm2rdf::ttl::Writer<osm2rdf::ttl::format::BINARY>::writeHeader() {
+  // Each part starts with a header, parts can be decoded on their own.
+  std::string header;
+  osm2rdf::ttl::binary::writeHeader(&header);
+  for (size_t i = 0; i < _encoders.size(); ++i) {
+    _out->write(header, i);
+    _out->endRecord(i);
+  }
+  _out->flush();
+}
+
 // ____________________________________________________________________________
 template <typename T>
 std::string osm2rdf::ttl::Writer<T>::generateBlankNode() {
@@ -299,7 +402,9 @@ std::string osm2rdf::ttl::Writer<T>::generateBlankNode() {
 template <typename T>
 void osm2rdf::ttl::Writer<T>::writeIRI(std::string_view p, uint64_t v,
                                        size_t part) {
-  writeIRIUnsafe(p, std::to_string(v), part);
+  char buf[UINT64_DIGITS];
+  char* end = std::to_chars(buf, buf + sizeof(buf), v).ptr;
+  writeIRIUnsafe(p, std::string_view(buf, end - buf), part);
 }
 
 // ____________________________________________________________________________
@@ -392,26 +497,31 @@ void osm2rdf::ttl::Writer<T>::writeLiteral(std::string_view v, size_t part) {
   //      https://www.w3.org/TR/n-triples/#grammar-production-STRING_LITERAL_QUOTE
   // TTL: [22]  STRING_LITERAL_QUOTE
   //      https://www.w3.org/TR/turtle/#grammar-production-STRING_LITERAL_QUOTE
-  _out->write('"', part);
-  for (const auto c : v) {
-    switch (c) {
+  put('"', part);
+  for (size_t pos = 0; pos < v.size(); ++pos) {
+    // Write all chars not requiring escaping at once
+    size_t clean = osm2rdf::util::simd::findLiteralEscape(v.substr(pos));
+    put(v.substr(pos, clean), part);
+    pos += clean;
+    if (pos >= v.size()) {
+      break;
+    }
+    switch (v[pos]) {
       case '\"':  // #x22
-        _out->write("\\\"", part);
+        put("\\\"", part);
         break;
       case '\\':  // #x5C
-        _out->write("\\\\", part);
+        put("\\\\", part);
         break;
       case '\n':  // #x0A
-        _out->write("\\n", part);
+        put("\\n", part);
         break;
       case '\r':  // #x0D
-        _out->write("\\r", part);
+        put("\\r", part);
         break;
-      default:
-        _out->write(c, part);
     }
   }
-  _out->write('"', part);
+  put('"', part);
 }
 
 // ____________________________________________________________________________
@@ -420,10 +530,33 @@ void osm2rdf::ttl::Writer<T>::writeLiteralUnsafe(std::string_view v,
                                                  std::string_view s,
                                                  size_t part) {
   // only put literal in quotes
-  _out->write('"', part);
-  _out->write(v, part);
-  _out->write('"', part);
-  _out->write(s, part);
+  put('"', part);
+  put(v, part);
+  put('"', part);
+  put(s, part);
+}
+
+// ____________________________________________________________________________
+template <typename T>
+void osm2rdf::ttl::Writer<T>::writeIntegerLiteral(int64_t v, std::string_view s,
+                                                  size_t part) {
+  char buf[UINT64_DIGITS];
+  char* end = std::to_chars(buf, buf + sizeof(buf), v).ptr;
+  writeLiteralUnsafe(std::string_view(buf, end - buf), s, part);
+}
+
+// ____________________________________________________________________________
+template <typename T>
+void osm2rdf::ttl::Writer<T>::writeDoubleLiteral(double v, std::string_view s,
+                                                 size_t part) {
+  // Same format as std::to_string(double)
+  char buf[DOUBLE_CHARS];
+  int len = snprintf(buf, sizeof(buf), "%f", v);
+  if (len < 0 || len >= DOUBLE_CHARS) {
+    writeLiteralUnsafe(std::to_string(v), s, part);
+    return;
+  }
+  writeLiteralUnsafe(std::string_view(buf, len), s, part);
 }
 
 // ____________________________________________________________________________
@@ -477,14 +610,12 @@ void osm2rdf::ttl::Writer<T>::writeUnsafeIRILiteralTriple(const std::string& s,
                                                           const std::string& v,
                                                           const std::string& o,
                                                           size_t part) {
-  _out->write(s, part);
-  _out->write(' ', part);
+  put(s, part);
+  writeSeparator(part);
   writeIRIUnsafe(p, v, part);
-  _out->write(' ', part);
+  writeSeparator(part);
   writeLiteral(o, part);
-  _out->write(" .", part);
-  _out->writeNewLine(part);
-  _lineCount[part]++;
+  writeTripleEnd(part);
 }
 
 // ____________________________________________________________________________
@@ -511,14 +642,12 @@ void osm2rdf::ttl::Writer<T>::writeIRILiteralTriple(const std::string& s,
                                                     const std::string& v,
                                                     const std::string& o,
                                                     size_t part) {
-  _out->write(s, part);
-  _out->write(' ', part);
+  put(s, part);
+  writeSeparator(part);
   writeIRI(p, v, part);
-  _out->write(' ', part);
+  writeSeparator(part);
   writeLiteral(o, part);
-  _out->write(" .", part);
-  _out->writeNewLine(part);
-  _lineCount[part]++;
+  writeTripleEnd(part);
 }
 
 // ____________________________________________________________________________
@@ -542,14 +671,16 @@ template <typename T>
 void osm2rdf::ttl::Writer<T>::writeTriple(const std::string& s,
                                           const std::string& p,
                                           const std::string& o, size_t part) {
-  _out->write(s, part);
-  _out->write(' ', part);
-  _out->write(p, part);
-  _out->write(' ', part);
-  _out->write(o, part);
-  _out->write(" .", part);
-  _out->writeNewLine(part);
-  _lineCount[part]++;
+  if (!_pending.empty()) {
+    writeTerms(s, p, o, part);
+    return;
+  }
+  put(s, part);
+  writeSeparator(part);
+  put(p, part);
+  writeSeparator(part);
+  put(o, part);
+  writeTripleEnd(part);
 }
 
 // ____________________________________________________________________________
@@ -575,21 +706,349 @@ void osm2rdf::ttl::Writer<T>::writeLiteralTripleUnsafe(const std::string& s,
                                                        const std::string& a,
                                                        const std::string& b,
                                                        size_t part) {
+  put(s, part);
+  writeSeparator(part);
+  put(p, part);
+  writeSeparator(part);
+
+  put('"', part);
+  put(a, part);
+  put('"', part);
+  put(b, part);
+
+  writeTripleEnd(part);
+}
+
+// ____________________________________________________________________________
+template <typename T>
+void osm2rdf::ttl::Writer<T>::put(std::string_view s, size_t part) {
+  if (!_pending.empty()) {
+    _pending[part].terms.append(s);
+    return;
+  }
   _out->write(s, part);
-  _out->write(' ', part);
-  _out->write(p, part);
-  _out->write(' ', part);
+}
 
-  _out->write('"', part);
-  _out->write(a, part);
-  _out->write('"', part);
-  _out->write(b, part);
+// ____________________________________________________________________________
+template <typename T>
+void osm2rdf::ttl::Writer<T>::put(char c, size_t part) {
+  if (!_pending.empty()) {
+    _pending[part].terms.push_back(c);
+    return;
+  }
+  _out->write(c, part);
+}
+
+// ____________________________________________________________________________
+template <typename T>
+void osm2rdf::ttl::Writer<T>::writeSeparator(size_t part) {
+  if (!_pending.empty()) {
+    auto& pending = _pending[part];
+    assert(pending.numEnds < 2);
+    pending.ends[pending.numEnds++] = pending.terms.size();
+    return;
+  }
+  _out->write(' ', part);
+}
 
+// ____________________________________________________________________________
+template <typename T>
+void osm2rdf::ttl::Writer<T>::writeTripleEnd(size_t part) {
+  if (!_pending.empty()) {
+    writeCollectedTriple(part);
+    return;
+  }
   _out->write(" .", part);
   _out->writeNewLine(part);
   _lineCount[part]++;
 }
 
+// ____________________________________________________________________________
+template <typename T>
+size_t osm2rdf::ttl::Writer<T>::outputPart(std::string_view s,
+                                           size_t part) const {
+  if (_numShards == 1) {
+    return part;
+  }
+  // A fixed hash keeps subjects in the same shard across builds.
+  return (osm2rdf::util::fnv1a(s) % _numShards) * _numOuts + part;
+}
+
+// ____________________________________________________________________________
+template <typename T>
+void osm2rdf::ttl::Writer<T>::writeTerms(std::string_view s,
+                                         std::string_view p,
+                                         std::string_view o, size_t part) {
+  const size_t outPart = outputPart(s, part);
+  if (!_groups.empty()) {
+    writeGroupedTriple(s, p, o, outPart);
+  } else {
+    _out->write(s, outPart);
+    _out->write(' ', outPart);
+    _out->write(p, outPart);
+    _out->write(' ', outPart);
+    _out->write(o, outPart);
+    _out->write(" .", outPart);
+    _out->writeNewLine(outPart);
+  }
+  _lineCount[outPart]++;
+}
+
+// ____________________________________________________________________________
+template <>
+void osm2rdf::ttl::Writer<osm2rdf::ttl::format::BINARY>::writeTerms(
+    std::string_view s, std::string_view p, std::string_view o, size_t part) {
+  const size_t outPart = outputPart(s, part);
+  _out->write(_encoders[outPart].encodeTriple(s, p, o), outPart);
+  _out->endRecord(outPart);
+  _lineCount[outPart]++;
+}
+
+// ____________________________________________________________________________
+template <typename T>
+void osm2rdf::ttl::Writer<T>::writeCollectedTriple(size_t part) {
+  auto& pending = _pending[part];
+  assert(pending.numEnds == 2);
+  std::string_view terms{pending.terms};
+  writeTerms(terms.substr(0, pending.ends[0]),
+             terms.substr(pending.ends[0], pending.ends[1] - pending.ends[0]),
+             terms.substr(pending.ends[1]), part);
+  pending.terms.clear();
+  pending.numEnds = 0;
+}
+
+// ____________________________________________________________________________
+template <typename T>
+void osm2rdf::ttl::Writer<T>::writeGroupedTriple(std::string_view s,
+                                                 std::string_view p,
+                                                 std::string_view o,
+                                                 size_t outPart) {
+  auto& group = _groups[outPart];
+  if (group.open && group.subject == s) {
+    if (group.predicate == p) {
+      _out->write(" ,\n\t\t", outPart);
+    } else {
+      _out->write(" ;\n\t", outPart);
+      _out->write(p, outPart);
+      _out->write(' ', outPart);
+      group.predicate.assign(p);
+    }
+  } else {
+    // Statements are only terminated with writeNewLine, a chunk written to
+    // stdout never ends inside a statement.
+    if (group.open) {
+      _out->write(" .", outPart);
+      _out->writeNewLine(outPart);
+    }
+    _out->write(s, outPart);
+    _out->write(' ', outPart);
+    _out->write(p, outPart);
+    _out->write(' ', outPart);
+    group.subject.assign(s);
+    group.predicate.assign(p);
+    group.open = true;
+  }
+  _out->write(o, outPart);
+}
+
+// ____________________________________________________________________________
+template <typename T>
+void osm2rdf::ttl::Writer<T>::initParts() {
+  // N-Triples has no statement continuations.
+  if (_config.outputGroupSubjects &&
+      !std::is_same_v<T, osm2rdf::ttl::format::NT>) {
+    _groups.resize(_numOuts * _numShards);
+  }
+  if (!_groups.empty() || _numShards > 1) {
+    _pending.resize(_numOuts);
+  }
+}
+
+// ____________________________________________________________________________
+template <>
+void osm2rdf::ttl::Writer<osm2rdf::ttl::format::BINARY>::initParts() {
+  _encoders.reserve(_numOuts * _numShards);
+  for (size_t i = 0; i < _numOuts * _numShards; ++i) {
+    _encoders.emplace_back(i);
+  }
+  if (_numShards > 1) {
+    _pending.resize(_numOuts);
+  }
+}
+
+// ____________________________________________________________________________
+template <>
+void osm2rdf::ttl::Writer<osm2rdf::ttl::format::BINARY>::put(std::string_view s,
+                                                             size_t part) {
+  if (!_pending.empty()) {
+    _pending[part].terms.append(s);
+    return;
+  }
+  _encoders[part].append(s);
+}
+
+// ____________________________________________________________________________
+template <>
+void osm2rdf::ttl::Writer<osm2rdf::ttl::format::BINARY>::put(char c,
+                                                             size_t part) {
+  if (!_pending.empty()) {
+    _pending[part].terms.push_back(c);
+    return;
+  }
+  _encoders[part].append(c);
+}
+
+// ____________________________________________________________________________
+template <>
+void osm2rdf::ttl::Writer<osm2rdf::ttl::format::BINARY>::writeSeparator(
+    size_t part) {
+  if (!_pending.empty()) {
+    auto& pending = _pending[part];
+    assert(pending.numEnds < 2);
+    pending.ends[pending.numEnds++] = pending.terms.size();
+    return;
+  }
+  _encoders[part].endTerm();
+}
+
+// ____________________________________________________________________________
+template <>
+void osm2rdf::ttl::Writer<osm2rdf::ttl::format::BINARY>::writeTripleEnd(
+    size_t part) {
+  if (!_pending.empty()) {
+    writeCollectedTriple(part);
+    return;
+  }
+  _out->write(_encoders[part].encodeTriple(), part);
+  _out->endRecord(part);
+  _lineCount[part]++;
+}
+
+// ____________________________________________________________________________
+template <>
+void osm2rdf::ttl::Writer<osm2rdf::ttl::format::BINARY>::writeTriple(
+    const std::string& s, const std::string& p, const std::string& o,
+    size_t part) {
+  // Complete terms are encoded without copying them first.
+  writeTerms(s, p, o, part);
+}
+
+// ____________________________________________________________________________
+template <typename T>
+typename osm2rdf::ttl::Writer<T>::Cursor osm2rdf::ttl::Writer<T>::triple() {
+  size_t part = 0;
+
+#if defined(_OPENMP)
+  part = omp_get_thread_num();
+#else
+  part = 0;
+#endif
+
+  return triple(part);
+}
+
+// ____________________________________________________________________________
+template <typename T>
+typename osm2rdf::ttl::Writer<T>::Cursor osm2rdf::ttl::Writer<T>::triple(
+    size_t part) {
+  return Cursor{this, part};
+}
+
+// ____________________________________________________________________________
+template <typename T>
+osm2rdf::ttl::Writer<T>::Cursor::Cursor(Writer<T>* writer, size_t part)
+    : _writer(writer), _part(part) {}
+
+// ____________________________________________________________________________
+template <typename T>
+void osm2rdf::ttl::Writer<T>::Cursor::separate() {
+  if (_first) {
+    _first = false;
+    return;
+  }
+  _writer->writeSeparator(_part);
+}
+
+// ____________________________________________________________________________
+template <typename T>
+typename osm2rdf::ttl::Writer<T>::Cursor& osm2rdf::ttl::Writer<T>::Cursor::term(
+    std::string_view t) {
+  separate();
+  _writer->put(t, _part);
+  return *this;
+}
+
+// ____________________________________________________________________________
+template <typename T>
+typename osm2rdf::ttl::Writer<T>::Cursor& osm2rdf::ttl::Writer<T>::Cursor::iri(
+    std::string_view p, uint64_t v) {
+  separate();
+  _writer->writeIRI(p, v, _part);
+  return *this;
+}
+
+// ____________________________________________________________________________
+template <typename T>
+typename osm2rdf::ttl::Writer<T>::Cursor& osm2rdf::ttl::Writer<T>::Cursor::iri(
+    std::string_view p, std::string_view v) {
+  separate();
+  _writer->writeIRI(p, v, _part);
+  return *this;
+}
+
+// ____________________________________________________________________________
+template <typename T>
+typename osm2rdf::ttl::Writer<T>::Cursor&
+osm2rdf::ttl::Writer<T>::Cursor::iriUnsafe(std::string_view p,
+                                           std::string_view v) {
+  separate();
+  _writer->writeIRIUnsafe(p, v, _part);
+  return *this;
+}
+
+// ____________________________________________________________________________
+template <typename T>
+typename osm2rdf::ttl::Writer<T>::Cursor&
+osm2rdf::ttl::Writer<T>::Cursor::literal(std::string_view v) {
+  separate();
+  _writer->writeLiteral(v, _part);
+  return *this;
+}
+
+// ____________________________________________________________________________
+template <typename T>
+typename osm2rdf::ttl::Writer<T>::Cursor&
+osm2rdf::ttl::Writer<T>::Cursor::literalUnsafe(std::string_view v,
+                                               std::string_view s) {
+  separate();
+  _writer->writeLiteralUnsafe(v, s, _part);
+  return *this;
+}
+
+// ____________________________________________________________________________
+template <typename T>
+typename osm2rdf::ttl::Writer<T>::Cursor&
+osm2rdf::ttl::Writer<T>::Cursor::integerLiteral(int64_t v, std::string_view s) {
+  separate();
+  _writer->writeIntegerLiteral(v, s, _part);
+  return *this;
+}
+
+// ____________________________________________________________________________
+template <typename T>
+typename osm2rdf::ttl::Writer<T>::Cursor&
+osm2rdf::ttl::Writer<T>::Cursor::doubleLiteral(double v, std::string_view s) {
+  separate();
+  _writer->writeDoubleLiteral(v, s, _part);
+  return *this;
+}
+
+// ____________________________________________________________________________
+template <typename T>
+void osm2rdf::ttl::Writer<T>::Cursor::end() {
+  _writer->writeTripleEnd(_part);
+}
+
 // ____________________________________________________________________________
 template <>
 std::string osm2rdf::ttl::Writer<osm2rdf::ttl::format::NT>::formatIRI(
@@ -616,6 +1075,30 @@ std::string osm2rdf::ttl::Writer<osm2rdf::ttl::format::NT>::formatIRIUnsafe(
   return IRIREFUnsafe(p, v);
 }
 
+// ____________________________________________________________________________
+template <>
+std::string osm2rdf::ttl::Writer<osm2rdf::ttl::format::BINARY>::formatIRI(
+    std::string_view p, std::string_view v) {
+  // Terms in binary output use N-Triples syntax.
+  auto prefix = _prefixes.find(std::string{p});
+  if (prefix != _prefixes.end()) {
+    return IRIREF(prefix->second, v);
+  }
+  return IRIREF(p, v);
+}
+
+// ____________________________________________________________________________
+template <>
+std::string
+osm2rdf::ttl::Writer<osm2rdf::ttl::format::BINARY>::formatIRIUnsafe(
+    std::string_view p, std::string_view v) {
+  auto prefix = _prefixes.find(std::string{p});
+  if (prefix != _prefixes.end()) {
+    return IRIREFUnsafe(prefix->second, v);
+  }
+  return IRIREFUnsafe(p, v);
+}
+
 // ____________________________________________________________________________
 template <>
 std::string osm2rdf::ttl::Writer<osm2rdf::ttl::format::TTL>::formatIRIUnsafe(
@@ -710,6 +1193,21 @@ std::string osm2rdf::ttl::Writer<T>::IRIREFUnsafe(std::string_view p,
   return "<" + std::string(p) + std::string(v) + ">";
 }
 
+// ____________________________________________________________________________
+template <typename T>
+void osm2rdf::ttl::Writer<T>::writeIRIREFUnsafe(std::string_view p,
+                                                std::string_view v,
+                                                size_t part) {
+  // NT:  [8]    IRIREF
+  //      https://www.w3.org/TR/n-triples/#grammar-production-IRIREF
+  // TTL: [18]   IRIREF (same as NT)
+  //      https://www.w3.org/TR/turtle/#grammar-production-IRIREF
+  put('<', part);
+  put(p, part);
+  put(v, part);
+  put('>', part);
+}
+
 // ____________________________________________________________________________
 template <typename T>
 std::string osm2rdf::ttl::Writer<T>::PrefixedName(std::string_view p,
@@ -735,20 +1233,16 @@ void osm2rdf::ttl::Writer<T>::writePrefixedName(std::string_view p,
                                                 size_t part) {
   // TTL: [136s] PrefixedName
   //      https://www.w3.org/TR/turtle/#grammar-production-PrefixedName
-  _out->write(p, part);
-  _out->write(':', part);
+  put(p, part);
+  put(':', part);
 
   // check if v is well-behaved, if not, call encodePN_LOCAL, otherwise write
   // string_view directly without any additional copying
-  for (size_t pos = 0; pos < v.size(); ++pos) {
-    if (!(v[pos] == ':' || v[pos] == '_' || (v[pos] >= 'A' && v[pos] <= 'Z') ||
-          (v[pos] >= 'a' && v[pos] <= 'z') ||
-          (v[pos] >= '0' && v[pos] <= '9'))) {
-      _out->write(encodePN_LOCAL(v), part);
-      return;
-    }
+  if (osm2rdf::util::simd::findPN_LOCALSpecial(v) != v.size()) {
+    put(encodePN_LOCAL(v), part);
+    return;
   }
-  _out->write(v, part);
+  put(v, part);
 }
 
 // ____________________________________________________________________________
@@ -758,9 +1252,9 @@ void osm2rdf::ttl::Writer<T>::writePrefixedNameUnsafe(std::string_view p,
                                                       size_t part) {
   // TTL: [136s] PrefixedName
   //      https://www.w3.org/TR/turtle/#grammar-production-PrefixedName
-  _out->write(p, part);
-  _out->write(':', part);
-  _out->write(v, part);
+  put(p, part);
+  put(':', part);
+  put(v, part);
 }
 
 // ____________________________________________________________________________
@@ -773,8 +1267,15 @@ std::string osm2rdf::ttl::Writer<T>::STRING_LITERAL_QUOTE(std::string_view s) {
   std::string tmp;
   tmp.reserve(s.size() * 2);
   tmp += "\"";
-  for (const auto c : s) {
-    switch (c) {
+  for (size_t pos = 0; pos < s.size(); ++pos) {
+    // Copy all chars not requiring escaping at once
+    size_t clean = osm2rdf::util::simd::findLiteralEscape(s.substr(pos));
+    tmp += s.substr(pos, clean);
+    pos += clean;
+    if (pos >= s.size()) {
+      break;
+    }
+    switch (s[pos]) {
       case '\"':  // #x22
         tmp += "\\\"";
         break;
@@ -787,8 +1288,6 @@ std::string osm2rdf::ttl::Writer<T>::STRING_LITERAL_QUOTE(std::string_view s) {
       case '\r':  // #x0D
         tmp += "\\r";
         break;
-      default:
-        tmp += c;
     }
   }
   tmp += "\"";
@@ -900,15 +1399,16 @@ std::string osm2rdf::ttl::Writer<T>::UCHAR(uint32_t codepoint) {
   //      https://www.w3.org/TR/n-triples/#grammar-production-UCHAR
   // TTL: [26]  UCHAR
   //      https://www.w3.org/TR/turtle/#grammar-production-UCHAR
-  std::ostringstream tmp;
-  tmp << std::setfill('0');
-  if (codepoint > k0xFFFFU) {
-    tmp << "\\U" << std::setw(UTF8_BYTES_LONG);
-  } else {
-    tmp << "\\u" << std::setw(UTF8_BYTES_SHORT);
+  const size_t digits =
+      codepoint > k0xFFFFU ? UTF8_BYTES_LONG : UTF8_BYTES_SHORT;
+  std::string tmp(2 + digits, '0');
+  tmp[0] = '\\';
+  tmp[1] = codepoint > k0xFFFFU ? 'U' : 'u';
+  for (size_t i = tmp.size() - 1; codepoint > 0; --i) {
+    tmp[i] = HEX_DIGITS[codepoint & k0x0F];
+    codepoint >>= NUM_BITS_IN_NIBBLE;
   }
-  tmp << std::hex << codepoint;
-  return tmp.str();
+  return tmp;
 }
 
 // ____________________________________________________________________________
@@ -921,6 +1421,13 @@ std::string osm2rdf::ttl::Writer<T>::encodeIRIREF(std::string_view s) {
   std::string tmp;
   tmp.reserve(s.size() * 2);
   for (size_t pos = 0; pos < s.size(); ++pos) {
+    // Copy all ASCII chars not requiring encoding at once
+    size_t clean = osm2rdf::util::simd::findIRIREFEscape(s.substr(pos));
+    tmp += s.substr(pos, clean);
+    pos += clean;
+    if (pos >= s.size()) {
+      break;
+    }
     // Force non-allowed chars to UCHAR
     auto c = s[pos];
     if ((c >= 0x00 && c <= ' ') || c == '<' || c == '>' || c == '{' ||
@@ -947,6 +1454,13 @@ std::string osm2rdf::ttl::Writer<osm2rdf::ttl::format::QLEVER>::encodeIRIREF(
   std::string tmp;
   tmp.reserve(s.size() * 2);
   for (size_t pos = 0; pos < s.size(); ++pos) {
+    // Copy all ASCII chars not requiring encoding at once
+    size_t clean = osm2rdf::util::simd::findIRIREFEscape(s.substr(pos));
+    tmp += s.substr(pos, clean);
+    pos += clean;
+    if (pos >= s.size()) {
+      break;
+    }
     uint8_t length = utf8Length(s[pos]);
     // Force non-allowed chars to PERCENT
     if (length == k1Byte) {
@@ -980,25 +1494,19 @@ template <typename T>
 std::string osm2rdf::ttl::Writer<T>::encodePERCENT(uint32_t codepoint) {
   // TTL: [170s] PERCENT
   //      https://www.w3.org/TR/turtle/#grammar-production-PERCENT
-  std::vector<std::string> parts;
-  parts.reserve(4);
-
-  // Generate parts
-  std::ostringstream tmp;
-  tmp << std::setfill('0');
+  // Generate parts, least significant byte first
+  std::string tmp;
+  tmp.reserve(12);
   do {
-    tmp << "%" << std::setw(2) << std::hex << (codepoint & k0xFFU);
-    parts.push_back(tmp.str());
-    tmp.seekp(0);
+    tmp += HEX_DIGITS[codepoint & k0x0F];
+    tmp += HEX_DIGITS[(codepoint >> NUM_BITS_IN_NIBBLE) & k0x0F];
+    tmp += '%';
     codepoint = codepoint >> NUM_BITS_IN_BYTE;
   } while (codepoint > 0);
 
   // Revert order of string parts
-  std::reverse(parts.begin(), parts.end());
-  for (const auto& part : parts) {
-    tmp << part;
-  }
-  return tmp.str();
+  std::reverse(tmp.begin(), tmp.end());
+  return tmp;
 }
 
 // ____________________________________________________________________________
@@ -1099,6 +1607,11 @@ int8_t osm2rdf::ttl::Writer<T>::checkPN_LOCAL(std::string_view s) {
     //                        '(' | ')' | '*' | '+' | ',' | ';' | '=' | '/' |
     //                        '?' | '#' | '@' | '%')
 
+    size_t clean = osm2rdf::util::simd::findPN_LOCALSpecial(s.substr(pos));
+    pos += clean;
+    if (pos >= s.size()) {
+      break;
+    }
     auto currentChar = s[pos];
     // _, :, A-Z, a-z, and 0-9 always allowed:
     if (currentChar == ':' || currentChar == '_' ||
@@ -1183,6 +1696,13 @@ std::string osm2rdf::ttl::Writer<T>::encodePN_LOCAL(std::string_view s) {
     //                        '(' | ')' | '*' | '+' | ',' | ';' | '=' | '/' |
     //                        '?' | '#' | '@' | '%')
 
+    // Copy all chars allowed everywhere at once
+    size_t clean = osm2rdf::util::simd::findPN_LOCALSpecial(s.substr(pos));
+    tmp += s.substr(pos, clean);
+    pos += clean;
+    if (pos >= s.size()) {
+      break;
+    }
     auto currentChar = s[pos];
     // _, :, A-Z, a-z, and 0-9 always allowed:
     if (currentChar == ':' || currentChar == '_' ||
@@ -1250,10 +1770,10 @@ void osm2rdf::ttl::Writer<osm2rdf::ttl::format::NT>::writeFormattedIRI(
   //      https://www.w3.org/TR/n-triples/#grammar-production-IRIREF
   auto prefix = _prefixes.find(std::string{p});
   if (prefix != _prefixes.end()) {
-    _out->write(IRIREF(prefix->second, v), part);
+    put(IRIREF(prefix->second, v), part);
     return;
   }
-  _out->write(IRIREF(p, v), part);
+  put(IRIREF(p, v), part);
 }
 
 // ____________________________________________________________________________
@@ -1264,10 +1784,37 @@ void osm2rdf::ttl::Writer<osm2rdf::ttl::format::NT>::writeFormattedIRIUnsafe(
   //      https://www.w3.org/TR/n-triples/#grammar-production-IRIREF
   auto prefix = _prefixes.find(std::string{p});
   if (prefix != _prefixes.end()) {
-    _out->write(IRIREFUnsafe(prefix->second, v), part);
+    writeIRIREFUnsafe(prefix->second, v, part);
+    return;
+  }
+  writeIRIREFUnsafe(p, v, part);
+}
+
+// ____________________________________________________________________________
+template <>
+void osm2rdf::ttl::Writer<osm2rdf::ttl::format::BINARY>::writeFormattedIRI(
+    std::string_view p, std::string_view v, size_t part) {
+  // Terms in binary output use N-Triples syntax.
+  auto prefix = _prefixes.find(std::string{p});
+  if (prefix != _prefixes.end()) {
+    put(IRIREF(prefix->second, v), part);
+    return;
+  }
+  put(IRIREF(p, v), part);
+}
+
+// ____________________________________________________________________________
+template <>
+void osm2rdf::ttl::Writer<
+    osm2rdf::ttl::format::BINARY>::writeFormattedIRIUnsafe(std::string_view p,
+                                                           std::string_view v,
+                                                           size_t part) {
+  auto prefix = _prefixes.find(std::string{p});
+  if (prefix != _prefixes.end()) {
+    writeIRIREFUnsafe(prefix->second, v, part);
     return;
   }
-  _out->write(IRIREFUnsafe(p, v), part);
+  writeIRIREFUnsafe(p, v, part);
 }
 
 // ____________________________________________________________________________
@@ -1286,7 +1833,7 @@ void osm2rdf::ttl::Writer<osm2rdf::ttl::format::TTL>::writeFormattedIRIUnsafe(
     writePrefixedNameUnsafe(p, v, part);
     return;
   }
-  _out->write(IRIREFUnsafe(p, v), part);
+  writeIRIREFUnsafe(p, v, part);
 }
 
 // ____________________________________________________________________________
@@ -1307,7 +1854,7 @@ void osm2rdf::ttl::Writer<
     writePrefixedNameUnsafe(p, v, part);
     return;
   }
-  _out->write(IRIREFUnsafe(p, v), part);
+  writeIRIREFUnsafe(p, v, part);
 }
 
 // ____________________________________________________________________________
@@ -1326,7 +1873,7 @@ void osm2rdf::ttl::Writer<osm2rdf::ttl::format::TTL>::writeFormattedIRI(
     writePrefixedName(p, v, part);
     return;
   }
-  _out->write(IRIREF(p, v), part);
+  put(IRIREF(p, v), part);
 }
 
 // ____________________________________________________________________________
@@ -1345,10 +1892,11 @@ void osm2rdf::ttl::Writer<osm2rdf::ttl::format::QLEVER>::writeFormattedIRI(
     writePrefixedName(p, v, part);
     return;
   }
-  _out->write(IRIREF(p, v), part);
+  put(IRIREF(p, v), part);
 }
 
 // ____________________________________________________________________________
 template class osm2rdf::ttl::Writer<osm2rdf::ttl::format::NT>;
 template class osm2rdf::ttl::Writer<osm2rdf::ttl::format::TTL>;
 template class osm2rdf::ttl::Writer<osm2rdf::ttl::format::QLEVER>;
+template class osm2rdf::ttl::Writer<osm2rdf::ttl::format::BINARY>;
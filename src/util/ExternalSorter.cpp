@@ -0,0 +1,126 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/util/ExternalSorter.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+// ____________________________________________________________________________
+osm2rdf::util::ExternalSorter::ExternalSorter(
+    const std::filesystem::path& prefix, size_t maxRecords)
+    : _prefix(prefix), _maxRecords(std::max(maxRecords, size_t{1})) {}
+
+// ____________________________________________________________________________
+osm2rdf::util::ExternalSorter::~ExternalSorter() {
+  _runs.clear();
+  for (const auto& path : _runPaths) {
+    std::filesystem::remove(path);
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::ExternalSorter::add(uint64_t key, uint64_t value) {
+  if (_buffer.size() == _maxRecords) {
+    spill();
+  }
+  _buffer.push_back(Record{key, value});
+  _size++;
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::ExternalSorter::spill() {
+  std::sort(_buffer.begin(), _buffer.end());
+  const std::filesystem::path path{_prefix.string() + ".run_" +
+                                   std::to_string(_runPaths.size())};
+  _runPaths.push_back(path);
+  std::ofstream out{path, std::ios::binary | std::ios::trunc};
+  out.write(reinterpret_cast<const char*>(_buffer.data()),
+            static_cast<std::streamsize>(_buffer.size() * sizeof(Record)));
+  if (!out) {
+    throw std::runtime_error("Can't write sort run " + path.string());
+  }
+  _buffer.clear();
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::util::ExternalSorter::refill(Run* run) {
+  run->block.resize(READ_BLOCK_SIZE);
+  run->in.read(reinterpret_cast<char*>(run->block.data()),
+               static_cast<std::streamsize>(READ_BLOCK_SIZE * sizeof(Record)));
+  run->block.resize(static_cast<size_t>(run->in.gcount()) / sizeof(Record));
+  run->pos = 0;
+  return !run->block.empty();
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::ExternalSorter::finish() {
+  if (_runPaths.empty()) {
+    // Everything fits into memory, no merge needed.
+    std::sort(_buffer.begin(), _buffer.end());
+    _bufferPos = 0;
+    return;
+  }
+  if (!_buffer.empty()) {
+    spill();
+  }
+  _buffer.clear();
+  _buffer.shrink_to_fit();
+  const auto greater = [this](size_t a, size_t b) {
+    return _runs[b]->block[_runs[b]->pos] < _runs[a]->block[_runs[a]->pos];
+  };
+  for (const auto& path : _runPaths) {
+    auto run = std::make_unique<Run>();
+    run->in.open(path, std::ios::binary);
+    if (!run->in) {
+      throw std::runtime_error("Can't read sort run " + path.string());
+    }
+    _runs.push_back(std::move(run));
+    if (refill(_runs.back().get())) {
+      _heap.push_back(_runs.size() - 1);
+    }
+  }
+  std::make_heap(_heap.begin(), _heap.end(), greater);
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::util::ExternalSorter::next(Record* record) {
+  if (_runs.empty()) {
+    if (_bufferPos == _buffer.size()) {
+      return false;
+    }
+    *record = _buffer[_bufferPos++];
+    return true;
+  }
+  if (_heap.empty()) {
+    return false;
+  }
+  const auto greater = [this](size_t a, size_t b) {
+    return _runs[b]->block[_runs[b]->pos] < _runs[a]->block[_runs[a]->pos];
+  };
+  std::pop_heap(_heap.begin(), _heap.end(), greater);
+  Run* run = _runs[_heap.back()].get();
+  *record = run->block[run->pos++];
+  if (run->pos < run->block.size() || refill(run)) {
+    std::push_heap(_heap.begin(), _heap.end(), greater);
+  } else {
+    _heap.pop_back();
+  }
+  return true;
+}
@@ -0,0 +1,29 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+#include "osm2rdf/util/Hash.h"
+
+static const uint64_t FNV1A_PRIME = 0x100000001b3ULL;
+
+// ____________________________________________________________________________
+uint64_t osm2rdf::util::fnv1a(std::string_view data, uint64_t hash) {
+  for (const char c : data) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= FNV1A_PRIME;
+  }
+  return hash;
+}
@@ -0,0 +1,46 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/util/Hilbert.h"
+
+#include <utility>
+
+// ____________________________________________________________________________
+uint64_t osm2rdf::util::hilbertKey(uint32_t x, uint32_t y) {
+  uint64_t key = 0;
+  for (uint32_t s = uint32_t{1} << 31U; s > 0; s >>= 1U) {
+    const uint32_t rx = (x & s) > 0 ? 1 : 0;
+    const uint32_t ry = (y & s) > 0 ? 1 : 0;
+    key += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+    // Rotate the quadrant, coordinates only matter below s from now on.
+    if (ry == 0) {
+      if (rx == 1) {
+        x = ~x;
+        y = ~y;
+      }
+      std::swap(x, y);
+    }
+  }
+  return key;
+}
+
+// ____________________________________________________________________________
+uint64_t osm2rdf::util::hilbertKey(int32_t x, int32_t y) {
+  return hilbertKey(static_cast<uint32_t>(x) ^ (uint32_t{1} << 31U),
+                    static_cast<uint32_t>(y) ^ (uint32_t{1} << 31U));
+}
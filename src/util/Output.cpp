@@ -16,10 +16,17 @@
 // You should have received a copy of the GNU General Public License
 // along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
 
-#include <bzlib.h>
-#include <zlib.h>
-
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#endif
+
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
 #include <cmath>
 #include <cstdio>
 #include <cstring>
@@ -31,16 +38,14 @@
 
 #include "osm2rdf/config/Config.h"
 #include "osm2rdf/util/Output.h"
-
-using osm2rdf::config::BZ2;
-using osm2rdf::config::GZ;
-using osm2rdf::config::NONE;
+#include "osm2rdf/util/OutputCodec.h"
 
 // ____________________________________________________________________________
 osm2rdf::util::Output::Output(const osm2rdf::config::Config& config,
                               const std::string& prefix)
-    : Output(config, prefix, config.numThreads + 1) {
-}
+    : Output(config, prefix,
+             (config.numThreads + 1) *
+                 static_cast<size_t>(std::max(config.outputShards, 1))) {}
 
 // ____________________________________________________________________________
 osm2rdf::util::Output::Output(const osm2rdf::config::Config& config,
@@ -48,63 +53,85 @@ osm2rdf::util::Output::Output(const osm2rdf::config::Config& config,
     : _config(config),
       _prefix(prefix),
       _partCount(partCount),
+      _shardCount(std::max(config.outputShards, 1)),
       _partCountDigits(std::floor(std::log10(partCount)) + 1),
       _outBuffers(_partCount),
-      _lines(_partCount),
-      _toStdOut(_config.output.empty()) {}
+      _toStdOut(_config.output.empty()),
+      _parallelCompress(false) {}
 
 // ____________________________________________________________________________
-osm2rdf::util::Output::~Output() { close(); }
+osm2rdf::util::Output::~Output() {
+  try {
+    close();
+  } catch (const std::exception& e) {
+    std::cerr << "Can't close output: " << e.what() << std::endl;
+  }
+}
 
 // ____________________________________________________________________________
 bool osm2rdf::util::Output::open() {
   assert(_partCount > 0);
+  assert(_partCount % _shardCount == 0);
 
-  _rawFiles.resize(_partCount);
-  _gzFiles.resize(_partCount);
-  _files.resize(_partCount);
+  _codecs.clear();
   _outBufPos.resize(_partCount);
+  _blocksSubmitted.assign(_partCount, 0);
+  _blocksWritten.assign(_partCount, 0);
+  _stallTimes.assign(_partCount, std::chrono::steady_clock::duration::zero());
 
-  for (size_t i = 0; i < _partCount; i++) {
-    if (_config.outputCompress == BZ2 || _config.outputCompress == NONE) {
-      _rawFiles[i] = fopen(partFilename(i).c_str(), "w");
-
-      if (_rawFiles[i] == NULL) {
-        std::stringstream ss;
-        ss << "Could not open file '" << partFilename(i)
-           << "' for writing:\n";
-        ss << strerror(errno) << std::endl;
-        throw std::runtime_error(ss.str());
-      }
+  if (_toStdOut) {
+    // Each part fills one chunk while at most STDOUT_QUEUED_CHUNKS others
+    // wait in the queue, independent of the number of parts.
+    const size_t chunks = _partCount + STDOUT_QUEUED_CHUNKS;
+    if (_stdoutFd >= 0) {
+      _stdoutSink =
+          std::make_unique<StdoutSink>(_config, BUFFER_S, chunks, _stdoutFd);
+    } else {
+      _stdoutSink =
+          std::make_unique<StdoutSink>(_config, BUFFER_S, chunks, &std::cout);
+    }
+    _stdoutSink->open();
+  } else {
+    for (size_t i = 0; i < _partCount; i++) {
+      _codecs.push_back(OutputCodec::create(_config, _partCount));
     }
+    _parallelCompress = _config.outputCompress != osm2rdf::config::NONE &&
+                        _config.outputCompressionThreads > 0 &&
+                        !_codecs[0]->compressesInParallel();
+    // Otherwise full buffers can be compressed and written in the
+    // background while the part fills its next buffer.
+    _asyncWrite = !_parallelCompress && _config.outputAsyncWrite;
+  }
 
-    if (_config.outputCompress == BZ2) {
-      int err = 0;
-      _files[i] = BZ2_bzWriteOpen(&err, _rawFiles[i], 3, 0, 30);
-      if (err != BZ_OK) {
-        std::stringstream ss;
-        ss << "Could not open bzip2 file '" << partFilename(i)
-           << "' for writing:\n";
-        ss << strerror(errno) << std::endl;
-        throw std::runtime_error(ss.str());
-      }
+  for (size_t i = 0; i < _partCount; i++) {
+    if (_toStdOut) {
+      _outBuffers[i] = _stdoutSink->acquire();
+    } else {
+      _codecs[i]->open(partFilename(i), !_parallelCompress);
+      _outBuffers[i] = new unsigned char[BUFFER_S];
     }
+  }
 
-    if (_config.outputCompress == GZ) {
-      _gzFiles[i] = gzopen(partFilename(i).c_str(), "w");
-      if (_gzFiles[i] == Z_NULL) {
-        std::stringstream ss;
-        ss << "Could not open gz file '" << partFilename(i)
-           << "' for writing:\n";
-        ss << strerror(errno) << std::endl;
-        throw std::runtime_error(ss.str());
-      }
+  if (_parallelCompress || _asyncWrite) {
+    _stopCompressWorkers = false;
+    _compressError.clear();
+    _blocksInFlight = 0;
+    // Two blocks per worker: one being compressed, one waiting.
+    _maxBlocksInFlight = 2 * _config.outputCompressionThreads;
+    // Streams of a part are sequential, more workers than parts are idle.
+    size_t numWorkers = _config.outputCompressionThreads;
+    if (_asyncWrite) {
+      _maxBlocksInFlight = ASYNC_BLOCKS_PER_PART * _partCount;
+      numWorkers = _partCount;
+    }
+    for (size_t i = 0; i < numWorkers; ++i) {
+      _compressWorkers.emplace_back(&Output::compressWorker, this);
     }
-    _outBuffers[i] = new unsigned char[BUFFER_S];
   }
 
-  // Prepare final output file
-  if (!_toStdOut && _config.mergeOutput != OutputMergeMode::NONE) {
+  // Prepare final output file, shards are created when merging.
+  if (!_toStdOut && _config.mergeOutput != OutputMergeMode::NONE &&
+      _shardCount == 1) {
     _outFile.open(_prefix, std::ofstream::out | std::ofstream::trunc);
     if (!_outFile.is_open()) {
       std::cerr << "Can't open final output file: " << _prefix << std::endl;
@@ -121,69 +148,72 @@ void osm2rdf::util::Output::close() {
   if (!_open) {
     return;
   }
+  // Closed also if closing fails, the destructor does not retry.
+  _open = false;
 
   if (_toStdOut) {
     for (size_t i = 0; i < _partCount; ++i) {
-      _lines[i] = 0;
-      _outBuffers[i][_outBufPos[i]] = '\0';
-      std::cout << reinterpret_cast<const char*>(_outBuffers[i]);
+      _stdoutSink->submit(_outBuffers[i], _outBufPos[i]);
+      _outBuffers[i] = nullptr;
     }
-  } else if (_config.outputCompress == BZ2) {
-#pragma omp parallel for
-    for (size_t i = 0; i < _partCount; ++i) {
-      int err = 0;
-      BZ2_bzWrite(&err, _files[i], _outBuffers[i], _outBufPos[i]);
-      if (err == BZ_IO_ERROR) {
-        BZ2_bzWriteClose(&err, _files[i], 0, 0, 0);
-        std::stringstream ss;
-        ss << "Could not write to bzip2 file '"
-           << partFilename(i) << "':\n";
-        ss << strerror(errno) << std::endl;
-        throw std::runtime_error(ss.str());
+    _stdoutSink->close();
+    return;
+  }
+
+  // The workers are joined on every path, before any error is rethrown.
+  if (_parallelCompress) {
+    // All remaining buffers are compressed concurrently by the workers.
+    try {
+      for (size_t i = 0; i < _partCount; ++i) {
+        if (_outBufPos[i] > 0) {
+          submitBlock(i);
+        }
       }
-      BZ2_bzWriteClose(&err, _files[i], 0, 0, 0);
-      fclose(_rawFiles[i]);
+    } catch (...) {
+      stopWorkers();
+      releaseBuffers();
+      throw;
     }
-  } else if (_config.outputCompress == GZ) {
+    stopWorkers();
+  } else if (_asyncWrite) {
+    // Blocks in flight are written first.
+    stopWorkers();
+  }
+
+  // The remaining buffers are written in parallel, unless a block failed.
+  std::string error = _compressError;
+  std::mutex errorMutex;
 #pragma omp parallel for
-    for (size_t i = 0; i < _partCount; ++i) {
-      int r = gzwrite(_gzFiles[i], _outBuffers[i], _outBufPos[i]);
-      if (r != (int)_outBufPos[i]) {
-        gzclose(_gzFiles[i]);
-        std::stringstream ss;
-        ss << "Could not write to gz file '"
-           << partFilename(i) << "':\n";
-        ss << strerror(errno) << std::endl;
-        throw std::runtime_error(ss.str());
+  for (size_t i = 0; i < _partCount; ++i) {
+    try {
+      if (!_parallelCompress && _compressError.empty()) {
+        _codecs[i]->write(_outBuffers[i], _outBufPos[i]);
       }
-      gzclose(_gzFiles[i]);
-    }
-  } else {
-#pragma omp parallel for
-    for (size_t i = 0; i < _partCount; ++i) {
-      size_t r =
-          fwrite(_outBuffers[i], sizeof(char), _outBufPos[i], _rawFiles[i]);
-      if (r != _outBufPos[i]) {
-        std::stringstream ss;
-        ss << "Could not write to file '"
-           << partFilename(i) << "':\n";
-        ss << strerror(errno) << std::endl;
-        throw std::runtime_error(ss.str());
+      _codecs[i]->close();
+    } catch (const std::exception& e) {
+      std::lock_guard<std::mutex> lock(errorMutex);
+      if (error.empty()) {
+        error = e.what();
       }
-      fclose(_rawFiles[i]);
     }
   }
-
-  for (size_t i = 0; i < _partCount; ++i) {
-    delete[] _outBuffers[i];
+  releaseBuffers();
+  if (!error.empty()) {
+    throw std::runtime_error(error);
   }
 
-  _open = false;
-
   // Handle merging of files
   switch (_config.mergeOutput) {
     case osm2rdf::util::OutputMergeMode::CONCATENATE:
-      concatenate();
+      if (_shardCount > 1) {
+        // No final file, each shard only joins its own parts.
+        const size_t partsPerShard = _partCount / _shardCount;
+        for (size_t i = 0; i < _shardCount; ++i) {
+          concatenate(shardFilename(i), i * partsPerShard, partsPerShard);
+        }
+      } else {
+        concatenate(_prefix, 0, _partCount);
+      }
       break;
     case osm2rdf::util::OutputMergeMode::NONE:
     default:
@@ -205,18 +235,98 @@ std::string osm2rdf::util::Output::partFilename(int part) {
 }
 
 // ____________________________________________________________________________
-void osm2rdf::util::Output::concatenate() {
-  // Reopen outfile as binary
+std::string osm2rdf::util::Output::shardFilename(size_t shard) {
+  std::ostringstream oss;
+  oss << _prefix << ".shard_" << std::setfill('0')
+      << std::setw(std::floor(std::log10(_shardCount)) + 1) << shard;
+  return oss.str();
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::Output::concatenate(const std::string& target,
+                                        size_t first, size_t count) {
   _outFile.close();
-  _outFile.open(_prefix, std::ofstream::out | std::ofstream::binary);
+  if (!concatenateZeroCopy(target, first, count) &&
+      !concatenateStream(target, first, count)) {
+    return;
+  }
+
+  if (!_config.outputKeepFiles) {
+    for (size_t i = first; i < first + count; ++i) {
+      std::filesystem::remove(partFilename(i));
+    }
+  }
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::util::Output::concatenateZeroCopy(const std::string& target,
+                                                size_t first, size_t count) {
+#if defined(__linux__)
+  std::vector<off_t> offsets(count + 1, 0);
+  for (size_t i = 0; i < count; ++i) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(partFilename(first + i), ec);
+    if (ec) {
+      return false;
+    }
+    offsets[i + 1] = offsets[i] + static_cast<off_t>(size);
+  }
+
+  int outFd = ::open(target.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (outFd < 0) {
+    return false;
+  }
+  // Reserve the space up front, unsupported filesystems just skip this.
+  // Setting the size allows all parts to be written at their offsets.
+  if (offsets[count] > 0) {
+    fallocate(outFd, 0, 0, offsets[count]);
+  }
+  bool ok = ftruncate(outFd, offsets[count]) == 0;
+  ::close(outFd);
+  if (!ok) {
+    return false;
+  }
+
+#pragma omp parallel for schedule(dynamic) reduction(&& : ok)
+  for (size_t i = 0; i < count; ++i) {
+    if (!ok || offsets[i + 1] == offsets[i]) {
+      continue;
+    }
+    int in = ::open(partFilename(first + i).c_str(), O_RDONLY);
+    // Own descriptor per part, sendfile writes at the file position.
+    int out = ::open(target.c_str(), O_WRONLY);
+    if (in >= 0 && out >= 0) {
+      ok = copyPart(in, out, offsets[i], offsets[i + 1] - offsets[i]);
+    } else {
+      ok = false;
+    }
+    if (in >= 0) {
+      ::close(in);
+    }
+    if (out >= 0) {
+      ::close(out);
+    }
+  }
+  return ok;
+#else
+  return false;
+#endif
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::util::Output::concatenateStream(const std::string& target,
+                                              size_t first, size_t count) {
+  // Reopen outfile as binary
+  _outFile.open(target, std::ofstream::out | std::ofstream::binary |
+                            std::ofstream::trunc);
   if (!_outFile.is_open()) {
-    std::cerr << "Can't reopen file: " << _prefix << " keeping files!"
+    std::cerr << "Can't reopen file: " << target << " keeping files!"
               << std::endl;
-    return;
+    return false;
   }
 
   // Content
-  for (size_t i = 0; i < _partCount; ++i) {
+  for (size_t i = first; i < first + count; ++i) {
     std::string filename = partFilename(i);
     std::ifstream inFile{filename, std::ifstream::binary};
     if (!inFile.is_open() || !inFile.good()) {
@@ -226,68 +336,83 @@ void osm2rdf::util::Output::concatenate() {
       _outFile << inFile.rdbuf();
     }
     inFile.close();
-    if (!_config.outputKeepFiles) {
-      std::filesystem::remove(filename);
-    }
   }
 
   _outFile.flush();
+  return true;
+}
+
+// ____________________________________________________________________________
+bool osm2rdf::util::Output::copyPart(int inFd, int outFd, size_t offset,
+                                     size_t len) {
+#if defined(__linux__)
+  // Shares the extents on filesystems with reflink support (btrfs, XFS).
+  // Requires block aligned offsets, which mostly holds for the first part.
+  file_clone_range range{};
+  range.src_fd = inFd;
+  range.src_length = len;
+  range.dest_offset = offset;
+  if (ioctl(outFd, FICLONERANGE, &range) == 0) {
+    return true;
+  }
+
+  // Copies inside the kernel and reflinks where possible.
+  loff_t inOff = 0;
+  loff_t outOff = static_cast<loff_t>(offset);
+  size_t copied = 0;
+  while (copied < len) {
+    ssize_t r = copy_file_range(inFd, &inOff, outFd, &outOff, len - copied, 0);
+    if (r < 0 && errno == EINTR) {
+      continue;
+    }
+    if (r <= 0) {
+      break;
+    }
+    copied += r;
+  }
+
+  // Kernels before 5.3 do not support copies between filesystems.
+  off_t sendOff = static_cast<off_t>(copied);
+  if (copied < len &&
+      lseek(outFd, static_cast<off_t>(offset + copied), SEEK_SET) < 0) {
+    return false;
+  }
+  while (copied < len) {
+    ssize_t r = sendfile(outFd, inFd, &sendOff, len - copied);
+    if (r < 0 && errno == EINTR) {
+      continue;
+    }
+    if (r <= 0) {
+      return false;
+    }
+    copied += r;
+  }
+  return true;
+#else
+  return false;
+#endif
 }
 
 // ____________________________________________________________________________
 void osm2rdf::util::Output::writeNewLine(size_t part) {
   write('\n', part);
-  _lines[part]++;
-  if (_toStdOut) {
-    if (_lines[part] > 50) flush(part);
+  endRecord(part);
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::Output::endRecord(size_t part) {
+  // Chunks for stdout always end with a complete record.
+  if (_toStdOut && _outBufPos[part] >= STDOUT_CHUNK_S) {
+    flush(part);
   }
 }
 
 // ____________________________________________________________________________
 void osm2rdf::util::Output::write(std::string_view strv, size_t t) {
   assert(t < _partCount);
-  if (_toStdOut) {
-    // on output to stdout, we only flush on newlines
-  } else if (_config.outputCompress == BZ2) {
-    if (_outBufPos[t] + strv.size() + 1 >= BUFFER_S) {
-      int err = 0;
-      BZ2_bzWrite(&err, _files[t], _outBuffers[t], _outBufPos[t]);
-      if (err == BZ_IO_ERROR) {
-        BZ2_bzWriteClose(&err, _files[t], 0, 0, 0);
-        std::stringstream ss;
-        ss << "Could not write to bzip2 file '"
-           << partFilename(t) << "':\n";
-        ss << strerror(errno) << std::endl;
-        throw std::runtime_error(ss.str());
-      }
-      _outBufPos[t] = 0;
-    }
-  } else if (_config.outputCompress == GZ) {
-    if (_outBufPos[t] + strv.size() + 1 >= BUFFER_S) {
-      int r = gzwrite(_gzFiles[t], _outBuffers[t], _outBufPos[t]);
-      if (r != (int)_outBufPos[t]) {
-        gzclose(_gzFiles[t]);
-        std::stringstream ss;
-        ss << "Could not write to gz file '"
-           << partFilename(t) << "':\n";
-        ss << strerror(errno) << std::endl;
-        throw std::runtime_error(ss.str());
-      }
-      _outBufPos[t] = 0;
-    }
-  } else {
-    if (_outBufPos[t] + strv.size() + 1 >= BUFFER_S) {
-      size_t r =
-          fwrite(_outBuffers[t], sizeof(char), _outBufPos[t], _rawFiles[t]);
-      if (r != _outBufPos[t]) {
-        std::stringstream ss;
-        ss << "Could not write to file '"
-           << partFilename(t) << "':\n";
-        ss << strerror(errno) << std::endl;
-        throw std::runtime_error(ss.str());
-      }
-      _outBufPos[t] = 0;
-    }
+  // on output to stdout, we only flush at the end of records
+  if (!_toStdOut && _outBufPos[t] + strv.size() + 1 >= BUFFER_S) {
+    flush(t);
   }
 
   if (_outBufPos[t] + strv.size() + 1 >= BUFFER_S) {
@@ -310,48 +435,9 @@ void osm2rdf::util::Output::write(std::string_view strv, size_t t) {
 // ____________________________________________________________________________
 void osm2rdf::util::Output::write(const char c, size_t t) {
   assert(t < _partCount);
-  if (_toStdOut) {
-    // on output to stdout, we only flush on newlines
-  } else if (_config.outputCompress == BZ2) {
-    if (_outBufPos[t] + 2 >= BUFFER_S) {
-      int err = 0;
-      BZ2_bzWrite(&err, _files[t], _outBuffers[t], _outBufPos[t]);
-      if (err == BZ_IO_ERROR) {
-        BZ2_bzWriteClose(&err, _files[t], 0, 0, 0);
-        std::stringstream ss;
-        ss << "Could not write to bzip2 file '"
-           << partFilename(t) << "':\n";
-        ss << strerror(errno) << std::endl;
-        throw std::runtime_error(ss.str());
-      }
-      _outBufPos[t] = 0;
-    }
-  } else if (_config.outputCompress == GZ) {
-    if (_outBufPos[t] + 2 >= BUFFER_S) {
-      int r = gzwrite(_gzFiles[t], _outBuffers[t], _outBufPos[t]);
-      if (r != (int)_outBufPos[t]) {
-        gzclose(_gzFiles[t]);
-        std::stringstream ss;
-        ss << "Could not write to gz file '"
-           << partFilename(t) << "':\n";
-        ss << strerror(errno) << std::endl;
-        throw std::runtime_error(ss.str());
-      }
-      _outBufPos[t] = 0;
-    }
-  } else {
-    if (_outBufPos[t] + 2 >= BUFFER_S) {
-      size_t r =
-          fwrite(_outBuffers[t], sizeof(char), _outBufPos[t], _rawFiles[t]);
-      if (r != _outBufPos[t]) {
-        std::stringstream ss;
-        ss << "Could not write to file '"
-           << partFilename(t) << "':\n";
-        ss << strerror(errno) << std::endl;
-        throw std::runtime_error(ss.str());
-      }
-      _outBufPos[t] = 0;
-    }
+  // on output to stdout, we only flush at the end of records
+  if (!_toStdOut && _outBufPos[t] + 2 >= BUFFER_S) {
+    flush(t);
   }
 
   if (_outBufPos[t] + 2 >= BUFFER_S) {
@@ -376,40 +462,163 @@ void osm2rdf::util::Output::flush() {
 // ____________________________________________________________________________
 void osm2rdf::util::Output::flush(size_t i) {
   if (_toStdOut) {
-    _lines[i] = 0;
-    _outBuffers[i][_outBufPos[i]] = '\0';
-    std::cout << reinterpret_cast<const char*>(_outBuffers[i]);
-  } else if (_config.outputCompress == BZ2) {
-    int err = 0;
-    BZ2_bzWrite(&err, _files[i], _outBuffers[i], _outBufPos[i]);
-    if (err == BZ_IO_ERROR) {
-      BZ2_bzWriteClose(&err, _files[i], 0, 0, 0);
-      std::stringstream ss;
-      ss << "Could not write to bzip2 file '"
-         << partFilename(i) << "':\n";
-      ss << strerror(errno) << std::endl;
-      throw std::runtime_error(ss.str());
+    if (_outBufPos[i] == 0) {
+      return;
     }
-  } else if (_config.outputCompress == GZ) {
-    int r = gzwrite(_gzFiles[i], _outBuffers[i], _outBufPos[i]);
-    if (r != (int)_outBufPos[i]) {
-          gzclose(_gzFiles[i]);
-      std::stringstream ss;
-      ss << "Could not write to gz file '"
-         << partFilename(i) << "':\n";
-      ss << strerror(errno) << std::endl;
-      throw std::runtime_error(ss.str());
+    _stdoutSink->submit(_outBuffers[i], _outBufPos[i]);
+    const auto start = std::chrono::steady_clock::now();
+    _outBuffers[i] = _stdoutSink->acquire();
+    _stallTimes[i] += std::chrono::steady_clock::now() - start;
+  } else if (_parallelCompress || _asyncWrite) {
+    if (_outBufPos[i] > 0) {
+      submitBlock(i);
     }
+    return;
   } else {
-    size_t r =
-        fwrite(_outBuffers[i], sizeof(char), _outBufPos[i], _rawFiles[i]);
-    if (r != _outBufPos[i]) {
-      std::stringstream ss;
-      ss << "Could not write to file '"
-         << partFilename(i) << "':\n";
-      ss << strerror(errno) << std::endl;
-      throw std::runtime_error(ss.str());
-    }
+    _codecs[i]->write(_outBuffers[i], _outBufPos[i]);
   }
   _outBufPos[i] = 0;
 }
+
+// ____________________________________________________________________________
+void osm2rdf::util::Output::submitBlock(size_t part) {
+  unsigned char* next = nullptr;
+  {
+    const auto start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(_compressMutex);
+    // Back pressure: do not let the producers run arbitrarily far ahead of
+    // the compression workers. Asynchronous writes are limited per part.
+    _compressCv.wait(lock, [this, part] {
+      if (!_compressError.empty()) {
+        return true;
+      }
+      if (_asyncWrite) {
+        return _blocksSubmitted[part] - _blocksWritten[part] <
+               ASYNC_BLOCKS_PER_PART;
+      }
+      return _blocksInFlight < _maxBlocksInFlight;
+    });
+    _stallTimes[part] += std::chrono::steady_clock::now() - start;
+    if (!_compressError.empty()) {
+      throw std::runtime_error(_compressError);
+    }
+    _compressJobs.push_back({part, _blocksSubmitted[part]++, _outBuffers[part],
+                             _outBufPos[part]});
+    _blocksInFlight++;
+    if (!_freeBuffers.empty()) {
+      next = _freeBuffers.back();
+      _freeBuffers.pop_back();
+    }
+  }
+  _compressCv.notify_all();
+
+  if (next == nullptr) {
+    next = new unsigned char[BUFFER_S];
+  }
+  _outBuffers[part] = next;
+  _outBufPos[part] = 0;
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::Output::releaseBuffers() {
+  for (auto* buf : _freeBuffers) {
+    delete[] buf;
+  }
+  _freeBuffers.clear();
+  for (size_t i = 0; i < _partCount; ++i) {
+    delete[] _outBuffers[i];
+    _outBuffers[i] = nullptr;
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::Output::waitForBlocks() {
+  std::unique_lock<std::mutex> lock(_compressMutex);
+  _compressCv.wait(lock, [this] { return _blocksInFlight == 0; });
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::Output::stopWorkers() {
+  waitForBlocks();
+  {
+    std::lock_guard<std::mutex> lock(_compressMutex);
+    _stopCompressWorkers = true;
+  }
+  _compressCv.notify_all();
+  for (auto& worker : _compressWorkers) {
+    worker.join();
+  }
+  _compressWorkers.clear();
+}
+
+// ____________________________________________________________________________
+double osm2rdf::util::Output::stallSeconds() const {
+  std::chrono::steady_clock::duration total{0};
+  for (const auto& t : _stallTimes) {
+    total += t;
+  }
+  return std::chrono::duration<double>(total).count();
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::Output::compressWorker() {
+  std::vector<char> compressed;
+  while (true) {
+    CompressJob job;
+    {
+      std::unique_lock<std::mutex> lock(_compressMutex);
+      _compressCv.wait(lock, [this] {
+        return !_compressJobs.empty() || _stopCompressWorkers;
+      });
+      if (_compressJobs.empty()) {
+        return;
+      }
+      job = _compressJobs.front();
+      _compressJobs.pop_front();
+    }
+
+    // Unless written asynchronously, each block becomes a complete stream.
+    // Concatenated streams are valid files for all codecs, so the parts stay
+    // readable by the usual tools and can still be merged with
+    // concatenate().
+    std::string error;
+    if (!_asyncWrite) {
+      try {
+        _codecs[job.part]->compressBlock(job.buf, job.len, &compressed);
+      } catch (const std::exception& e) {
+        error = e.what();
+      }
+    }
+
+    // Blocks of one part have to be appended in the order they were
+    // submitted.
+    std::unique_lock<std::mutex> lock(_compressMutex);
+    _compressCv.wait(lock, [this, &job] {
+      return _blocksWritten[job.part] == job.seq;
+    });
+    lock.unlock();
+
+    if (error.empty()) {
+      try {
+        if (_asyncWrite) {
+          // Streaming codecs compress and write the block in one go.
+          _codecs[job.part]->write(job.buf, job.len);
+        } else {
+          _codecs[job.part]->writeBlock(compressed);
+        }
+      } catch (const std::exception& e) {
+        error = e.what();
+      }
+    }
+
+    lock.lock();
+    if (!error.empty() && _compressError.empty()) {
+      _compressError = error;
+    }
+    _blocksWritten[job.part]++;
+    _blocksInFlight--;
+    _freeBuffers.push_back(job.buf);
+    lock.unlock();
+    _compressCv.notify_all();
+  }
+}
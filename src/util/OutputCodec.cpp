@@ -0,0 +1,457 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/util/OutputCodec.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "osm2rdf/config/Config.h"
+
+// Size of the intermediate output buffer of streaming codecs.
+static const size_t CODEC_BUFFER_S = 1024 * 1024;
+
+// ____________________________________________________________________________
+std::unique_ptr<osm2rdf::util::OutputCodec> osm2rdf::util::OutputCodec::create(
+    const osm2rdf::config::Config& config, size_t parts) {
+  switch (config.outputCompress) {
+    case osm2rdf::config::BZ2:
+      return std::make_unique<Bzip2Codec>(config.outputCompressionLevel);
+    case osm2rdf::config::GZ:
+      return std::make_unique<GzCodec>(config.outputCompressionLevel);
+    case osm2rdf::config::ZSTD:
+#if defined(OSM2RDF_HAVE_ZSTD)
+      // The threads are shared by all parts written at the same time.
+      return std::make_unique<ZstdCodec>(
+          config.outputCompressionLevel,
+          config.outputCompressionThreads / static_cast<int>(parts));
+#else
+      throw std::runtime_error("osm2rdf was built without zstd support");
+#endif
+    case osm2rdf::config::LZ4:
+#if defined(OSM2RDF_HAVE_LZ4)
+      return std::make_unique<Lz4Codec>(config.outputCompressionLevel);
+#else
+      throw std::runtime_error("osm2rdf was built without lz4 support");
+#endif
+    case osm2rdf::config::NONE:
+    default:
+      return std::make_unique<NoneCodec>();
+  }
+}
+
+// ____________________________________________________________________________
+osm2rdf::util::OutputCodec::OutputCodec(std::string name, int level)
+    : _name(std::move(name)), _level(level) {}
+
+// ____________________________________________________________________________
+osm2rdf::util::OutputCodec::~OutputCodec() {
+  if (_file != nullptr) {
+    fclose(_file);
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::OutputCodec::open(const std::string& filename,
+                                      bool streaming) {
+  _filename = filename;
+  _streaming = streaming;
+  _file = fopen(_filename.c_str(), "w");
+  if (_file == nullptr) {
+    std::stringstream ss;
+    ss << "Could not open " << _name << " '" << _filename
+       << "' for writing:\n";
+    ss << strerror(errno) << std::endl;
+    throw std::runtime_error(ss.str());
+  }
+  if (_streaming) {
+    beginStream();
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::OutputCodec::write(const unsigned char* data, size_t len) {
+  if (len == 0) {
+    return;
+  }
+  writeStream(data, len);
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::OutputCodec::writeBlock(const std::vector<char>& block) {
+  writeRaw(block.data(), block.size());
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::OutputCodec::close() {
+  if (_file == nullptr) {
+    return;
+  }
+  if (_streaming) {
+    endStream();
+  }
+  FILE* file = _file;
+  _file = nullptr;
+  if (fclose(file) != 0) {
+    fail(strerror(errno));
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::OutputCodec::writeRaw(const void* data, size_t len) {
+  size_t r = fwrite(data, sizeof(char), len, _file);
+  if (r != len) {
+    fail(strerror(errno));
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::OutputCodec::fail(const std::string& what) const {
+  std::stringstream ss;
+  ss << "Could not write to " << _name << " '" << _filename << "':\n";
+  ss << what << std::endl;
+  throw std::runtime_error(ss.str());
+}
+
+// ____________________________________________________________________________
+osm2rdf::util::NoneCodec::NoneCodec() : OutputCodec("file", 0) {}
+
+// ____________________________________________________________________________
+void osm2rdf::util::NoneCodec::compressBlock(const unsigned char* data,
+                                             size_t len,
+                                             std::vector<char>* out) const {
+  out->assign(data, data + len);
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::NoneCodec::writeStream(const unsigned char* data,
+                                           size_t len) {
+  writeRaw(data, len);
+}
+
+// ____________________________________________________________________________
+osm2rdf::util::Bzip2Codec::Bzip2Codec(int level)
+    : OutputCodec("bzip2 file", level == 0 ? 3 : level) {}
+
+// ____________________________________________________________________________
+osm2rdf::util::Bzip2Codec::~Bzip2Codec() {
+  if (_bzFile != nullptr) {
+    int err = 0;
+    BZ2_bzWriteClose(&err, _bzFile, 1, nullptr, nullptr);
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::Bzip2Codec::compressBlock(const unsigned char* data,
+                                              size_t len,
+                                              std::vector<char>* out) const {
+  // Worst case output size according to the libbzip2 manual is input + 1% +
+  // 600 bytes.
+  auto outLen = static_cast<unsigned int>(len + len / 100 + 600);
+  out->resize(outLen);
+  int err = BZ2_bzBuffToBuffCompress(
+      out->data(), &outLen,
+      const_cast<char*>(reinterpret_cast<const char*>(data)),
+      static_cast<unsigned int>(len), _level, 0, 30);
+  if (err != BZ_OK) {
+    fail("bzip2 error " + std::to_string(err));
+  }
+  out->resize(outLen);
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::Bzip2Codec::beginStream() {
+  int err = 0;
+  _bzFile = BZ2_bzWriteOpen(&err, _file, _level, 0, 30);
+  if (err != BZ_OK) {
+    std::stringstream ss;
+    ss << "Could not open bzip2 file '" << _filename << "' for writing:\n";
+    ss << strerror(errno) << std::endl;
+    throw std::runtime_error(ss.str());
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::Bzip2Codec::writeStream(const unsigned char* data,
+                                            size_t len) {
+  int err = 0;
+  BZ2_bzWrite(&err, _bzFile,
+              const_cast<void*>(static_cast<const void*>(data)),
+              static_cast<int>(len));
+  if (err == BZ_IO_ERROR) {
+    BZ2_bzWriteClose(&err, _bzFile, 1, nullptr, nullptr);
+    _bzFile = nullptr;
+    fail(strerror(errno));
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::Bzip2Codec::endStream() {
+  int err = 0;
+  BZ2_bzWriteClose(&err, _bzFile, 0, nullptr, nullptr);
+  _bzFile = nullptr;
+  if (err != BZ_OK) {
+    fail(strerror(errno));
+  }
+}
+
+// ____________________________________________________________________________
+osm2rdf::util::GzCodec::GzCodec(int level)
+    : OutputCodec("gz file", level == 0 ? Z_DEFAULT_COMPRESSION : level) {}
+
+// ____________________________________________________________________________
+osm2rdf::util::GzCodec::~GzCodec() {
+  if (!_out.empty()) {
+    deflateEnd(&_stream);
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::GzCodec::compressBlock(const unsigned char* data,
+                                           size_t len,
+                                           std::vector<char>* out) const {
+  z_stream stream{};
+  // windowBits + 16 writes a gzip header and trailer.
+  if (deflateInit2(&stream, _level, Z_DEFLATED, 15 + 16, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    fail("zlib initialization failed");
+  }
+  out->resize(deflateBound(&stream, len));
+  stream.next_in = const_cast<Bytef*>(data);
+  stream.avail_in = static_cast<uInt>(len);
+  stream.next_out = reinterpret_cast<Bytef*>(out->data());
+  stream.avail_out = static_cast<uInt>(out->size());
+  int err = deflate(&stream, Z_FINISH);
+  out->resize(stream.total_out);
+  deflateEnd(&stream);
+  if (err != Z_STREAM_END) {
+    fail("zlib error " + std::to_string(err));
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::GzCodec::beginStream() {
+  _stream = z_stream{};
+  if (deflateInit2(&_stream, _level, Z_DEFLATED, 15 + 16, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    std::stringstream ss;
+    ss << "Could not open gz file '" << _filename << "' for writing:\n";
+    ss << "zlib initialization failed" << std::endl;
+    throw std::runtime_error(ss.str());
+  }
+  _out.resize(CODEC_BUFFER_S);
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::GzCodec::writeStream(const unsigned char* data,
+                                         size_t len) {
+  // avail_in is 32 bit, feed larger buffers in pieces.
+  while (len > 0) {
+    auto chunk = std::min<size_t>(len, 1U << 30U);
+    _stream.next_in = const_cast<Bytef*>(data);
+    _stream.avail_in = static_cast<uInt>(chunk);
+    deflateStream(Z_NO_FLUSH);
+    data += chunk;
+    len -= chunk;
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::GzCodec::endStream() {
+  _stream.next_in = nullptr;
+  _stream.avail_in = 0;
+  deflateStream(Z_FINISH);
+  deflateEnd(&_stream);
+  _out.clear();
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::GzCodec::deflateStream(int flush) {
+  int err;
+  do {
+    _stream.next_out = _out.data();
+    _stream.avail_out = static_cast<uInt>(_out.size());
+    err = deflate(&_stream, flush);
+    if (err == Z_STREAM_ERROR) {
+      fail("zlib error " + std::to_string(err));
+    }
+    writeRaw(_out.data(), _out.size() - _stream.avail_out);
+  } while (_stream.avail_out == 0 ||
+           (flush == Z_FINISH && err != Z_STREAM_END));
+}
+
+#if defined(OSM2RDF_HAVE_ZSTD)
+// ____________________________________________________________________________
+osm2rdf::util::ZstdCodec::ZstdCodec(int level, int threads)
+    : OutputCodec("zstd file", level), _threads(threads) {}
+
+// ____________________________________________________________________________
+osm2rdf::util::ZstdCodec::~ZstdCodec() { ZSTD_freeCCtx(_ctx); }
+
+// ____________________________________________________________________________
+bool osm2rdf::util::ZstdCodec::compressesInParallel() const {
+  return _threads > 0;
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::ZstdCodec::compressBlock(const unsigned char* data,
+                                             size_t len,
+                                             std::vector<char>* out) const {
+  // Same frame parameters as the stream, blocks can be called concurrently
+  // and use their own context.
+  ZSTD_CCtx* ctx = ZSTD_createCCtx();
+  if (ctx == nullptr) {
+    fail("zstd initialization failed");
+  }
+  ZSTD_CCtx_setParameter(ctx, ZSTD_c_compressionLevel, _level);
+  ZSTD_CCtx_setParameter(ctx, ZSTD_c_checksumFlag, 1);
+  out->resize(ZSTD_compressBound(len));
+  size_t r = ZSTD_compress2(ctx, out->data(), out->size(), data, len);
+  ZSTD_freeCCtx(ctx);
+  if (ZSTD_isError(r)) {
+    fail(ZSTD_getErrorName(r));
+  }
+  out->resize(r);
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::ZstdCodec::beginStream() {
+  _ctx = ZSTD_createCCtx();
+  if (_ctx == nullptr) {
+    std::stringstream ss;
+    ss << "Could not open zstd file '" << _filename << "' for writing:\n";
+    ss << "zstd initialization failed" << std::endl;
+    throw std::runtime_error(ss.str());
+  }
+  ZSTD_CCtx_setParameter(_ctx, ZSTD_c_compressionLevel, _level);
+  ZSTD_CCtx_setParameter(_ctx, ZSTD_c_checksumFlag, 1);
+  if (_threads > 0) {
+    // With workers ZSTD_compressStream2 only hands the input over and
+    // returns, compression runs in the background. A libzstd without
+    // multithreading support rejects the parameter and stays single
+    // threaded.
+    ZSTD_CCtx_setParameter(_ctx, ZSTD_c_nbWorkers, _threads);
+  }
+  _out.resize(ZSTD_CStreamOutSize());
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::ZstdCodec::writeStream(const unsigned char* data,
+                                           size_t len) {
+  ZSTD_inBuffer in{data, len, 0};
+  compressStream(&in, ZSTD_e_continue);
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::ZstdCodec::endStream() {
+  ZSTD_inBuffer in{nullptr, 0, 0};
+  compressStream(&in, ZSTD_e_end);
+  ZSTD_freeCCtx(_ctx);
+  _ctx = nullptr;
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::ZstdCodec::compressStream(ZSTD_inBuffer* in,
+                                              ZSTD_EndDirective mode) {
+  bool done;
+  do {
+    ZSTD_outBuffer out{_out.data(), _out.size(), 0};
+    size_t remaining = ZSTD_compressStream2(_ctx, &out, in, mode);
+    if (ZSTD_isError(remaining)) {
+      fail(ZSTD_getErrorName(remaining));
+    }
+    writeRaw(_out.data(), out.pos);
+    done = mode == ZSTD_e_end ? remaining == 0 : in->pos == in->size;
+  } while (!done);
+}
+#endif
+
+#if defined(OSM2RDF_HAVE_LZ4)
+// ____________________________________________________________________________
+osm2rdf::util::Lz4Codec::Lz4Codec(int level) : OutputCodec("lz4 file", level) {
+  _prefs.compressionLevel = _level;
+  _prefs.frameInfo.blockSizeID = LZ4F_max4MB;
+  _prefs.frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
+}
+
+// ____________________________________________________________________________
+osm2rdf::util::Lz4Codec::~Lz4Codec() { LZ4F_freeCompressionContext(_ctx); }
+
+// ____________________________________________________________________________
+void osm2rdf::util::Lz4Codec::compressBlock(const unsigned char* data,
+                                            size_t len,
+                                            std::vector<char>* out) const {
+  out->resize(LZ4F_compressFrameBound(len, &_prefs));
+  size_t r = LZ4F_compressFrame(out->data(), out->size(), data, len, &_prefs);
+  if (LZ4F_isError(r)) {
+    fail(LZ4F_getErrorName(r));
+  }
+  out->resize(r);
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::Lz4Codec::beginStream() {
+  size_t r = LZ4F_createCompressionContext(&_ctx, LZ4F_VERSION);
+  if (LZ4F_isError(r)) {
+    std::stringstream ss;
+    ss << "Could not open lz4 file '" << _filename << "' for writing:\n";
+    ss << LZ4F_getErrorName(r) << std::endl;
+    throw std::runtime_error(ss.str());
+  }
+  _out.resize(LZ4F_compressBound(CODEC_BUFFER_S, &_prefs));
+  r = LZ4F_compressBegin(_ctx, _out.data(), _out.size(), &_prefs);
+  if (LZ4F_isError(r)) {
+    fail(LZ4F_getErrorName(r));
+  }
+  writeRaw(_out.data(), r);
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::Lz4Codec::writeStream(const unsigned char* data,
+                                          size_t len) {
+  // _out is sized for inputs up to CODEC_BUFFER_S bytes.
+  while (len > 0) {
+    size_t chunk = std::min(len, CODEC_BUFFER_S);
+    size_t r = LZ4F_compressUpdate(_ctx, _out.data(), _out.size(), data,
+                                   chunk, nullptr);
+    if (LZ4F_isError(r)) {
+      fail(LZ4F_getErrorName(r));
+    }
+    writeRaw(_out.data(), r);
+    data += chunk;
+    len -= chunk;
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::Lz4Codec::endStream() {
+  size_t r = LZ4F_compressEnd(_ctx, _out.data(), _out.size(), nullptr);
+  if (LZ4F_isError(r)) {
+    fail(LZ4F_getErrorName(r));
+  }
+  writeRaw(_out.data(), r);
+  LZ4F_freeCompressionContext(_ctx);
+  _ctx = nullptr;
+}
+#endif
@@ -0,0 +1,212 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/util/Simd.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define OSM2RDF_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace osm2rdf::util::simd {
+
+// Each char class is a struct with a scalar test and, on x86, tests
+// returning a byte mask for 16 (SSE2) and 32 (AVX2) chars. Signed compares
+// are used throughout, bytes >= 0x80 are negative.
+
+// ____________________________________________________________________________
+struct LiteralEscape {
+  static bool scalar(unsigned char c) {
+    return c == '"' || c == '\\' || c == '\n' || c == '\r';
+  }
+#if defined(OSM2RDF_SIMD_X86)
+  __attribute__((target("sse2"))) static __m128i sse2(__m128i v) {
+    return _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')),
+                     _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))),
+        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')),
+                     _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'))));
+  }
+  __attribute__((target("avx2"))) static __m256i avx2(__m256i v) {
+    return _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')),
+                        _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))),
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')),
+                        _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r'))));
+  }
+#endif
+};
+
+// ____________________________________________________________________________
+struct IRIREFEscape {
+  static bool scalar(unsigned char c) {
+    return c <= ' ' || c >= 0x80 || c == '<' || c == '>' || c == '"' ||
+           c == '{' || c == '}' || c == '|' || c == '^' || c == '`' ||
+           c == '\\';
+  }
+#if defined(OSM2RDF_SIMD_X86)
+  __attribute__((target("sse2"))) static __m128i sse2(__m128i v) {
+    // c < 0x21 (signed) covers #x00-#x20 and all non-ASCII bytes.
+    __m128i m = _mm_cmplt_epi8(v, _mm_set1_epi8(0x21));
+    for (char c : {'<', '>', '"', '{', '}', '|', '^', '`', '\\'}) {
+      m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8(c)));
+    }
+    return m;
+  }
+  __attribute__((target("avx2"))) static __m256i avx2(__m256i v) {
+    __m256i m = _mm256_cmpgt_epi8(_mm256_set1_epi8(0x21), v);
+    for (char c : {'<', '>', '"', '{', '}', '|', '^', '`', '\\'}) {
+      m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)));
+    }
+    return m;
+  }
+#endif
+};
+
+// ____________________________________________________________________________
+struct PN_LOCALSpecial {
+  static bool scalar(unsigned char c) {
+    return !((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
+             (c >= '0' && c <= ':') || c == '_');
+  }
+#if defined(OSM2RDF_SIMD_X86)
+  __attribute__((target("sse2"))) static __m128i inRange(__m128i v, char lo,
+                                                         char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)),
+                         _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+  }
+  __attribute__((target("sse2"))) static __m128i sse2(__m128i v) {
+    // ':' directly follows '9'.
+    __m128i ok = _mm_or_si128(
+        _mm_or_si128(inRange(v, 'A', 'Z'), inRange(v, 'a', 'z')),
+        _mm_or_si128(inRange(v, '0', ':'),
+                     _mm_cmpeq_epi8(v, _mm_set1_epi8('_'))));
+    return _mm_andnot_si128(ok, _mm_set1_epi8(-1));
+  }
+  __attribute__((target("avx2"))) static __m256i inRange(__m256i v, char lo,
+                                                         char hi) {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(lo - 1)),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8(hi + 1), v));
+  }
+  __attribute__((target("avx2"))) static __m256i avx2(__m256i v) {
+    __m256i ok = _mm256_or_si256(
+        _mm256_or_si256(inRange(v, 'A', 'Z'), inRange(v, 'a', 'z')),
+        _mm256_or_si256(inRange(v, '0', ':'),
+                        _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_'))));
+    return _mm256_andnot_si256(ok, _mm256_set1_epi8(-1));
+  }
+#endif
+};
+
+// ____________________________________________________________________________
+template <typename C>
+size_t findScalar(std::string_view s, size_t pos) {
+  for (; pos < s.size(); ++pos) {
+    if (C::scalar(static_cast<unsigned char>(s[pos]))) {
+      return pos;
+    }
+  }
+  return s.size();
+}
+
+#if defined(OSM2RDF_SIMD_X86)
+// ____________________________________________________________________________
+template <typename C>
+__attribute__((target("sse2"))) size_t findSse2(std::string_view s) {
+  const char* data = s.data();
+  size_t pos = 0;
+  for (; pos + sizeof(__m128i) <= s.size(); pos += sizeof(__m128i)) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+    auto mask = static_cast<unsigned>(_mm_movemask_epi8(C::sse2(v)));
+    if (mask != 0) {
+      return pos + __builtin_ctz(mask);
+    }
+  }
+  return findScalar<C>(s, pos);
+}
+
+// ____________________________________________________________________________
+template <typename C>
+__attribute__((target("avx2"))) size_t findAvx2(std::string_view s) {
+  const char* data = s.data();
+  size_t pos = 0;
+  for (; pos + sizeof(__m256i) <= s.size(); pos += sizeof(__m256i)) {
+    __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+    auto mask = static_cast<unsigned>(_mm256_movemask_epi8(C::avx2(v)));
+    if (mask != 0) {
+      return pos + __builtin_ctz(mask);
+    }
+  }
+  return findScalar<C>(s, pos);
+}
+#endif
+
+// ____________________________________________________________________________
+Level detectLevel() {
+#if defined(OSM2RDF_SIMD_X86)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return Level::AVX2;
+  }
+  return Level::SSE2;
+#else
+  return Level::SCALAR;
+#endif
+}
+
+// Level used by the find functions.
+static Level currentLevel = detectLevel();
+
+// ____________________________________________________________________________
+Level level() { return currentLevel; }
+
+// ____________________________________________________________________________
+void setLevel(Level level) { currentLevel = std::min(level, detectLevel()); }
+
+// ____________________________________________________________________________
+template <typename C>
+size_t find(std::string_view s) {
+  switch (currentLevel) {
+#if defined(OSM2RDF_SIMD_X86)
+    case Level::AVX2:
+      return findAvx2<C>(s);
+    case Level::SSE2:
+      return findSse2<C>(s);
+#endif
+    default:
+      return findScalar<C>(s, 0);
+  }
+}
+
+// ____________________________________________________________________________
+size_t findLiteralEscape(std::string_view s) {
+  return find<LiteralEscape>(s);
+}
+
+// ____________________________________________________________________________
+size_t findIRIREFEscape(std::string_view s) { return find<IRIREFEscape>(s); }
+
+// ____________________________________________________________________________
+size_t findPN_LOCALSpecial(std::string_view s) {
+  return find<PN_LOCALSpecial>(s);
+}
+
+}  // namespace osm2rdf::util::simd
@@ -0,0 +1,268 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/util/StdoutSink.h"
+
+#include <poll.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "osm2rdf/config/Config.h"
+#include "osm2rdf/util/OutputCodec.h"
+
+// Maximal number of chunks written with a single writev.
+static const size_t WRITE_BATCH = 64;
+
+// ____________________________________________________________________________
+osm2rdf::util::StdoutSink::StdoutSink(const osm2rdf::config::Config& config,
+                                      size_t chunkSize, size_t maxChunks,
+                                      int fd)
+    : _chunkSize(chunkSize),
+      _maxChunks(maxChunks),
+      _fd(fd),
+      _full(maxChunks),
+      _free(maxChunks) {
+  if (config.outputCompress != osm2rdf::config::NONE) {
+    _codec = OutputCodec::create(config);
+  }
+}
+
+// ____________________________________________________________________________
+osm2rdf::util::StdoutSink::StdoutSink(const osm2rdf::config::Config& config,
+                                      size_t chunkSize, size_t maxChunks,
+                                      std::ostream* stream)
+    : StdoutSink(config, chunkSize, maxChunks, -1) {
+  _stream = stream;
+}
+
+// ____________________________________________________________________________
+osm2rdf::util::StdoutSink::~StdoutSink() {
+  if (_writer.joinable()) {
+    _closing.store(true, std::memory_order_release);
+    notify(&_fullCv);
+    _writer.join();
+  }
+  releaseChunks();
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::StdoutSink::open() {
+  // Everything written through std::cout so far has to appear first.
+  std::cout.flush();
+  _closing = false;
+  _failed = false;
+  _error.clear();
+  _writer = std::thread(&StdoutSink::run, this);
+}
+
+// ____________________________________________________________________________
+unsigned char* osm2rdf::util::StdoutSink::acquire() {
+  unsigned char* chunk = nullptr;
+  while (!_free.pop(&chunk)) {
+    size_t allocated = _allocated.load(std::memory_order_relaxed);
+    if (allocated < _maxChunks) {
+      if (_allocated.compare_exchange_weak(allocated, allocated + 1)) {
+        return new unsigned char[_chunkSize];
+      }
+      continue;
+    }
+    // All chunks are queued, wait for the writer.
+    std::unique_lock<std::mutex> lock(_mutex);
+    _freeCv.wait(lock, [this, &chunk] { return _free.pop(&chunk); });
+    break;
+  }
+  return chunk;
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::StdoutSink::submit(unsigned char* chunk, size_t len) {
+  // The queue holds all chunks, this only spins on concurrent pushes.
+  while (!_full.push({chunk, len})) {
+    std::this_thread::yield();
+  }
+  notify(&_fullCv);
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::StdoutSink::close() {
+  if (!_writer.joinable()) {
+    return;
+  }
+  _closing.store(true, std::memory_order_release);
+  notify(&_fullCv);
+  _writer.join();
+  releaseChunks();
+  if (_stream != nullptr) {
+    _stream->flush();
+  }
+  if (_failed) {
+    throw std::runtime_error(_error);
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::StdoutSink::run() {
+  std::vector<Chunk> batch;
+  while (true) {
+    Chunk chunk{};
+    while (batch.size() < WRITE_BATCH && _full.pop(&chunk)) {
+      batch.push_back(chunk);
+    }
+    if (batch.empty()) {
+      // Sleeps until a chunk is submitted or the sink is closed. The flag is
+      // read before the queue, close() sets it after the last submit.
+      std::unique_lock<std::mutex> lock(_mutex);
+      _fullCv.wait(lock, [this, &batch, &chunk] {
+        const bool closing = _closing.load(std::memory_order_acquire);
+        if (_full.pop(&chunk)) {
+          batch.push_back(chunk);
+          return true;
+        }
+        return closing;
+      });
+      if (batch.empty()) {
+        return;
+      }
+    }
+    writeChunks(batch);
+    for (const auto& c : batch) {
+      _free.push(c.data);
+    }
+    batch.clear();
+    notify(&_freeCv);
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::StdoutSink::writeChunks(const std::vector<Chunk>& chunks) {
+  if (_failed) {
+    return;
+  }
+  std::vector<struct iovec> iov(chunks.size());
+  if (_compressed.size() < chunks.size()) {
+    _compressed.resize(chunks.size());
+  }
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    if (chunks[i].len == 0) {
+      iov[i].iov_base = nullptr;
+      iov[i].iov_len = 0;
+    } else if (_codec) {
+      // Each chunk becomes an independent stream, concatenated streams are
+      // valid for all codecs.
+      try {
+        _codec->compressBlock(chunks[i].data, chunks[i].len, &_compressed[i]);
+      } catch (const std::exception& e) {
+        fail(e.what());
+        return;
+      }
+      iov[i].iov_base = _compressed[i].data();
+      iov[i].iov_len = _compressed[i].size();
+    } else {
+      iov[i].iov_base = chunks[i].data;
+      iov[i].iov_len = chunks[i].len;
+    }
+  }
+
+  if (_stream != nullptr) {
+    for (const auto& v : iov) {
+      _stream->write(static_cast<const char*>(v.iov_base),
+                     static_cast<std::streamsize>(v.iov_len));
+    }
+    if (!*_stream) {
+      fail("Could not write to stdout\n");
+    }
+    return;
+  }
+  writeFd(&iov);
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::StdoutSink::writeFd(std::vector<struct iovec>* iov) {
+  size_t first = 0;
+  while (first < iov->size()) {
+    auto count =
+        static_cast<int>(std::min<size_t>(iov->size() - first, IOV_MAX));
+    ssize_t r = writev(_fd, iov->data() + first, count);
+    if (r < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        // Inherited non-blocking descriptor, wait until it is writable.
+        struct pollfd pfd = {_fd, POLLOUT, 0};
+        ::poll(&pfd, 1, -1);
+        continue;
+      }
+      std::stringstream ss;
+      ss << "Could not write to stdout:\n";
+      ss << strerror(errno) << std::endl;
+      fail(ss.str());
+      return;
+    }
+    // Skip everything written, continue inside a partially written iovec.
+    auto written = static_cast<size_t>(r);
+    while (first < iov->size() && written >= (*iov)[first].iov_len) {
+      written -= (*iov)[first].iov_len;
+      first++;
+    }
+    if (written > 0) {
+      (*iov)[first].iov_base =
+          static_cast<char*>((*iov)[first].iov_base) + written;
+      (*iov)[first].iov_len -= written;
+    }
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::StdoutSink::fail(const std::string& error) {
+  if (!_failed) {
+    _error = error;
+    _failed = true;
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::StdoutSink::releaseChunks() {
+  unsigned char* chunk = nullptr;
+  while (_free.pop(&chunk)) {
+    delete[] chunk;
+    _allocated--;
+  }
+  Chunk c{};
+  while (_full.pop(&c)) {
+    delete[] c.data;
+    _allocated--;
+  }
+}
+
+// ____________________________________________________________________________
+void osm2rdf::util::StdoutSink::notify(std::condition_variable* cv) {
+  // Taking the lock orders the notification after the waiter's check of the
+  // queue, no wakeup is lost.
+  { std::lock_guard<std::mutex> lock(_mutex); }
+  cv->notify_all();
+}
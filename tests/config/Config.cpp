@@ -32,6 +32,10 @@ void assertDefaultConfig(const osm2rdf::config::Config& config) {
   ASSERT_FALSE(config.noFacts);
   ASSERT_FALSE(config.noGeometricRelations);
   ASSERT_TRUE(config.storeLocations.empty());
+  ASSERT_EQ(osm2rdf::config::NO_HUGE_PAGES, config.storeLocationsHugePages);
+  ASSERT_EQ(osm2rdf::config::NUMA_LOCAL, config.storeLocationsNuma);
+  ASSERT_FALSE(config.storeLocationsReferencedOnly);
+  ASSERT_FALSE(config.nodesFirstPass);
 
   ASSERT_FALSE(config.noAreaFacts);
   ASSERT_FALSE(config.noNodeFacts);
@@ -40,6 +44,13 @@ void assertDefaultConfig(const osm2rdf::config::Config& config) {
   ASSERT_FALSE(config.noAreaGeometricRelations);
   ASSERT_FALSE(config.noNodeGeometricRelations);
   ASSERT_FALSE(config.noWayGeometricRelations);
+  ASSERT_TRUE(config.addIntersectsRelations);
+  ASSERT_TRUE(config.addContainsRelations);
+  ASSERT_TRUE(config.addCoversRelations);
+  ASSERT_TRUE(config.addTouchesRelations);
+  ASSERT_TRUE(config.addEqualsRelations);
+  ASSERT_TRUE(config.addOverlapsRelations);
+  ASSERT_TRUE(config.addCrossesRelations);
 
   ASSERT_FALSE(config.addAreaWayLinestrings);
   ASSERT_FALSE(config.addWayNodeOrder);
@@ -52,13 +63,24 @@ void assertDefaultConfig(const osm2rdf::config::Config& config) {
   ASSERT_FALSE(config.writeRDFStatistics);
 
   ASSERT_EQ(0, config.simplifyGeometries);
+  ASSERT_TRUE(config.geometryState.empty());
+  ASSERT_FALSE(config.sortGeometries);
+  ASSERT_EQ(0, config.geometryTiles);
+  ASSERT_EQ(1, config.geometryTileWorkers);
+  ASSERT_EQ("", config.geometryTileWorker);
+  ASSERT_EQ(600, config.geometryTileTimeout);
   ASSERT_EQ(0, config.simplifyWKT);
   ASSERT_EQ(5, config.wktDeviation);
   ASSERT_EQ(7, config.wktPrecision);
 
   ASSERT_EQ(osm2rdf::util::OutputMergeMode::CONCATENATE, config.mergeOutput);
   ASSERT_TRUE(config.outputCompress);
+  ASSERT_EQ(0, config.outputCompressionThreads);
+  ASSERT_EQ(0, config.outputCompressionLevel);
+  ASSERT_FALSE(config.outputAsyncWrite);
   ASSERT_FALSE(config.outputKeepFiles);
+  ASSERT_FALSE(config.outputGroupSubjects);
+  ASSERT_EQ(0, config.outputShards);
 
   ASSERT_EQ(std::filesystem::temp_directory_path(), config.cache);
 }
@@ -367,6 +389,86 @@ TEST(CONFIG_Config, fromArgsStoreLocationsLongDense) {
   ASSERT_EQ("dense", config.storeLocations);
 }
 
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsStoreLocationsHugePagesLong) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg = "--" +
+                   osm2rdf::config::constants::STORE_LOCATIONS_HUGE_PAGES_LONG +
+                   "=1g";
+  const int argc = 3;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  ASSERT_EQ(osm2rdf::config::HUGE_PAGES_1G, config.storeLocationsHugePages);
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsStoreLocationsNumaLong) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg = "--" +
+                   osm2rdf::config::constants::STORE_LOCATIONS_NUMA_LONG +
+                   "=replicate";
+  const int argc = 3;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  ASSERT_EQ(osm2rdf::config::NUMA_REPLICATE, config.storeLocationsNuma);
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsStoreLocationsReferencedOnlyLong) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg =
+      "--" + osm2rdf::config::constants::STORE_LOCATIONS_REFERENCED_ONLY_LONG;
+  const int argc = 3;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  ASSERT_TRUE(config.storeLocationsReferencedOnly);
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsNodesFirstPassLong) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg = "--" + osm2rdf::config::constants::NODES_FIRST_PASS_LONG;
+  const int argc = 3;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  ASSERT_TRUE(config.nodesFirstPass);
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsNodesFirstPassMemDense) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg = "--" + osm2rdf::config::constants::NODES_FIRST_PASS_LONG;
+  const auto arg2 = "--" + osm2rdf::config::constants::STORE_LOCATIONS_LONG +
+                    "=mem-dense";
+  const int argc = 4;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>(arg2.c_str()),
+                      const_cast<char*>("/tmp/dummyInput")};
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  ASSERT_EXIT(config.fromArgs(argc, argv),
+              ::testing::ExitedWithCode(osm2rdf::config::ExitCode::FAILURE),
+              "^Invalid Option");
+}
+
 // ____________________________________________________________________________
 TEST(CONFIG_Config, fromArgsNoAreasLong) {
   osm2rdf::config::Config config;
@@ -644,6 +746,176 @@ TEST(CONFIG_Config, fromArgsSimplifyGeometriesLong) {
   ASSERT_EQ(25, config.simplifyGeometries);
 }
 
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsGeometryStateLong) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg =
+      "--" + osm2rdf::config::constants::GEOMETRY_STATE_OPTION_LONG;
+  const int argc = 4;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("/tmp/state"),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  ASSERT_EQ("/tmp/state", config.geometryState.string());
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsSortGeometriesLong) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg =
+      "--" + osm2rdf::config::constants::SORT_GEOMETRIES_OPTION_LONG;
+  const int argc = 3;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  ASSERT_TRUE(config.sortGeometries);
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsGeometryTilesLong) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg =
+      "--" + osm2rdf::config::constants::GEOMETRY_TILES_OPTION_LONG;
+  const auto arg2 =
+      "--" + osm2rdf::config::constants::GEOMETRY_TILE_WORKERS_OPTION_LONG;
+  const int argc = 6;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("4"), const_cast<char*>(arg2.c_str()),
+                      const_cast<char*>("0"),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  ASSERT_EQ(4, config.geometryTiles);
+  ASSERT_EQ(0, config.geometryTileWorkers);
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsGeometryTileWorkerLong) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg =
+      "--" + osm2rdf::config::constants::GEOMETRY_TILE_WORKER_OPTION_LONG;
+  const auto arg2 =
+      "--" + osm2rdf::config::constants::GEOMETRY_TILE_TIMEOUT_OPTION_LONG;
+  const int argc = 6;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("/opt/osm2rdf-tile"),
+                      const_cast<char*>(arg2.c_str()),
+                      const_cast<char*>("60"),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  ASSERT_EQ("/opt/osm2rdf-tile", config.geometryTileWorker);
+  ASSERT_EQ(60, config.geometryTileTimeout);
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsGeometryTileTimeoutInvalid) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg =
+      "--" + osm2rdf::config::constants::GEOMETRY_TILE_TIMEOUT_OPTION_LONG;
+  const int argc = 4;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("5"),
+                      const_cast<char*>("/tmp/dummyInput")};
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  ASSERT_EXIT(config.fromArgs(argc, argv),
+              ::testing::ExitedWithCode(osm2rdf::config::ExitCode::FAILURE),
+              "^Invalid Option");
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsGeometryTilesInvalid) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg =
+      "--" + osm2rdf::config::constants::GEOMETRY_TILES_OPTION_LONG;
+  const int argc = 4;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("0"),
+                      const_cast<char*>("/tmp/dummyInput")};
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  ASSERT_EXIT(config.fromArgs(argc, argv),
+              ::testing::ExitedWithCode(osm2rdf::config::ExitCode::FAILURE),
+              "^Invalid Option");
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsGeometricPredicatesLong) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg =
+      "--" + osm2rdf::config::constants::GEOMETRIC_PREDICATES_OPTION_LONG;
+  const int argc = 4;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("contains,intersects"),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  ASSERT_TRUE(config.addIntersectsRelations);
+  ASSERT_TRUE(config.addContainsRelations);
+  ASSERT_FALSE(config.addCoversRelations);
+  ASSERT_FALSE(config.addTouchesRelations);
+  ASSERT_FALSE(config.addEqualsRelations);
+  ASSERT_FALSE(config.addOverlapsRelations);
+  ASSERT_FALSE(config.addCrossesRelations);
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsGeometricPredicatesInvalid) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg =
+      "--" + osm2rdf::config::constants::GEOMETRIC_PREDICATES_OPTION_LONG;
+  const int argc = 4;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("contains,within"),
+                      const_cast<char*>("/tmp/dummyInput")};
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  ASSERT_EXIT(config.fromArgs(argc, argv),
+              ::testing::ExitedWithCode(osm2rdf::config::ExitCode::FAILURE),
+              "^Invalid Option");
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsGeometryStateAuxGeoFiles) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg =
+      "--" + osm2rdf::config::constants::GEOMETRY_STATE_OPTION_LONG;
+  const auto arg2 =
+      "--" + osm2rdf::config::constants::AUX_GEO_FILES_OPTION_LONG;
+  const int argc = 6;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("/tmp/state"),
+                      const_cast<char*>(arg2.c_str()),
+                      const_cast<char*>("/tmp/aux"),
+                      const_cast<char*>("/tmp/dummyInput")};
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  ASSERT_EXIT(config.fromArgs(argc, argv),
+              ::testing::ExitedWithCode(osm2rdf::config::ExitCode::FAILURE),
+              "^Invalid Option");
+}
+
 // ____________________________________________________________________________
 TEST(CONFIG_Config, fromArgsSimplifyWKTLong) {
   osm2rdf::config::Config config;
@@ -764,6 +1036,145 @@ TEST(CONFIG_Config, fromArgsOutputKeepFilesLong) {
   ASSERT_TRUE(config.outputKeepFiles);
 }
 
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsOutputGroupSubjectsLong) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg =
+      "--" + osm2rdf::config::constants::OUTPUT_GROUP_SUBJECTS_OPTION_LONG;
+  const int argc = 3;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  ASSERT_EQ("", config.output.string());
+  ASSERT_TRUE(config.outputGroupSubjects);
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsOutputShardsLong) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto output = "-" + osm2rdf::config::constants::OUTPUT_OPTION_SHORT;
+  const auto arg = "--" + osm2rdf::config::constants::OUTPUT_SHARDS_OPTION_LONG;
+  const int argc = 6;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(output.c_str()),
+                      const_cast<char*>("/tmp/output"),
+                      const_cast<char*>(arg.c_str()), const_cast<char*>("8"),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  ASSERT_EQ(8, config.outputShards);
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsOutputShardsStdout) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg = "--" + osm2rdf::config::constants::OUTPUT_SHARDS_OPTION_LONG;
+  const int argc = 4;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("8"),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  // Output to stdout is a single stream.
+  ASSERT_EQ(0, config.outputShards);
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsOutputCompressionThreadsLong) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg =
+      "--" + osm2rdf::config::constants::OUTPUT_COMPRESSION_THREADS_OPTION_LONG;
+  const int argc = 4;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("4"),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  ASSERT_EQ(4, config.outputCompressionThreads);
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsOutputCompressionLevelLong) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg =
+      "--" + osm2rdf::config::constants::OUTPUT_COMPRESSION_LEVEL_OPTION_LONG;
+  const int argc = 4;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("9"),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  ASSERT_EQ(9, config.outputCompressionLevel);
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsOutputAsyncWriteLong) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg =
+      "--" + osm2rdf::config::constants::OUTPUT_ASYNC_WRITE_OPTION_LONG;
+  const int argc = 3;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  ASSERT_TRUE(config.outputAsyncWrite);
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsOutputCompressionLevelInvalid) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile cf("/tmp/dummyInput");
+
+  const auto arg =
+      "--" + osm2rdf::config::constants::OUTPUT_COMPRESS_OPTION_LONG;
+  const auto arg2 =
+      "--" + osm2rdf::config::constants::OUTPUT_COMPRESSION_LEVEL_OPTION_LONG;
+  const int argc = 6;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("gz"), const_cast<char*>(arg2.c_str()),
+                      const_cast<char*>("12"),
+                      const_cast<char*>("/tmp/dummyInput")};
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  ASSERT_EXIT(config.fromArgs(argc, argv),
+              ::testing::ExitedWithCode(osm2rdf::config::ExitCode::FAILURE),
+              "^Invalid Option");
+}
+
+#if defined(OSM2RDF_HAVE_ZSTD)
+// ____________________________________________________________________________
+TEST(CONFIG_Config, fromArgsOutputCompressZstdAddExtension) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  osm2rdf::util::CacheFile dummyInput("/tmp/dummyInput");
+
+  const auto arg = "-" + osm2rdf::config::constants::OUTPUT_OPTION_SHORT;
+  const auto arg2 =
+      "--" + osm2rdf::config::constants::OUTPUT_COMPRESS_OPTION_LONG;
+  const int argc = 6;
+  char* argv[argc] = {const_cast<char*>(""), const_cast<char*>(arg.c_str()),
+                      const_cast<char*>("/tmp/output"),
+                      const_cast<char*>(arg2.c_str()),
+                      const_cast<char*>("zstd"),
+                      const_cast<char*>("/tmp/dummyInput")};
+  config.fromArgs(argc, argv);
+  ASSERT_EQ(osm2rdf::config::ZSTD, config.outputCompress);
+  ASSERT_EQ("/tmp/output.zst", config.output.string());
+}
+#endif
+
 // ____________________________________________________________________________
 TEST(CONFIG_Config, getInfoHasSections) {
   osm2rdf::config::Config config;
@@ -918,6 +1329,69 @@ TEST(CONFIG_Config, getInfoSimplifyGeometries) {
                        osm2rdf::config::constants::SIMPLIFY_GEOMETRIES_INFO));
 }
 
+// ____________________________________________________________________________
+TEST(CONFIG_Config, getInfoGeometryState) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  config.geometryState = "/tmp/state";
+
+  const std::string res = config.getInfo("");
+  ASSERT_THAT(res, ::testing::HasSubstr(
+                       osm2rdf::config::constants::GEOMETRY_STATE_INFO));
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, getInfoSortGeometries) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  config.sortGeometries = true;
+
+  const std::string res = config.getInfo("");
+  ASSERT_THAT(res, ::testing::HasSubstr(
+                       osm2rdf::config::constants::SORT_GEOMETRIES_INFO));
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, getInfoGeometryTiles) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  config.geometryTiles = 4;
+
+  const std::string res = config.getInfo("");
+  ASSERT_THAT(res, ::testing::HasSubstr(
+                       osm2rdf::config::constants::GEOMETRY_TILES_INFO));
+  ASSERT_THAT(res, ::testing::HasSubstr(
+                       osm2rdf::config::constants::GEOMETRY_TILE_WORKERS_INFO));
+  ASSERT_THAT(res, ::testing::HasSubstr(
+                       osm2rdf::config::constants::GEOMETRY_TILE_TIMEOUT_INFO));
+  ASSERT_THAT(res,
+              ::testing::Not(::testing::HasSubstr(
+                  osm2rdf::config::constants::GEOMETRY_TILE_WORKER_INFO)));
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, getInfoOutputAsyncWrite) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  config.outputAsyncWrite = true;
+
+  const std::string res = config.getInfo("");
+  ASSERT_THAT(res, ::testing::HasSubstr(
+                       osm2rdf::config::constants::OUTPUT_ASYNC_WRITE_INFO));
+}
+
+// ____________________________________________________________________________
+TEST(CONFIG_Config, getInfoGeometricPredicates) {
+  osm2rdf::config::Config config;
+  assertDefaultConfig(config);
+  config.addTouchesRelations = false;
+
+  const std::string res = config.getInfo("");
+  ASSERT_THAT(res, ::testing::HasSubstr(
+                       osm2rdf::config::constants::GEOMETRIC_PREDICATES_INFO));
+  ASSERT_THAT(res, ::testing::Not(::testing::HasSubstr("touches")));
+}
+
 // ____________________________________________________________________________
 TEST(CONFIG_Config, getInfoSimplifyWKT) {
   osm2rdf::config::Config config;
@@ -0,0 +1,133 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/CompressedMemIndex.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "osmium/osm/location.hpp"
+#include "osmium/osm/types.hpp"
+
+namespace osm2rdf::osm {
+
+using Index = CompressedMemIndex<osmium::unsigned_object_id_type,
+                                 osmium::Location>;
+
+// ____________________________________________________________________________
+TEST(OSM_CompressedMemIndex, empty) {
+  Index index;
+  ASSERT_EQ(0, index.size());
+  ASSERT_EQ(osmium::Location{}, index.get_noexcept(1));
+  ASSERT_THROW(index.get(1), osmium::not_found);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_CompressedMemIndex, sequential) {
+  Index index;
+  // Gaps and large jumps in IDs and coordinates, more than one block.
+  std::vector<std::pair<uint64_t, osmium::Location>> entries;
+  for (uint64_t i = 0; i < 5 * Index::BLOCK_SIZE; ++i) {
+    const uint64_t id = 10 + i * 3 + (i > 40 ? uint64_t{1} << 33 : 0);
+    const auto x = static_cast<int32_t>((i % 2 == 0 ? 1 : -1) * i * 1000003);
+    const auto y = static_cast<int32_t>(900000000 - i * 7);
+    entries.emplace_back(id, osmium::Location{x, y});
+    index.set(id, osmium::Location{x, y});
+  }
+  // Undefined locations are stored as well.
+  index.set(entries.back().first + 1, osmium::Location{});
+  ASSERT_EQ(entries.size() + 1, index.size());
+
+  for (const auto& [id, location] : entries) {
+    ASSERT_EQ(location, index.get(id)) << id;
+    ASSERT_EQ(osmium::Location{}, index.get_noexcept(id + 1)) << id;
+  }
+  ASSERT_EQ(osmium::Location{}, index.get_noexcept(0));
+  ASSERT_EQ(osmium::Location{}, index.get_noexcept(9));
+  ASSERT_THROW(index.get(entries.back().first + 1), osmium::not_found);
+  ASSERT_THROW(index.get(entries.back().first + 2), osmium::not_found);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_CompressedMemIndex, outliers) {
+  Index index;
+  // Small differences with single outliers, stored as exceptions of the
+  // packed blocks, and full blocks of consecutive IDs.
+  std::vector<std::pair<uint64_t, osmium::Location>> entries;
+  uint64_t id = 1;
+  int32_t x = 0;
+  int32_t y = 0;
+  for (uint64_t i = 0; i < 10 * Index::BLOCK_SIZE + 5; ++i) {
+    id += i < 3 * Index::BLOCK_SIZE ? 1 : (i % 17 == 0 ? 1000000007 : 2);
+    x = i % 23 == 0 ? (x > 0 ? -1800000000 : 1800000000) : x + 3;
+    y = i % 29 == 0 ? (y > 0 ? -900000000 : 900000000) : y - 5;
+    entries.emplace_back(id, osmium::Location{x, y});
+    index.set(id, osmium::Location{x, y});
+  }
+  for (const auto& [id, location] : entries) {
+    ASSERT_EQ(location, index.get(id)) << id;
+    if (id > entries[3 * Index::BLOCK_SIZE].first) {
+      ASSERT_EQ(osmium::Location{}, index.get_noexcept(id - 1)) << id;
+    }
+  }
+}
+
+// ____________________________________________________________________________
+TEST(OSM_CompressedMemIndex, unsorted) {
+  Index index;
+  index.set(5, osmium::Location{5, 5});
+  index.set(7, osmium::Location{7, 7});
+  index.set(3, osmium::Location{3, 3});
+  index.set(5, osmium::Location{1, 1});
+  index.set(3, osmium::Location{4, 4});
+  index.sort();
+  ASSERT_EQ(osmium::Location(4, 4), index.get(3));
+  ASSERT_EQ(osmium::Location(1, 1), index.get(5));
+  ASSERT_EQ(osmium::Location(7, 7), index.get(7));
+  ASSERT_THROW(index.get(4), osmium::not_found);
+
+  index.clear();
+  ASSERT_EQ(0, index.size());
+  ASSERT_THROW(index.get(7), osmium::not_found);
+  index.set(1, osmium::Location{1, 2});
+  ASSERT_EQ(osmium::Location(1, 2), index.get(1));
+}
+
+// ____________________________________________________________________________
+TEST(OSM_CompressedMemIndex, random) {
+  Index index;
+  std::mt19937 gen{42};
+  std::uniform_int_distribution<int> gap{1, 1 << 17};
+  std::uniform_int_distribution<int32_t> coordinate{-1800000000, 1800000000};
+  std::vector<std::pair<uint64_t, osmium::Location>> entries;
+  uint64_t id = 0;
+  for (size_t i = 0; i < 100000; ++i) {
+    id += gap(gen) % 8 == 0 ? gap(gen) : 1;
+    entries.emplace_back(id, osmium::Location{coordinate(gen) / 2,
+                                              coordinate(gen) / 2});
+    index.set(entries.back().first, entries.back().second);
+  }
+  std::shuffle(entries.begin(), entries.end(), gen);
+  for (const auto& [id, location] : entries) {
+    ASSERT_EQ(location, index.get(id)) << id;
+  }
+}
+
+}  // namespace osm2rdf::osm
@@ -0,0 +1,98 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/DenseMemIndex.h"
+
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "osmium/osm/location.hpp"
+#include "osmium/osm/types.hpp"
+
+namespace osm2rdf::osm {
+
+using Index = DenseMemIndex<osmium::unsigned_object_id_type, osmium::Location>;
+
+// ____________________________________________________________________________
+void assertSetAndGet(Index* index) {
+  ASSERT_EQ(10, index->size());
+  ASSERT_EQ(osmium::Location{}, index->get_noexcept(12));
+  index->set(10, osmium::Location{1, 2});
+  index->set(19, osmium::Location{-3, 0});
+  index->set(12, osmium::Location{});
+  ASSERT_EQ(osmium::Location(1, 2), index->get(10));
+  ASSERT_EQ(osmium::Location(-3, 0), index->get(19));
+  ASSERT_EQ(osmium::Location{}, index->get_noexcept(12));
+  ASSERT_EQ(osmium::Location{}, index->get_noexcept(9));
+  ASSERT_EQ(osmium::Location{}, index->get_noexcept(20));
+  ASSERT_THROW(index->get(11), osmium::not_found);
+  ASSERT_THROW(index->get(20), osmium::not_found);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_DenseMemIndex, setAndGet) {
+  Index index{10, 19};
+  assertSetAndGet(&index);
+  ASSERT_EQ(1, index.replicas());
+  ASSERT_FALSE(index.interleaved());
+  ASSERT_EQ(static_cast<size_t>(sysconf(_SC_PAGESIZE)), index.pageSize());
+}
+
+// ____________________________________________________________________________
+TEST(OSM_DenseMemIndex, hugePages) {
+  // Without reserved huge pages, transparent or normal pages are used.
+  for (const auto pages :
+       {osm2rdf::config::TRANSPARENT_HUGE_PAGES, osm2rdf::config::HUGE_PAGES_2M,
+        osm2rdf::config::HUGE_PAGES_1G}) {
+    Index index{10, 19, pages};
+    assertSetAndGet(&index);
+    ASSERT_GE(index.pageSize(), static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+  }
+}
+
+// ____________________________________________________________________________
+TEST(OSM_DenseMemIndex, numa) {
+  {
+    Index index{10, 19, osm2rdf::config::NO_HUGE_PAGES,
+                osm2rdf::config::NUMA_INTERLEAVE};
+    assertSetAndGet(&index);
+    ASSERT_EQ(1, index.replicas());
+  }
+  {
+    // One copy per NUMA node, at least one on machines without NUMA.
+    Index index{10, 19, osm2rdf::config::NO_HUGE_PAGES,
+                osm2rdf::config::NUMA_REPLICATE};
+    assertSetAndGet(&index);
+    ASSERT_GE(index.replicas(), 1);
+    ASSERT_FALSE(index.interleaved());
+    // Each copy holds ten locations.
+    ASSERT_GE(index.used_memory(), index.replicas() * 10 * 8);
+  }
+}
+
+// ____________________________________________________________________________
+TEST(OSM_DenseMemIndex, clear) {
+  Index index{10, 19};
+  index.set(10, osmium::Location{1, 2});
+  index.clear();
+  ASSERT_EQ(0, index.size());
+  ASSERT_EQ(0, index.replicas());
+  ASSERT_EQ(osmium::Location{}, index.get_noexcept(10));
+}
+
+}  // namespace osm2rdf::osm
@@ -363,6 +363,12 @@ TEST(OSM_FactHandler, relationHandler) {
   auto d = rh.get_noderefs_of_way(56);
 
   ASSERT_EQ(c, d);
+
+  // Decoding into a buffer replaces its content.
+  rh.get_noderefs_of_way(55, &d);
+  ASSERT_EQ(a, d);
+  rh.get_noderefs_of_way(57, &d);
+  ASSERT_TRUE(d.empty());
 }
 
 // ____________________________________________________________________________
@@ -0,0 +1,144 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/GeometryState.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace osm2rdf::osm {
+
+// ____________________________________________________________________________
+TEST(OSM_GeometryState, missing) {
+  const std::filesystem::path path =
+      std::filesystem::temp_directory_path() / "osm2rdf-state-missing";
+  std::filesystem::remove(path);
+  GeometryState state{path, 127};
+  ASSERT_FALSE(state.exists());
+  ASSERT_EQ(0, state.size());
+  ASSERT_EQ(nullptr, state.find(1));
+  size_t count = 0;
+  state.forEachRelation([&count](const StateRelation&) { count++; });
+  ASSERT_EQ(0, count);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_GeometryState, writeAndRead) {
+  const std::filesystem::path path =
+      std::filesystem::temp_directory_path() / "osm2rdf-state-write";
+  std::vector<StateEntry> entries;
+  for (uint64_t i = 0; i < 100; ++i) {
+    entries.push_back({i * 3, i * 7, {-1, -2, 3, 4}});
+  }
+  GeometryState::writeEntries(path, 5, entries);
+  StateRelationWriter writer{path};
+  writer.add({1, 2, 0});
+  writer.add({2, 1, 6});
+  writer.close();
+
+  // A state of other predicates is rejected.
+  ASSERT_THROW(GeometryState(path, 127), std::runtime_error);
+  GeometryState state{path, 5};
+  ASSERT_TRUE(state.exists());
+  ASSERT_EQ(100, state.size());
+  ASSERT_TRUE(std::equal(state.begin(), state.end(), entries.begin(),
+                         [](const StateEntry& a, const StateEntry& b) {
+                           return a.key == b.key && a.hash == b.hash;
+                         }));
+  const auto* entry = state.find(42);
+  ASSERT_NE(nullptr, entry);
+  ASSERT_EQ(98, entry->hash);
+  ASSERT_EQ(-2, entry->box.minY);
+  ASSERT_EQ(4, entry->box.maxY);
+  ASSERT_EQ(nullptr, state.find(43));
+  ASSERT_EQ(nullptr, state.find(300));
+
+  std::vector<StateRelation> relations;
+  state.forEachRelation(
+      [&relations](const StateRelation& r) { relations.push_back(r); });
+  ASSERT_EQ(2, relations.size());
+  ASSERT_TRUE(relations[0] == (StateRelation{1, 2, 0}));
+  ASSERT_TRUE(relations[1] == (StateRelation{2, 1, 6}));
+
+  // Only the first of several writers stores its relations.
+  StateRelationWriter second{path};
+  second.add({3, 4, 1});
+  ASSERT_FALSE(second.closeIfFirst());
+  relations.clear();
+  state.forEachRelation(
+      [&relations](const StateRelation& r) { relations.push_back(r); });
+  ASSERT_EQ(2, relations.size());
+  std::filesystem::remove(path.string() + ".relations");
+  StateRelationWriter third{path};
+  third.add({3, 4, 1});
+  ASSERT_TRUE(third.closeIfFirst());
+
+  std::filesystem::remove(path);
+  std::filesystem::remove(path.string() + ".relations");
+}
+
+// ____________________________________________________________________________
+TEST(OSM_GeometryState, invalid) {
+  const std::filesystem::path path =
+      std::filesystem::temp_directory_path() / "osm2rdf-state-invalid";
+  {
+    std::ofstream out{path};
+    out << "not a geometry state";
+  }
+  ASSERT_THROW(GeometryState(path, 127), std::runtime_error);
+  // Header of another hash function.
+  {
+    std::ofstream out{path};
+    out << "OSM2RDFG" << "STD-HASH" << std::string(16, '\0');
+  }
+  ASSERT_THROW(GeometryState(path, 0), std::runtime_error);
+  std::filesystem::remove(path);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_GeometryState, stateHash) {
+  // The hash is stored in state files and must not change between builds.
+  ASSERT_EQ(0xcbf29ce484222325ULL, stateHash(""));
+  ASSERT_EQ(0x85944171f73967e8ULL, stateHash("foobar"));
+}
+
+// ____________________________________________________________________________
+TEST(OSM_BoxGrid, intersects) {
+  std::vector<StateBox> boxes;
+  // Small box, box spanning several cells and the whole world.
+  boxes.push_back({0, 0, 10, 10});
+  boxes.push_back({-1000000, 5000000, 1000000, 6000000});
+  BoxGrid grid{boxes};
+  ASSERT_EQ(2, grid.size());
+  ASSERT_TRUE(grid.intersects({5, 5, 6, 6}));
+  ASSERT_TRUE(grid.intersects({10, 10, 20, 20}));
+  ASSERT_FALSE(grid.intersects({11, 11, 20, 20}));
+  ASSERT_FALSE(grid.intersects({-20, 0, -11, 10}));
+  ASSERT_TRUE(grid.intersects({999999, 6000000, 2000000, 7000000}));
+  ASSERT_FALSE(grid.intersects({1000001, 5000000, 2000000, 7000000}));
+  ASSERT_TRUE(grid.intersects({INT32_MIN, INT32_MIN, INT32_MAX, INT32_MAX}));
+
+  boxes.push_back({INT32_MIN, INT32_MIN, INT32_MAX, INT32_MAX});
+  BoxGrid world{boxes};
+  ASSERT_TRUE(world.intersects({-20, 0, -11, 10}));
+  ASSERT_TRUE(world.intersects({INT32_MAX, INT32_MAX, INT32_MAX, INT32_MAX}));
+}
+
+}  // namespace osm2rdf::osm
@@ -18,6 +18,11 @@
 
 #include "osm2rdf/osm/OsmiumHandler.h"
 
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
 #include "gmock/gmock-matchers.h"
 #include "gtest/gtest.h"
 #include "osmium/builder/attr.hpp"
@@ -927,4 +932,112 @@ TEST(OSM_OsmiumHandler, handleOSMWikiExample) {
   std::filesystem::remove(config.input);
 }
 
+
+// ____________________________________________________________________________
+// Writes ways with numWays * 10 nodes, nodes first unless waysFirst is set.
+void writeWaysInput(const std::filesystem::path& path, size_t numWays,
+                    bool waysFirst) {
+  std::ofstream inputFile(path);
+  inputFile << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            << "<osm version=\"0.6\" generator=\"osm2rdf\">\n";
+  std::string nodes;
+  for (size_t i = 1; i <= numWays * 10; ++i) {
+    nodes += " <node id=\"" + std::to_string(i) + "\" lat=\"" +
+             std::to_string(48.0 + i * 0.0001) + "\" lon=\"" +
+             std::to_string(7.8 + (i % 10) * 0.0001) +
+             "\" visible=\"true\" version=\"1\"/>\n";
+  }
+  std::string ways;
+  for (size_t i = 1; i <= numWays; ++i) {
+    ways += " <way id=\"" + std::to_string(i) +
+            "\" visible=\"true\" version=\"1\">\n";
+    for (size_t j = 0; j < 10; ++j) {
+      ways += "  <nd ref=\"" + std::to_string((i - 1) * 10 + j + 1) + "\"/>\n";
+    }
+    ways += "  <tag k=\"highway\" v=\"path\"/>\n </way>\n";
+  }
+  inputFile << (waysFirst ? ways + nodes : nodes + ways) << "</osm>"
+            << std::endl;
+}
+
+// ____________________________________________________________________________
+// Runs handle() on the input and returns the sorted lines with way
+// geometries.
+std::vector<std::string> handleWayGeometries(
+    const std::filesystem::path& input, const std::string& storeLocations,
+    int numThreads, std::string* log) {
+  std::stringstream cerrBuffer;
+  std::streambuf* cerrBufferOrig = std::cerr.rdbuf();
+  std::cerr.rdbuf(cerrBuffer.rdbuf());
+
+  osm2rdf::config::Config config;
+  config.input = input;
+  config.output = config.getTempPath("OSM_OsmiumHandler",
+                                     "wayGeometries-" + storeLocations);
+  config.numThreads = numThreads;
+  config.storeLocations = storeLocations;
+  config.noGeometricRelations = true;
+  config.outputCompress = osm2rdf::config::NONE;
+  config.mergeOutput = osm2rdf::util::OutputMergeMode::CONCATENATE;
+  {
+    osm2rdf::util::Output output{config, config.output};
+    output.open();
+    osm2rdf::ttl::Writer<osm2rdf::ttl::format::TTL> writer{config, &output};
+    osm2rdf::osm::FactHandler<osm2rdf::ttl::format::TTL> factHandler(config,
+                                                                     &writer);
+    osm2rdf::osm::GeometryHandler<osm2rdf::ttl::format::TTL> geomHandler(
+        config, &writer);
+    osm2rdf::osm::OsmiumHandler osmiumHandler{config, &factHandler,
+                                              &geomHandler};
+    osmiumHandler.handle();
+    output.close();
+  }
+
+  std::vector<std::string> lines;
+  std::ifstream result(config.output);
+  for (std::string line; std::getline(result, line);) {
+    if (line.find("LINESTRING") != std::string::npos) {
+      lines.push_back(line);
+    }
+  }
+  std::sort(lines.begin(), lines.end());
+  std::filesystem::remove(config.output);
+
+  std::cerr.rdbuf(cerrBufferOrig);
+  *log = cerrBuffer.str();
+  return lines;
+}
+
+// ____________________________________________________________________________
+TEST(OSM_OsmiumHandler, handleParallelLocations) {
+  osm2rdf::config::Config config;
+  const auto input =
+      config.getTempPath("OSM_OsmiumHandler", "parallelLocations.osm");
+  writeWaysInput(input, 1000, false);
+
+  std::string log;
+  const auto serial = handleWayGeometries(input, "mem-flex", 1, &log);
+  const auto parallel = handleWayGeometries(input, "mem-dense", 4, &log);
+  ASSERT_EQ(1000, serial.size());
+  ASSERT_EQ(serial, parallel);
+  ASSERT_THAT(log, ::testing::Not(::testing::HasSubstr("not sorted")));
+  std::filesystem::remove(input);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_OsmiumHandler, handleParallelLocationsUnsorted) {
+  osm2rdf::config::Config config;
+  const auto input =
+      config.getTempPath("OSM_OsmiumHandler", "parallelLocationsUnsorted.osm");
+  writeWaysInput(input, 10, true);
+
+  std::string log;
+  const auto serial = handleWayGeometries(input, "mem-flex", 1, &log);
+  const auto parallel = handleWayGeometries(input, "mem-dense", 4, &log);
+  // Ways before their nodes get no locations, the same as sequentially.
+  ASSERT_EQ(serial, parallel);
+  ASSERT_THAT(log, ::testing::HasSubstr("Input is not sorted"));
+  std::filesystem::remove(input);
+}
+
 }  // namespace osm2rdf::osm
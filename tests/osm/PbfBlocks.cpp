@@ -0,0 +1,139 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/PbfBlocks.h"
+
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace osm2rdf::osm {
+
+// ____________________________________________________________________________
+// Appends a blob with the given type and data, the header also contains an
+// indexdata field which has to be skipped.
+static void addBlob(std::string* file, const std::string& type,
+                    const std::string& data) {
+  std::string header;
+  header += '\x0A';
+  header += static_cast<char>(type.size());
+  header += type;
+  header += '\x12';
+  header += '\x02';
+  header += "ix";
+  header += '\x18';
+  for (uint64_t v = data.size();; v >>= 7U) {
+    if (v < 0x80) {
+      header += static_cast<char>(v);
+      break;
+    }
+    header += static_cast<char>((v & 0x7FU) | 0x80U);
+  }
+  const uint32_t size = header.size();
+  *file += static_cast<char>(size >> 24U);
+  *file += static_cast<char>(size >> 16U);
+  *file += static_cast<char>(size >> 8U);
+  *file += static_cast<char>(size);
+  *file += header;
+  *file += data;
+}
+
+// ____________________________________________________________________________
+TEST(OSM_PbfBlocks, offsets) {
+  std::string content;
+  addBlob(&content, "OSMHeader", "header");
+  const uint64_t headerEnd = content.size();
+  addBlob(&content, "OSMData", std::string(300, 'n'));
+  const uint64_t second = content.size();
+  addBlob(&content, "OSMData", std::string(5, 'w'));
+  const uint64_t third = content.size();
+  addBlob(&content, "OSMData", "relations");
+
+  const std::filesystem::path path = "/tmp/osm2rdf-pbfblocks.pbf";
+  std::ofstream{path, std::ios::binary} << content;
+
+  PbfBlocks blocks{path};
+  ASSERT_EQ(headerEnd, blocks.headerEnd());
+  ASSERT_EQ(std::vector<uint64_t>({headerEnd, second, third}),
+            blocks.dataOffsets());
+  ASSERT_EQ(content.size(), blocks.fileSize());
+
+  {
+    PbfSection section{path, blocks.headerEnd(), blocks.dataOffsets()[1]};
+    std::ifstream in{section.path(), std::ios::binary};
+    const std::string streamed{std::istreambuf_iterator<char>(in), {}};
+    ASSERT_EQ(content.substr(0, headerEnd) + content.substr(second), streamed);
+    section.close();
+  }
+
+  // The section is closed without being read.
+  { PbfSection section{path, blocks.headerEnd(), blocks.dataOffsets()[0]}; }
+
+  std::filesystem::remove(path);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_PbfBlocks, sectionFails) {
+  std::string content;
+  addBlob(&content, "OSMHeader", "header");
+  const uint64_t headerEnd = content.size();
+  addBlob(&content, "OSMData", "data");
+
+  const std::filesystem::path path = "/tmp/osm2rdf-pbfblocks.pbf";
+  std::ofstream{path, std::ios::binary} << content;
+  {
+    // The file is truncated after the offsets were read.
+    PbfSection section{path, headerEnd + content.size(), headerEnd};
+    std::ifstream in{section.path(), std::ios::binary};
+    const std::string streamed{std::istreambuf_iterator<char>(in), {}};
+    ASSERT_EQ(content, streamed);
+    ASSERT_THROW(section.close(), std::runtime_error);
+  }
+
+  std::filesystem::remove(path);
+  {
+    PbfSection section{path, headerEnd, headerEnd};
+    std::ifstream in{section.path(), std::ios::binary};
+    const std::string streamed{std::istreambuf_iterator<char>(in), {}};
+    ASSERT_TRUE(streamed.empty());
+    ASSERT_THROW(section.close(), std::filesystem::filesystem_error);
+  }
+}
+
+// ____________________________________________________________________________
+TEST(OSM_PbfBlocks, invalid) {
+  const std::filesystem::path path = "/tmp/osm2rdf-pbfblocks.pbf";
+  std::string content;
+  addBlob(&content, "OSMData", "data");
+  std::ofstream{path, std::ios::binary} << content;
+  ASSERT_THROW(PbfBlocks{path}, std::runtime_error);
+
+  content.clear();
+  addBlob(&content, "OSMHeader", "header");
+  addBlob(&content, "OSMData", "data");
+  content.pop_back();
+  std::ofstream{path, std::ios::binary} << content;
+  ASSERT_THROW(PbfBlocks{path}, std::runtime_error);
+
+  std::filesystem::remove(path);
+  ASSERT_THROW(PbfBlocks{path}, std::filesystem::filesystem_error);
+}
+
+}  // namespace osm2rdf::osm
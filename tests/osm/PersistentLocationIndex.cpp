@@ -0,0 +1,120 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/PersistentLocationIndex.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include "gtest/gtest.h"
+#include "osmium/osm/location.hpp"
+#include "osmium/osm/types.hpp"
+
+namespace osm2rdf::osm {
+
+using Index = PersistentLocationIndex<osmium::unsigned_object_id_type,
+                                      osmium::Location>;
+
+// ____________________________________________________________________________
+TEST(OSM_PersistentLocationIndex, setAndGet) {
+  const std::filesystem::path path{"/tmp/osm2rdf-persistent-setAndGet"};
+  std::filesystem::remove(path);
+  {
+    Index index{path, 42, 10, 19};
+    ASSERT_FALSE(index.readOnly());
+    ASSERT_EQ(10, index.size());
+    index.set(10, osmium::Location{1, 2});
+    index.set(19, osmium::Location{-3, 0});
+    // IDs outside of the range are ignored.
+    index.set(20, osmium::Location{5, 6});
+    ASSERT_EQ(osmium::Location(1, 2), index.get(10));
+    ASSERT_EQ(osmium::Location(-3, 0), index.get(19));
+    ASSERT_EQ(osmium::Location{}, index.get_noexcept(11));
+    ASSERT_EQ(osmium::Location{}, index.get_noexcept(9));
+    ASSERT_EQ(osmium::Location{}, index.get_noexcept(20));
+    ASSERT_THROW(index.get(11), osmium::not_found);
+  }
+  ASSERT_TRUE(std::filesystem::exists(path));
+  std::filesystem::remove(path);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_PersistentLocationIndex, reattach) {
+  const std::filesystem::path path{"/tmp/osm2rdf-persistent-reattach"};
+  std::filesystem::remove(path);
+  {
+    Index index{path, 42, 10, 19};
+    index.set(12, osmium::Location{7, 8});
+    index.finish();
+  }
+  {
+    Index index{path, 42, 10, 19};
+    ASSERT_TRUE(index.readOnly());
+    ASSERT_EQ(osmium::Location(7, 8), index.get(12));
+    // Attached indices are not modified.
+    index.set(13, osmium::Location{1, 1});
+    ASSERT_EQ(osmium::Location{}, index.get_noexcept(13));
+  }
+  // Different checksum or ID range create a new index.
+  {
+    Index index{path, 43, 10, 19};
+    ASSERT_FALSE(index.readOnly());
+    ASSERT_EQ(osmium::Location{}, index.get_noexcept(12));
+  }
+  {
+    Index index{path, 43, 10, 20};
+    ASSERT_FALSE(index.readOnly());
+  }
+  std::filesystem::remove(path);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_PersistentLocationIndex, incompleteIsRebuilt) {
+  const std::filesystem::path path{"/tmp/osm2rdf-persistent-incomplete"};
+  std::filesystem::remove(path);
+  {
+    // Destroyed without finish() as if the run was aborted.
+    Index index{path, 42, 0, 3};
+    index.set(1, osmium::Location{7, 8});
+  }
+  {
+    Index index{path, 42, 0, 3};
+    ASSERT_FALSE(index.readOnly());
+  }
+  std::filesystem::remove(path);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_PersistentLocationIndex, checksum) {
+  const std::filesystem::path path{"/tmp/osm2rdf-persistent-checksum"};
+  {
+    std::ofstream out{path};
+    out << "abc";
+  }
+  const uint64_t a = Index::checksum(path);
+  ASSERT_EQ(a, Index::checksum(path));
+  {
+    std::ofstream out{path};
+    out << "abd";
+  }
+  ASSERT_NE(a, Index::checksum(path));
+  std::filesystem::remove(path);
+  ASSERT_THROW(Index::checksum(path), std::filesystem::filesystem_error);
+}
+
+}  // namespace osm2rdf::osm
@@ -0,0 +1,67 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/ReferencedNodesHandler.h"
+
+#include "gtest/gtest.h"
+#include "osmium/builder/attr.hpp"
+#include "osmium/builder/osm_object_builder.hpp"
+
+namespace osm2rdf::osm {
+
+// ____________________________________________________________________________
+TEST(OSM_ReferencedNodesHandler, empty) {
+  ReferencedNodesHandler handler;
+  ASSERT_EQ(0, handler.size());
+  ASSERT_FALSE(handler.contains(0));
+  ASSERT_FALSE(handler.contains(1000));
+}
+
+// ____________________________________________________________________________
+TEST(OSM_ReferencedNodesHandler, wayAndRelation) {
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer buffer{initial_buffer_size,
+                                osmium::memory::Buffer::auto_grow::yes};
+  osmium::builder::add_way(buffer, osmium::builder::attr::_id(42),
+                           osmium::builder::attr::_nodes({1, 2, 64, 1}));
+  const size_t relationOffset = osmium::builder::add_relation(
+      buffer, osmium::builder::attr::_id(43),
+      osmium::builder::attr::_member(osmium::item_type::node, 5000000000,
+                                     "label"),
+      osmium::builder::attr::_member(osmium::item_type::way, 7, "outer"),
+      osmium::builder::attr::_member(osmium::item_type::node, 2, ""));
+
+  ReferencedNodesHandler handler;
+  handler.way(buffer.get<osmium::Way>(0));
+  handler.relation(buffer.get<osmium::Relation>(relationOffset));
+
+  // Each node is counted once.
+  ASSERT_EQ(4, handler.size());
+  ASSERT_TRUE(handler.contains(1));
+  ASSERT_TRUE(handler.contains(2));
+  ASSERT_TRUE(handler.contains(64));
+  ASSERT_TRUE(handler.contains(5000000000));
+  ASSERT_FALSE(handler.contains(0));
+  ASSERT_FALSE(handler.contains(3));
+  ASSERT_FALSE(handler.contains(63));
+  // Way members are not nodes.
+  ASSERT_FALSE(handler.contains(7));
+  ASSERT_FALSE(handler.contains(5000000001));
+}
+
+}  // namespace osm2rdf::osm
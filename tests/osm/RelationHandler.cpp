@@ -0,0 +1,169 @@
+// Copyright 2022, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/RelationHandler.h"
+
+#include "gtest/gtest.h"
+#include "osm2rdf/osm/Relation.h"
+#include "osmium/builder/attr.hpp"
+#include "osmium/builder/osm_object_builder.hpp"
+
+namespace osm2rdf::osm {
+
+// ____________________________________________________________________________
+TEST(OSM_RelationHandler, nestedLevel) {
+  osm2rdf::config::Config config;
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer buffer{initial_buffer_size,
+                                osmium::memory::Buffer::auto_grow::yes};
+  // 1 -> 2 -> 3, 6 -> 4 <-> 5
+  std::vector<size_t> offsets;
+  offsets.push_back(osmium::builder::add_relation(
+      buffer, osmium::builder::attr::_id(1),
+      osmium::builder::attr::_member(osmium::item_type::relation, 2, "")));
+  offsets.push_back(osmium::builder::add_relation(
+      buffer, osmium::builder::attr::_id(2),
+      osmium::builder::attr::_member(osmium::item_type::relation, 3, ""),
+      osmium::builder::attr::_member(osmium::item_type::node, 7, "")));
+  offsets.push_back(osmium::builder::add_relation(
+      buffer, osmium::builder::attr::_id(3),
+      osmium::builder::attr::_member(osmium::item_type::node, 8, "")));
+  offsets.push_back(osmium::builder::add_relation(
+      buffer, osmium::builder::attr::_id(4),
+      osmium::builder::attr::_member(osmium::item_type::relation, 5, "")));
+  offsets.push_back(osmium::builder::add_relation(
+      buffer, osmium::builder::attr::_id(5),
+      osmium::builder::attr::_member(osmium::item_type::relation, 4, "")));
+  offsets.push_back(osmium::builder::add_relation(
+      buffer, osmium::builder::attr::_id(6),
+      osmium::builder::attr::_member(osmium::item_type::relation, 4, "")));
+
+  RelationHandler rh{config};
+  for (const auto& offset : offsets) {
+    rh.relation(buffer.get<osmium::Relation>(offset));
+  }
+  rh.prepare_for_lookup();
+
+  ASSERT_EQ(2, rh.nestedLevel(1));
+  ASSERT_EQ(1, rh.nestedLevel(2));
+  ASSERT_EQ(0, rh.nestedLevel(3));
+  // Cycles and relations containing them are not resolved.
+  ASSERT_EQ(RelationHandler::NO_NESTED_LEVEL, rh.nestedLevel(4));
+  ASSERT_EQ(RelationHandler::NO_NESTED_LEVEL, rh.nestedLevel(5));
+  ASSERT_EQ(RelationHandler::NO_NESTED_LEVEL, rh.nestedLevel(6));
+  ASSERT_EQ(RelationHandler::NO_NESTED_LEVEL, rh.nestedLevel(42));
+
+  // Geometries are only stored for member relations.
+  ASSERT_EQ(nullptr, rh.get_relation_geometry(1));
+  ASSERT_NE(nullptr, rh.get_relation_geometry(2));
+  ASSERT_NE(nullptr, rh.get_relation_geometry(3));
+  ASSERT_EQ(nullptr, rh.get_relation_geometry(4));
+  ASSERT_FALSE(rh.get_relation_geometry(3)->complete);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_RelationHandler, nestedGeometry) {
+  osm2rdf::config::Config config;
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer buffer{initial_buffer_size,
+                                osmium::memory::Buffer::auto_grow::yes};
+  const auto parentOffset = osmium::builder::add_relation(
+      buffer, osmium::builder::attr::_id(1),
+      osmium::builder::attr::_member(osmium::item_type::relation, 2, ""),
+      osmium::builder::attr::_member(osmium::item_type::node, 7, ""));
+  const auto childOffset = osmium::builder::add_relation(
+      buffer, osmium::builder::attr::_id(2),
+      osmium::builder::attr::_member(osmium::item_type::node, 8, ""));
+  const auto node7Offset = osmium::builder::add_node(
+      buffer, osmium::builder::attr::_id(7),
+      osmium::builder::attr::_location(osmium::Location(7.5, 48.0)));
+  const auto node8Offset = osmium::builder::add_node(
+      buffer, osmium::builder::attr::_id(8),
+      osmium::builder::attr::_location(osmium::Location(7.6, 48.1)));
+
+  RelationHandler rh{config};
+  LocationHandler* lh = LocationHandler::create(config, 0, 0);
+  rh.relation(buffer.get<osmium::Relation>(parentOffset));
+  rh.relation(buffer.get<osmium::Relation>(childOffset));
+  rh.prepare_for_lookup();
+  rh.setLocationHandler(lh);
+  lh->node(buffer.get<osmium::Node>(node7Offset));
+  lh->node(buffer.get<osmium::Node>(node8Offset));
+
+  // Without the member geometry the parent is incomplete.
+  Relation incomplete{buffer.get<osmium::Relation>(parentOffset)};
+  incomplete.buildGeometry(rh);
+  ASSERT_FALSE(incomplete.hasCompleteGeometry());
+
+  Relation child{buffer.get<osmium::Relation>(childOffset)};
+  child.buildGeometry(rh);
+  ASSERT_TRUE(child.hasCompleteGeometry());
+  rh.setRelationGeometry(child.id(), child.geom(),
+                         child.hasCompleteGeometry());
+
+  Relation parent{buffer.get<osmium::Relation>(parentOffset)};
+  parent.buildGeometry(rh);
+  ASSERT_TRUE(parent.hasCompleteGeometry());
+  ASSERT_EQ(2, parent.geom().size());
+  ASSERT_DOUBLE_EQ(7.6, parent.envelope().getUpperRight().getX());
+  ASSERT_DOUBLE_EQ(48.0, parent.envelope().getLowerLeft().getY());
+
+  delete lh;
+}
+
+// ____________________________________________________________________________
+TEST(OSM_RelationHandler, merge) {
+  osm2rdf::config::Config config;
+  const size_t initial_buffer_size = 10000;
+  osmium::memory::Buffer buffer{initial_buffer_size,
+                                osmium::memory::Buffer::auto_grow::yes};
+  const auto parentOffset = osmium::builder::add_relation(
+      buffer, osmium::builder::attr::_id(1),
+      osmium::builder::attr::_member(osmium::item_type::relation, 2, ""),
+      osmium::builder::attr::_member(osmium::item_type::way, 5, ""));
+  const auto childOffset = osmium::builder::add_relation(
+      buffer, osmium::builder::attr::_id(2),
+      osmium::builder::attr::_member(osmium::item_type::relation, 3, ""),
+      osmium::builder::attr::_member(osmium::item_type::way, 6, ""));
+  const auto wayOffset = osmium::builder::add_way(
+      buffer, osmium::builder::attr::_id(6),
+      osmium::builder::attr::_nodes({
+          {1, {48.0, 7.52}},
+          {2, {48.1, 7.61}},
+          {3, {48.2, 7.70}},
+      }));
+
+  // Each relation is seen by a different shard.
+  RelationHandler rh{config};
+  RelationHandler shard1{config};
+  RelationHandler shard2{config};
+  shard1.relation(buffer.get<osmium::Relation>(parentOffset));
+  shard2.relation(buffer.get<osmium::Relation>(childOffset));
+  rh.merge(shard1);
+  rh.merge(shard2);
+  rh.prepare_for_lookup();
+  rh.way(buffer.get<osmium::Way>(wayOffset));
+
+  ASSERT_EQ(2, rh.nestedLevel(1));
+  ASSERT_EQ(1, rh.nestedLevel(2));
+  ASSERT_EQ(0, rh.nestedLevel(3));
+  ASSERT_EQ(std::vector<uint64_t>({1, 2, 3}), rh.get_noderefs_of_way(6));
+  ASSERT_TRUE(rh.get_noderefs_of_way(5).empty());
+}
+
+}  // namespace osm2rdf::osm
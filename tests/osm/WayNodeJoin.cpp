@@ -0,0 +1,115 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/osm/WayNodeJoin.h"
+
+#include <fstream>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "osmium/io/detail/xml_input_format.hpp"
+#include "osmium/io/reader.hpp"
+#include "osmium/visitor.hpp"
+
+namespace osm2rdf::osm {
+
+// ____________________________________________________________________________
+void writeInput(const std::filesystem::path& path, const std::string& nodes) {
+  std::ofstream out{path};
+  out << "<?xml version='1.0' encoding='UTF-8'?>\n"
+      << "<osm version=\"0.6\">\n"
+      << nodes
+      << "<way id=\"10\"><nd ref=\"1\"/><nd ref=\"2\"/><nd ref=\"3\"/></way>\n"
+      << "<way id=\"11\"><nd ref=\"4\"/><nd ref=\"1\"/></way>\n"
+      << "<relation id=\"20\">"
+      << "<member type=\"node\" ref=\"2\" role=\"\"/>"
+      << "<member type=\"way\" ref=\"11\" role=\"\"/>"
+      << "<tag k=\"type\" v=\"route\"/></relation>\n"
+      << "</osm>\n";
+}
+
+// ____________________________________________________________________________
+TEST(OSM_WayNodeJoin, join) {
+  osm2rdf::config::Config config;
+  config.input = config.getTempPath("OSM_WayNodeJoin", "join.osm");
+  writeInput(config.input,
+             "<node id=\"1\" lat=\"48.0\" lon=\"7.5\"/>\n"
+             "<node id=\"2\" lat=\"48.1\" lon=\"7.6\"/>\n"
+             "<node id=\"4\" lat=\"48.3\" lon=\"7.8\"/>\n");
+
+  WayNodeJoin join{config};
+  {
+    osmium::io::Reader reader{config.input.string()};
+    osmium::apply(reader, join);
+    reader.close();
+  }
+  ASSERT_EQ(5, join.numRefs());
+  join.join();
+  // Relation node members are known after the join.
+  ASSERT_EQ(osmium::Location(7.6, 48.1), join.get_node_location(2));
+  ASSERT_EQ(osmium::Location{}, join.get_node_location(4));
+
+  std::vector<std::vector<osmium::Location>> locations;
+  {
+    osmium::io::Reader reader{config.input.string(),
+                              osmium::osm_entity_bits::way};
+    while (auto buf = reader.read()) {
+      for (auto& way : buf.select<osmium::Way>()) {
+        join.fill(way);
+        locations.emplace_back();
+        for (const auto& nodeRef : way.nodes()) {
+          locations.back().push_back(nodeRef.location());
+        }
+      }
+    }
+    reader.close();
+  }
+  ASSERT_EQ(2, locations.size());
+  // Node 3 is missing in the input.
+  ASSERT_EQ((std::vector<osmium::Location>{osmium::Location(7.5, 48.0),
+                                           osmium::Location(7.6, 48.1),
+                                           osmium::Location{}}),
+            locations[0]);
+  ASSERT_EQ((std::vector<osmium::Location>{osmium::Location(7.8, 48.3),
+                                           osmium::Location(7.5, 48.0)}),
+            locations[1]);
+  // Nodes of relation member ways are known after their way.
+  ASSERT_EQ(osmium::Location(7.8, 48.3), join.get_node_location(4));
+  ASSERT_EQ(osmium::Location{}, join.get_node_location(3));
+  std::filesystem::remove(config.input);
+}
+
+// ____________________________________________________________________________
+TEST(OSM_WayNodeJoin, unsortedInput) {
+  osm2rdf::config::Config config;
+  config.input = config.getTempPath("OSM_WayNodeJoin", "unsorted.osm");
+  writeInput(config.input,
+             "<node id=\"2\" lat=\"48.1\" lon=\"7.6\"/>\n"
+             "<node id=\"1\" lat=\"48.0\" lon=\"7.5\"/>\n");
+
+  WayNodeJoin join{config};
+  {
+    osmium::io::Reader reader{config.input.string()};
+    osmium::apply(reader, join);
+    reader.close();
+  }
+  ASSERT_THROW(join.join(), std::runtime_error);
+  std::filesystem::remove(config.input);
+}
+
+}  // namespace osm2rdf::osm
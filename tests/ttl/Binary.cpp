@@ -0,0 +1,158 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/ttl/Binary.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace osm2rdf::ttl::binary {
+
+// ____________________________________________________________________________
+std::string decode(const std::string& stream) {
+  std::istringstream in{stream};
+  std::ostringstream out;
+  Decoder d;
+  d.decode(in, out);
+  return out.str();
+}
+
+// ____________________________________________________________________________
+TEST(TTL_Binary, header) {
+  std::string header;
+  writeHeader(&header);
+  ASSERT_EQ(MAGIC.size() + 2, header.size());
+  ASSERT_EQ(MAGIC, header.substr(0, MAGIC.size()));
+  ASSERT_EQ(VERSION, header[MAGIC.size()]);
+  ASSERT_EQ(SLOT_BITS, header[MAGIC.size() + 1]);
+  ASSERT_EQ("", decode(header));
+}
+
+// ____________________________________________________________________________
+TEST(TTL_Binary, encodeTriple) {
+  Encoder e{0};
+  std::string stream;
+  writeHeader(&stream);
+  stream += e.encodeTriple("<s>", "<p>", "\"o\"");
+  // Known terms are not defined again, only the triple is written.
+  std::string_view records = e.encodeTriple("<s>", "<p>", "\"o\"");
+  ASSERT_EQ(TRIPLE, records[0]);
+  ASSERT_EQ(2 + 3 * 4, records.size());
+  stream += records;
+  stream += e.encodeTriple("<s>", "<p>", "\"x\"");
+  ASSERT_EQ(
+      "<s> <p> \"o\" .\n"
+      "<s> <p> \"o\" .\n"
+      "<s> <p> \"x\" .\n",
+      decode(stream));
+}
+
+// ____________________________________________________________________________
+TEST(TTL_Binary, encodeCollectedTerms) {
+  Encoder e{3};
+  std::string stream;
+  writeHeader(&stream);
+  e.append("<s");
+  e.append('>');
+  e.endTerm();
+  e.append("<p>");
+  e.endTerm();
+  e.append("\"a b\"");
+  stream += e.encodeTriple();
+  e.append("<s>");
+  e.endTerm();
+  e.append("<p>");
+  e.endTerm();
+  e.append("<o>");
+  stream += e.encodeTriple();
+  ASSERT_EQ(
+      "<s> <p> \"a b\" .\n"
+      "<s> <p> <o> .\n",
+      decode(stream));
+}
+
+// ____________________________________________________________________________
+TEST(TTL_Binary, longTerms) {
+  Encoder e{0};
+  std::string stream;
+  writeHeader(&stream);
+  const std::string wkt =
+      "\"POLYGON((" + std::string(MAX_CACHED_TERM_LENGTH, '1') + "))\"";
+  stream += e.encodeTriple("<s>", "<p>", wkt);
+  // Long terms are defined for each use.
+  std::string_view records = e.encodeTriple("<s>", "<p>", wkt);
+  ASSERT_EQ(DEFINE, records[0]);
+  ASSERT_GT(records.size(), wkt.size());
+  stream += records;
+  ASSERT_EQ("<s> <p> " + wkt + " .\n<s> <p> " + wkt + " .\n", decode(stream));
+}
+
+// ____________________________________________________________________________
+TEST(TTL_Binary, interleavedParts) {
+  Encoder e0{0};
+  Encoder e1{1};
+  std::string stream;
+  writeHeader(&stream);
+  stream += e0.encodeTriple("<a>", "<p>", "<b>");
+  stream += e1.encodeTriple("<c>", "<p>", "<d>");
+  stream += e0.encodeTriple("<a>", "<p>", "<b>");
+  // Parts start with their own header, repeated headers are accepted.
+  writeHeader(&stream);
+  stream += e1.encodeTriple("<c>", "<p>", "<d>");
+  ASSERT_EQ(
+      "<a> <p> <b> .\n"
+      "<c> <p> <d> .\n"
+      "<a> <p> <b> .\n"
+      "<c> <p> <d> .\n",
+      decode(stream));
+}
+
+// ____________________________________________________________________________
+TEST(TTL_Binary, manyTerms) {
+  // More terms than slots, replaced slots are defined again.
+  Encoder e{0};
+  std::string stream;
+  std::string expected;
+  writeHeader(&stream);
+  for (size_t i = 0; i < (2U << SLOT_BITS); ++i) {
+    const std::string s = "<s" + std::to_string(i) + ">";
+    const std::string o = "\"" + std::to_string(i % 1000) + "\"";
+    stream += e.encodeTriple(s, "<p>", o);
+    stream += e.encodeTriple(o, s, s);
+    expected += s + " <p> " + o + " .\n" + o + " " + s + " " + s + " .\n";
+  }
+  ASSERT_EQ(expected, decode(stream));
+}
+
+// ____________________________________________________________________________
+TEST(TTL_Binary, decodeInvalid) {
+  Encoder e{0};
+  const std::string triple{e.encodeTriple("<s>", "<p>", "<o>")};
+  ASSERT_THROW(decode(triple), std::runtime_error);
+  std::string stream;
+  writeHeader(&stream);
+  ASSERT_THROW(decode(stream + triple.substr(0, triple.size() - 1)),
+               std::runtime_error);
+  ASSERT_THROW(decode(stream + "X"), std::runtime_error);
+  ASSERT_THROW(decode("OSM2RDFX"), std::runtime_error);
+}
+
+}  // namespace osm2rdf::ttl::binary
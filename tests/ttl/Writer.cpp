@@ -21,6 +21,7 @@
 #include "gmock/gmock-matchers.h"
 #include "gtest/gtest.h"
 #include "osm2rdf/config/Config.h"
+#include "osm2rdf/util/Hash.h"
 
 namespace osm2rdf::ttl {
 
@@ -715,6 +716,62 @@ TEST(TTL_WriterTTL, writeStatisticJson) {
   ASSERT_FALSE(std::filesystem::exists(tmpDir));
 }
 
+// ____________________________________________________________________________
+TEST(TTL_WriterTTL, writeStatisticJsonShards) {
+  osm2rdf::config::Config config;
+  std::filesystem::path tmpDir =
+      config.getTempPath("TEST_TTL_WriterTTL", "writeStatisticJsonShards");
+  std::filesystem::remove_all(tmpDir);
+  std::filesystem::create_directories(tmpDir);
+  config.output = tmpDir / "file";
+  config.outputCompress = osm2rdf::config::NONE;
+  config.mergeOutput = util::OutputMergeMode::NONE;
+  config.outputShards = 2;
+  osm2rdf::util::Output output{config, config.output};
+  output.open();
+  osm2rdf::ttl::Writer<osm2rdf::ttl::format::TTL> w{config, &output};
+  std::filesystem::path statsFile{tmpDir};
+  statsFile /= "stats";
+
+  // Each shard starts with a line for each entry in w._prefixes.
+  w.writeHeader();
+
+  // Subjects are assigned to shards by their FNV-1a hash.
+  size_t shard0 = 0;
+  for (size_t i = 0; i < 5; ++i) {
+    const std::string subject = "s" + std::to_string(i);
+    w.writeTriple(subject, "p", "o");
+    shard0 += osm2rdf::util::fnv1a(subject) % 2 == 0 ? 1 : 0;
+  }
+
+  w.writeStatisticJson(statsFile);
+
+  output.close();
+
+  std::ifstream statsIFStream(statsFile);
+  std::stringstream statsBuffer;
+  statsBuffer << statsIFStream.rdbuf();
+
+  ASSERT_THAT(statsBuffer.str(), ::testing::HasSubstr("\"header\": 44,"));
+  ASSERT_THAT(statsBuffer.str(), ::testing::HasSubstr("\"lines\": 49,"));
+  ASSERT_THAT(statsBuffer.str(), ::testing::HasSubstr("\"triples\": 5,"));
+  ASSERT_THAT(statsBuffer.str(),
+              ::testing::HasSubstr(
+                  "{\"header\": 22, \"lines\": " +
+                  std::to_string(22 + shard0) +
+                  ", \"triples\": " + std::to_string(shard0) + "},"));
+  ASSERT_THAT(statsBuffer.str(),
+              ::testing::HasSubstr(
+                  "{\"header\": 22, \"lines\": " +
+                  std::to_string(27 - shard0) +
+                  ", \"triples\": " + std::to_string(5 - shard0) + "}\n"));
+
+  // Cleanup
+  statsIFStream.close();
+  std::filesystem::remove_all(tmpDir);
+  ASSERT_FALSE(std::filesystem::exists(tmpDir));
+}
+
 // ____________________________________________________________________________
 TEST(TTL_WriterQLEVER, writeStatisticJson) {
   // Capture std::cout
@@ -777,4 +834,355 @@ TEST(TTL_WriterQLEVER, writeStatisticJson) {
   ASSERT_FALSE(std::filesystem::exists(tmpDir));
 }
 
+// ____________________________________________________________________________
+TEST(TTL_WriterNT, triple) {
+  // Capture std::cout
+  std::stringstream buffer;
+  std::streambuf* sbuf = std::cout.rdbuf();
+  std::cout.rdbuf(buffer.rdbuf());
+
+  osm2rdf::config::Config config;
+  config.output = "";
+  config.outputCompress = osm2rdf::config::NONE;
+  config.mergeOutput = util::OutputMergeMode::NONE;
+  osm2rdf::util::Output output{config, config.output};
+  output.open();
+  osm2rdf::ttl::Writer<osm2rdf::ttl::format::NT> w{config, &output};
+
+  const std::string& subj = w.generateIRI("osmnode", 42);
+  // Same output as the string based functions.
+  w.writeTriple(subj, osm2rdf::ttl::constants::IRI__OSMMETA_USER,
+                w.generateLiteral("a\"b", ""));
+  w.triple()
+      .term(subj)
+      .term(osm2rdf::ttl::constants::IRI__OSMMETA_USER)
+      .literal("a\"b")
+      .end();
+  w.writeTriple(subj, osm2rdf::ttl::constants::IRI__OSMMETA_CHANGESET,
+                w.generateIRI("osmchangeset", 1234));
+  w.triple()
+      .term(subj)
+      .term(osm2rdf::ttl::constants::IRI__OSMMETA_CHANGESET)
+      .iri("osmchangeset", 1234)
+      .end();
+  w.writeLiteralTripleUnsafe(subj, osm2rdf::ttl::constants::IRI__OSMMETA_UID,
+                             std::to_string(-7),
+                             "^^" + osm2rdf::ttl::constants::IRI__XSD_INTEGER);
+  w.triple()
+      .term(subj)
+      .term(osm2rdf::ttl::constants::IRI__OSMMETA_UID)
+      .integerLiteral(-7, osm2rdf::ttl::constants::LITERAL_SUFFIX__XSD_INTEGER)
+      .end();
+  w.writeLiteralTripleUnsafe(
+      subj, osm2rdf::ttl::constants::IRI__OSM2RDF__LENGTH,
+      std::to_string(12.3456789),
+      "^^" + osm2rdf::ttl::constants::IRI__XSD_DOUBLE);
+  w.triple()
+      .term(subj)
+      .term(osm2rdf::ttl::constants::IRI__OSM2RDF__LENGTH)
+      .doubleLiteral(12.3456789,
+                     osm2rdf::ttl::constants::LITERAL_SUFFIX__XSD_DOUBLE)
+      .end();
+  output.flush();
+  output.close();
+
+  ASSERT_EQ(
+      "<https://www.openstreetmap.org/node/42> "
+      "<https://www.openstreetmap.org/meta/user> \"a\\\"b\" .\n"
+      "<https://www.openstreetmap.org/node/42> "
+      "<https://www.openstreetmap.org/meta/user> \"a\\\"b\" .\n"
+      "<https://www.openstreetmap.org/node/42> "
+      "<https://www.openstreetmap.org/meta/changeset> "
+      "<https://www.openstreetmap.org/changeset/1234> .\n"
+      "<https://www.openstreetmap.org/node/42> "
+      "<https://www.openstreetmap.org/meta/changeset> "
+      "<https://www.openstreetmap.org/changeset/1234> .\n"
+      "<https://www.openstreetmap.org/node/42> "
+      "<https://www.openstreetmap.org/meta/uid> "
+      "\"-7\"^^<http://www.w3.org/2001/XMLSchema#integer> .\n"
+      "<https://www.openstreetmap.org/node/42> "
+      "<https://www.openstreetmap.org/meta/uid> "
+      "\"-7\"^^<http://www.w3.org/2001/XMLSchema#integer> .\n"
+      "<https://www.openstreetmap.org/node/42> "
+      "<https://osm2rdf.cs.uni-freiburg.de/rdf#length> "
+      "\"12.345679\"^^<http://www.w3.org/2001/XMLSchema#double> .\n"
+      "<https://www.openstreetmap.org/node/42> "
+      "<https://osm2rdf.cs.uni-freiburg.de/rdf#length> "
+      "\"12.345679\"^^<http://www.w3.org/2001/XMLSchema#double> .\n",
+      buffer.str());
+
+  // Cleanup
+  std::cout.rdbuf(sbuf);
+}
+
+// ____________________________________________________________________________
+TEST(TTL_WriterTTL, triple) {
+  // Capture std::cout
+  std::stringstream buffer;
+  std::streambuf* sbuf = std::cout.rdbuf();
+  std::cout.rdbuf(buffer.rdbuf());
+
+  osm2rdf::config::Config config;
+  config.output = "";
+  config.outputCompress = osm2rdf::config::NONE;
+  config.mergeOutput = util::OutputMergeMode::NONE;
+  osm2rdf::util::Output output{config, config.output};
+  output.open();
+  osm2rdf::ttl::Writer<osm2rdf::ttl::format::TTL> w{config, &output};
+
+  w.triple()
+      .iri("osmway", 42)
+      .term(osm2rdf::ttl::constants::IRI__OSMWAY_NODE_COUNT)
+      .integerLiteral(3, osm2rdf::ttl::constants::LITERAL_SUFFIX__XSD_INTEGER)
+      .end();
+  w.triple()
+      .iri("osmway", 42)
+      .iriUnsafe("osmkey", "name")
+      .literalUnsafe("x", osm2rdf::ttl::constants::LITERAL_SUFFIX__XSD_DATE)
+      .end();
+  output.flush();
+  output.close();
+
+  ASSERT_EQ(
+      "osmway:42 osmway:nodeCount \"3\"^^xsd:integer .\n"
+      "osmway:42 osmkey:name \"x\"^^xsd:date .\n",
+      buffer.str());
+
+  // Cleanup
+  std::cout.rdbuf(sbuf);
+}
+
+// ____________________________________________________________________________
+TEST(TTL_WriterTTL, groupSubjects) {
+  // Capture std::cout
+  std::stringstream buffer;
+  std::streambuf* sbuf = std::cout.rdbuf();
+  std::cout.rdbuf(buffer.rdbuf());
+
+  osm2rdf::config::Config config;
+  config.output = "";
+  config.outputCompress = osm2rdf::config::NONE;
+  config.mergeOutput = util::OutputMergeMode::NONE;
+  config.outputGroupSubjects = true;
+  osm2rdf::util::Output output{config, config.output};
+  output.open();
+  osm2rdf::ttl::Writer<osm2rdf::ttl::format::TTL> w{config, &output};
+
+  const std::string& subj = w.generateIRI("osmway", 42);
+  w.writeTriple(subj, osm2rdf::ttl::constants::IRI__RDF_TYPE,
+                osm2rdf::ttl::constants::IRI__OSM_WAY);
+  w.triple()
+      .iri("osmway", 42)
+      .term(osm2rdf::ttl::constants::IRI__OSMWAY_NODE_COUNT)
+      .integerLiteral(3, osm2rdf::ttl::constants::LITERAL_SUFFIX__XSD_INTEGER)
+      .end();
+  w.writeIRILiteralTriple(subj, "osmkey", "name", "a");
+  w.writeIRILiteralTriple(subj, "osmkey", "name", "b");
+  w.writeTriple(w.generateIRI("osmway", 43),
+                osm2rdf::ttl::constants::IRI__RDF_TYPE,
+                osm2rdf::ttl::constants::IRI__OSM_WAY);
+  w.closeGroups();
+  // Closing again does not terminate any statement twice.
+  w.closeGroups();
+  output.flush();
+  output.close();
+
+  ASSERT_EQ(
+      "osmway:42 rdf:type osm:way ;\n"
+      "\tosmway:nodeCount \"3\"^^xsd:integer ;\n"
+      "\tosmkey:name \"a\" ,\n"
+      "\t\t\"b\" .\n"
+      "osmway:43 rdf:type osm:way .\n",
+      buffer.str());
+
+  // Cleanup
+  std::cout.rdbuf(sbuf);
+}
+
+// ____________________________________________________________________________
+TEST(TTL_WriterNT, groupSubjects) {
+  // Capture std::cout
+  std::stringstream buffer;
+  std::streambuf* sbuf = std::cout.rdbuf();
+  std::cout.rdbuf(buffer.rdbuf());
+
+  osm2rdf::config::Config config;
+  config.output = "";
+  config.outputCompress = osm2rdf::config::NONE;
+  config.mergeOutput = util::OutputMergeMode::NONE;
+  config.outputGroupSubjects = true;
+  osm2rdf::util::Output output{config, config.output};
+  output.open();
+  osm2rdf::ttl::Writer<osm2rdf::ttl::format::NT> w{config, &output};
+
+  // N-Triples does not allow grouping, the option is ignored.
+  w.writeTriple("<s>", "<p>", "<a>");
+  w.writeTriple("<s>", "<p>", "<b>");
+  w.closeGroups();
+  output.flush();
+  output.close();
+
+  ASSERT_EQ("<s> <p> <a> .\n<s> <p> <b> .\n", buffer.str());
+
+  // Cleanup
+  std::cout.rdbuf(sbuf);
+}
+
+// ____________________________________________________________________________
+TEST(TTL_WriterTTL, outputShards) {
+  osm2rdf::config::Config config;
+  std::filesystem::path tmpDir =
+      config.getTempPath("TEST_TTL_WriterTTL", "outputShards");
+  std::filesystem::remove_all(tmpDir);
+  std::filesystem::create_directories(tmpDir);
+  config.output = tmpDir / "file";
+  config.outputCompress = osm2rdf::config::NONE;
+  config.mergeOutput = util::OutputMergeMode::CONCATENATE;
+  config.outputGroupSubjects = true;
+  config.outputShards = 3;
+  osm2rdf::util::Output output{config, config.output};
+  output.open();
+  osm2rdf::ttl::Writer<osm2rdf::ttl::format::TTL> w{config, &output};
+  w.writeHeader();
+
+  const size_t numSubjects = 20;
+  for (size_t i = 0; i < numSubjects; ++i) {
+    w.triple()
+        .iri("osmnode", i)
+        .term(osm2rdf::ttl::constants::IRI__RDF_TYPE)
+        .term(osm2rdf::ttl::constants::IRI__OSM_NODE)
+        .end();
+  }
+  for (size_t i = 0; i < numSubjects; ++i) {
+    w.writeIRILiteralTriple(w.generateIRI("osmnode", i), "osmkey", "name",
+                            std::to_string(i));
+  }
+  w.closeGroups();
+  output.close();
+
+  // Each shard starts with the prefixes and contains all triples of its
+  // subjects.
+  std::vector<size_t> shards(numSubjects, 0);
+  for (size_t shard = 0; shard < 3; ++shard) {
+    std::ifstream in{output.shardFilename(shard)};
+    std::string data{std::istreambuf_iterator<char>(in),
+                     std::istreambuf_iterator<char>()};
+    ASSERT_EQ(0, data.find("@prefix "));
+    for (size_t i = 0; i < numSubjects; ++i) {
+      const std::string type = "\nosmnode:" + std::to_string(i) +
+                               " rdf:type osm:node .\n";
+      const std::string name = "\nosmnode:" + std::to_string(i) +
+                               " osmkey:name \"" + std::to_string(i) + "\" .\n";
+      const bool hasType = data.find(type) != std::string::npos;
+      ASSERT_EQ(hasType, data.find(name) != std::string::npos);
+      shards[i] += hasType ? 1 : 0;
+    }
+  }
+  ASSERT_THAT(shards, ::testing::Each(1));
+
+  // Cleanup
+  std::filesystem::remove_all(tmpDir);
+  ASSERT_FALSE(std::filesystem::exists(tmpDir));
+}
+
+// ____________________________________________________________________________
+TEST(TTL_WriterBINARY, writeHeader) {
+  // Capture std::cout
+  std::stringstream buffer;
+  std::streambuf* sbuf = std::cout.rdbuf();
+  std::cout.rdbuf(buffer.rdbuf());
+
+  osm2rdf::config::Config config;
+  config.output = "";
+  config.outputCompress = osm2rdf::config::NONE;
+  config.mergeOutput = util::OutputMergeMode::NONE;
+  osm2rdf::util::Output output{config, config.output};
+  output.open();
+  osm2rdf::ttl::Writer<osm2rdf::ttl::format::BINARY> w{config, &output};
+
+  w.writeHeader();
+
+  output.close();
+
+  // One header per part.
+  std::string header;
+  osm2rdf::ttl::binary::writeHeader(&header);
+  std::string expected;
+  for (int i = 0; i < config.numThreads + 1; ++i) {
+    expected += header;
+  }
+  ASSERT_EQ(expected, buffer.str());
+
+  // Cleanup
+  std::cout.rdbuf(sbuf);
+}
+
+// ____________________________________________________________________________
+TEST(TTL_WriterBINARY, triple) {
+  // Capture std::cout
+  std::stringstream buffer;
+  std::streambuf* sbuf = std::cout.rdbuf();
+  std::cout.rdbuf(buffer.rdbuf());
+
+  osm2rdf::config::Config config;
+  config.output = "";
+  config.outputCompress = osm2rdf::config::NONE;
+  config.mergeOutput = util::OutputMergeMode::NONE;
+  osm2rdf::util::Output output{config, config.output};
+  output.open();
+  osm2rdf::ttl::Writer<osm2rdf::ttl::format::BINARY> w{config, &output};
+  w.writeHeader();
+
+  const std::string& subj = w.generateIRI("osmnode", 42);
+  // Same triples as the string based functions.
+  w.writeTriple(subj, osm2rdf::ttl::constants::IRI__OSMMETA_USER,
+                w.generateLiteral("a\"b", ""));
+  w.triple()
+      .term(subj)
+      .term(osm2rdf::ttl::constants::IRI__OSMMETA_USER)
+      .literal("a\"b")
+      .end();
+  w.writeIRILiteralTriple(subj, "osmkey", "name", "a b");
+  w.triple()
+      .term(subj)
+      .term(osm2rdf::ttl::constants::IRI__OSMMETA_CHANGESET)
+      .iri("osmchangeset", 1234)
+      .end();
+  w.triple()
+      .term(subj)
+      .term(osm2rdf::ttl::constants::IRI__OSMMETA_UID)
+      .integerLiteral(-7, osm2rdf::ttl::constants::LITERAL_SUFFIX__XSD_INTEGER)
+      .end();
+  w.writeLiteralTripleUnsafe(
+      subj, osm2rdf::ttl::constants::IRI__OSM2RDF__LENGTH,
+      std::to_string(12.3456789),
+      "^^" + osm2rdf::ttl::constants::IRI__XSD_DOUBLE);
+  output.flush();
+  output.close();
+
+  std::stringstream decoded;
+  osm2rdf::ttl::binary::Decoder d;
+  d.decode(buffer, decoded);
+  ASSERT_EQ(
+      "<https://www.openstreetmap.org/node/42> "
+      "<https://www.openstreetmap.org/meta/user> \"a\\\"b\" .\n"
+      "<https://www.openstreetmap.org/node/42> "
+      "<https://www.openstreetmap.org/meta/user> \"a\\\"b\" .\n"
+      "<https://www.openstreetmap.org/node/42> "
+      "<https://www.openstreetmap.org/wiki/Key:name> \"a b\" .\n"
+      "<https://www.openstreetmap.org/node/42> "
+      "<https://www.openstreetmap.org/meta/changeset> "
+      "<https://www.openstreetmap.org/changeset/1234> .\n"
+      "<https://www.openstreetmap.org/node/42> "
+      "<https://www.openstreetmap.org/meta/uid> "
+      "\"-7\"^^<http://www.w3.org/2001/XMLSchema#integer> .\n"
+      "<https://www.openstreetmap.org/node/42> "
+      "<https://osm2rdf.cs.uni-freiburg.de/rdf#length> "
+      "\"12.345679\"^^<http://www.w3.org/2001/XMLSchema#double> .\n",
+      decoded.str());
+
+  // Cleanup
+  std::cout.rdbuf(sbuf);
+}
+
 }  // namespace osm2rdf::ttl
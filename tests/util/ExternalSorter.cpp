@@ -0,0 +1,93 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/util/ExternalSorter.h"
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "osm2rdf/config/Config.h"
+
+namespace osm2rdf::util {
+
+// ____________________________________________________________________________
+std::vector<std::pair<uint64_t, uint64_t>> sortRandom(ExternalSorter* sorter,
+                                                      size_t count) {
+  std::mt19937_64 gen{42};
+  std::vector<std::pair<uint64_t, uint64_t>> expected;
+  for (size_t i = 0; i < count; ++i) {
+    // Duplicate keys are ordered by value.
+    const uint64_t key = gen() % (count / 2 + 1);
+    expected.emplace_back(key, i);
+    sorter->add(key, i);
+  }
+  std::sort(expected.begin(), expected.end());
+  return expected;
+}
+
+// ____________________________________________________________________________
+void assertSorted(ExternalSorter* sorter,
+                  const std::vector<std::pair<uint64_t, uint64_t>>& expected) {
+  sorter->finish();
+  ExternalSorter::Record record{};
+  for (const auto& [key, value] : expected) {
+    ASSERT_TRUE(sorter->next(&record));
+    ASSERT_EQ(key, record.key);
+    ASSERT_EQ(value, record.value);
+  }
+  ASSERT_FALSE(sorter->next(&record));
+  ASSERT_FALSE(sorter->next(&record));
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_ExternalSorter, empty) {
+  osm2rdf::config::Config config;
+  ExternalSorter sorter{config.getTempPath("UTIL_ExternalSorter", "empty"), 4};
+  assertSorted(&sorter, {});
+  ASSERT_EQ(0, sorter.size());
+  ASSERT_EQ(0, sorter.numRuns());
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_ExternalSorter, inMemory) {
+  osm2rdf::config::Config config;
+  ExternalSorter sorter{config.getTempPath("UTIL_ExternalSorter", "inMemory"),
+                        1000};
+  const auto expected = sortRandom(&sorter, 1000);
+  assertSorted(&sorter, expected);
+  ASSERT_EQ(1000, sorter.size());
+  ASSERT_EQ(0, sorter.numRuns());
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_ExternalSorter, runs) {
+  osm2rdf::config::Config config;
+  const auto prefix = config.getTempPath("UTIL_ExternalSorter", "runs");
+  {
+    // Runs span several read blocks.
+    ExternalSorter sorter{prefix, 100000};
+    const auto expected = sortRandom(&sorter, 250001);
+    assertSorted(&sorter, expected);
+    ASSERT_EQ(3, sorter.numRuns());
+    ASSERT_TRUE(std::filesystem::exists(prefix.string() + ".run_0"));
+  }
+  ASSERT_FALSE(std::filesystem::exists(prefix.string() + ".run_0"));
+}
+
+}  // namespace osm2rdf::util
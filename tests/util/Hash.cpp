@@ -0,0 +1,36 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+#include "osm2rdf/util/Hash.h"
+
+#include "gtest/gtest.h"
+
+namespace osm2rdf::util {
+
+// ____________________________________________________________________________
+TEST(UTIL_Hash, fnv1aReference) {
+  ASSERT_EQ(FNV1A_BASIS, fnv1a(""));
+  ASSERT_EQ(0xaf63dc4c8601ec8cULL, fnv1a("a"));
+  ASSERT_EQ(0x85944171f73967e8ULL, fnv1a("foobar"));
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_Hash, fnv1aContinue) {
+  ASSERT_EQ(fnv1a("foobar"), fnv1a("bar", fnv1a("foo")));
+}
+
+}  // namespace osm2rdf::util
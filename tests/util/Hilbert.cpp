@@ -0,0 +1,68 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/util/Hilbert.h"
+
+#include <cstdlib>
+#include <set>
+
+#include "gtest/gtest.h"
+
+namespace osm2rdf::util {
+
+// ____________________________________________________________________________
+TEST(UTIL_Hilbert, firstOrder) {
+  // The curve starts in the lower left and ends in the lower right quadrant.
+  const uint32_t half = uint32_t{1} << 31U;
+  ASSERT_EQ(0, hilbertKey(uint32_t{0}, uint32_t{0}));
+  ASSERT_LT(hilbertKey(uint32_t{0}, uint32_t{0}), hilbertKey(uint32_t{0}, half));
+  ASSERT_LT(hilbertKey(uint32_t{0}, half), hilbertKey(half, half));
+  ASSERT_LT(hilbertKey(half, half), hilbertKey(half, uint32_t{0}));
+  ASSERT_EQ(UINT64_MAX, hilbertKey(UINT32_MAX, uint32_t{0}));
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_Hilbert, neighbours) {
+  // Consecutive keys belong to adjacent cells, checked on a 16 x 16 corner.
+  std::set<std::pair<uint64_t, std::pair<uint32_t, uint32_t>>> cells;
+  for (uint32_t x = 0; x < 16; ++x) {
+    for (uint32_t y = 0; y < 16; ++y) {
+      cells.insert({hilbertKey(x, y), {x, y}});
+    }
+  }
+  ASSERT_EQ(256, cells.size());
+  auto prev = cells.begin();
+  for (auto it = std::next(prev); it != cells.end(); prev = it++) {
+    ASSERT_EQ(prev->first + 1, it->first);
+    const auto dx = std::abs(static_cast<int64_t>(it->second.first) -
+                             prev->second.first);
+    const auto dy = std::abs(static_cast<int64_t>(it->second.second) -
+                             prev->second.second);
+    ASSERT_EQ(1, dx + dy);
+  }
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_Hilbert, signed) {
+  ASSERT_EQ(hilbertKey(uint32_t{0}, uint32_t{0}),
+            hilbertKey(INT32_MIN, INT32_MIN));
+  ASSERT_EQ(hilbertKey(uint32_t{1} << 31U, uint32_t{1} << 31U),
+            hilbertKey(int32_t{0}, int32_t{0}));
+}
+
+}  // namespace osm2rdf::util
@@ -0,0 +1,88 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/util/LockFreeQueue.h"
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace osm2rdf::util {
+
+// ____________________________________________________________________________
+TEST(UTIL_LockFreeQueue, pushPopFifo) {
+  LockFreeQueue<int> q{4};
+  int v = 0;
+  ASSERT_FALSE(q.pop(&v));
+  ASSERT_TRUE(q.push(1));
+  ASSERT_TRUE(q.push(2));
+  ASSERT_TRUE(q.pop(&v));
+  ASSERT_EQ(1, v);
+  ASSERT_TRUE(q.push(3));
+  ASSERT_TRUE(q.pop(&v));
+  ASSERT_EQ(2, v);
+  ASSERT_TRUE(q.pop(&v));
+  ASSERT_EQ(3, v);
+  ASSERT_FALSE(q.pop(&v));
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_LockFreeQueue, capacityRoundedUp) {
+  LockFreeQueue<int> q{3};
+  ASSERT_TRUE(q.push(1));
+  ASSERT_TRUE(q.push(2));
+  ASSERT_TRUE(q.push(3));
+  ASSERT_TRUE(q.push(4));
+  ASSERT_FALSE(q.push(5));
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_LockFreeQueue, multipleProducers) {
+  const int producers = 4;
+  const int perProducer = 10000;
+  LockFreeQueue<int> q{64};
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&q, p] {
+      for (int i = 0; i < perProducer; ++i) {
+        while (!q.push(p * perProducer + i)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  std::vector<int> last(producers, -1);
+  int received = 0;
+  while (received < producers * perProducer) {
+    int v;
+    if (!q.pop(&v)) {
+      std::this_thread::yield();
+      continue;
+    }
+    // Values of one producer arrive in order.
+    ASSERT_LT(last[v / perProducer], v);
+    last[v / perProducer] = v;
+    received++;
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+}  // namespace osm2rdf::util
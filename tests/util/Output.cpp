@@ -18,7 +18,15 @@
 
 #include "osm2rdf/util/Output.h"
 
+#include <bzlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <random>
+#include <thread>
 
 #include "gtest/gtest.h"
 
@@ -30,6 +38,36 @@ size_t countFilesInPath(const std::filesystem::path path) {
                        std::filesystem::directory_iterator());
 }
 
+// ____________________________________________________________________________
+std::string decompressBzip2Streams(const std::filesystem::path& path) {
+  std::ifstream in{path, std::ios::binary};
+  std::string data{std::istreambuf_iterator<char>(in),
+                   std::istreambuf_iterator<char>()};
+  std::string result;
+  char buf[4096];
+  size_t pos = 0;
+  while (pos < data.size()) {
+    bz_stream strm{};
+    EXPECT_EQ(BZ_OK, BZ2_bzDecompressInit(&strm, 0, 0));
+    strm.next_in = data.data() + pos;
+    strm.avail_in = data.size() - pos;
+    int ret;
+    do {
+      strm.next_out = buf;
+      strm.avail_out = sizeof(buf);
+      ret = BZ2_bzDecompress(&strm);
+      result.append(buf, sizeof(buf) - strm.avail_out);
+    } while (ret == BZ_OK);
+    EXPECT_EQ(BZ_STREAM_END, ret);
+    pos = data.size() - strm.avail_in;
+    BZ2_bzDecompressEnd(&strm);
+    if (ret != BZ_STREAM_END) {
+      break;
+    }
+  }
+  return result;
+}
+
 // ____________________________________________________________________________
 TEST(UTIL_Output, partFilenameSingleDigit) {
   osm2rdf::config::Config config;
@@ -135,6 +173,195 @@ TEST(UTIL_Output, WriteIntoCurrentPartStdOut) {
   std::cout.rdbuf(sbuf);
 }
 
+// ____________________________________________________________________________
+TEST(UTIL_Output, WriteIntoStdOutFileDescriptor) {
+  osm2rdf::config::Config config;
+  config.output = "";
+  config.outputCompress = osm2rdf::config::NONE;
+  config.mergeOutput = OutputMergeMode::NONE;
+
+  // A non-blocking pipe read slowly, writev writes partially or not at all.
+  int fds[2];
+  ASSERT_EQ(0, ::pipe(fds));
+  ASSERT_EQ(0, ::fcntl(fds[1], F_SETFL, O_NONBLOCK));
+  std::string result;
+  std::thread reader{[&result, fd = fds[0]]() {
+    char buf[65536];
+    ssize_t n;
+    while ((n = ::read(fd, buf, sizeof(buf))) > 0) {
+      result.append(buf, n);
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  }};
+
+  // Lines from several parts spanning multiple chunks.
+  std::string line(1023, 'x');
+  size_t lines = 2 * STDOUT_CHUNK_S / 1024;
+  size_t parts = 4;
+  {
+    osm2rdf::util::Output o{config, "", parts};
+    o.setStdoutFd(fds[1]);
+    o.open();
+#pragma omp parallel for num_threads(4)
+    for (size_t i = 0; i < parts; ++i) {
+      for (size_t j = 0; j < lines; ++j) {
+        o.write(line, i);
+        o.writeNewLine(i);
+      }
+    }
+    o.close();
+  }
+  ::close(fds[1]);
+  reader.join();
+  ::close(fds[0]);
+
+  ASSERT_EQ(parts * lines * 1024, result.size());
+  std::stringstream ss{result};
+  std::string read;
+  size_t count = 0;
+  while (std::getline(ss, read)) {
+    ASSERT_EQ(line, read);
+    count++;
+  }
+  ASSERT_EQ(parts * lines, count);
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_Output, WriteIntoStdOutCompressed) {
+  osm2rdf::config::Config config;
+  config.output = "";
+  config.outputCompress = osm2rdf::config::BZ2;
+  config.mergeOutput = OutputMergeMode::NONE;
+
+  size_t parts = 2;
+  testing::internal::CaptureStdout();
+  osm2rdf::util::Output o{config, "", parts};
+  o.open();
+  o.write("a", 0);
+  o.writeNewLine(0);
+  o.flush();
+  o.write("b", 1);
+  o.writeNewLine(1);
+  o.close();
+  std::string result = testing::internal::GetCapturedStdout();
+
+  std::filesystem::path path =
+      config.getTempPath("TEST_UTIL_Output", "WriteIntoStdOutCompressed");
+  std::ofstream{path, std::ios::binary} << result;
+  ASSERT_EQ("a\nb\n", decompressBzip2Streams(path));
+  std::filesystem::remove(path);
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_Output, ParallelBzip2MultipleStreams) {
+  osm2rdf::config::Config config;
+  config.output =
+      config.getTempPath("TEST_UTIL_Output", "ParallelBzip2MultipleStreams");
+  std::filesystem::remove_all(config.output);
+  config.mergeOutput = OutputMergeMode::NONE;
+  config.outputCompress = osm2rdf::config::BZ2;
+  config.outputCompressionThreads = 2;
+  std::filesystem::create_directories(config.output);
+  std::filesystem::path output{config.output};
+  output /= "file";
+
+  size_t parts = 2;
+  osm2rdf::util::Output o{config, output, parts};
+  o.open();
+  o.write("a", 0);
+  o.write("b", 1);
+  // Each flush hands the buffer to the workers as a separate bzip2 stream.
+  o.flush();
+  o.write("c", 0);
+  o.writeNewLine(0);
+  o.flush();
+  o.write("d", 0);
+  o.close();
+
+  ASSERT_EQ("ac\nd", decompressBzip2Streams(o.partFilename(0)));
+  ASSERT_EQ("b", decompressBzip2Streams(o.partFilename(1)));
+
+  std::filesystem::remove_all(config.output);
+  ASSERT_FALSE(std::filesystem::exists(config.output));
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_Output, ParallelCompressCloseFails) {
+  osm2rdf::config::Config config;
+  config.output =
+      config.getTempPath("TEST_UTIL_Output", "ParallelCompressCloseFails");
+  std::filesystem::remove_all(config.output);
+  config.mergeOutput = OutputMergeMode::NONE;
+  config.outputCompress = osm2rdf::config::BZ2;
+  config.outputCompressionThreads = 2;
+  std::filesystem::create_directories(config.output);
+  std::filesystem::path output{config.output};
+  output /= "file";
+
+  {
+    osm2rdf::util::Output o{config, output, 1};
+    // Every write to the part fails.
+    std::filesystem::create_symlink("/dev/full", o.partFilename(0));
+    o.open();
+    // Compresses to more than the stdio buffer, the worker fails writing it.
+    std::mt19937 gen{42};
+    std::string block(size_t{1} << 20U, ' ');
+    for (auto& c : block) {
+      c = static_cast<char>('a' + gen() % 26);
+    }
+    o.write(block, 0);
+    o.flush();
+    // Later blocks are rejected once the failure is known.
+    bool failed = false;
+    while (!failed) {
+      o.write("b", 0);
+      try {
+        o.flush();
+      } catch (const std::runtime_error&) {
+        failed = true;
+      }
+    }
+    ASSERT_THROW(o.close(), std::runtime_error);
+    // The workers are stopped, destroying the output does not terminate.
+  }
+
+  std::filesystem::remove_all(config.output);
+  ASSERT_FALSE(std::filesystem::exists(config.output));
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_Output, AsyncFlushKeepsOrder) {
+  osm2rdf::config::Config config;
+  config.output =
+      config.getTempPath("TEST_UTIL_Output", "AsyncFlushKeepsOrder");
+  std::filesystem::remove_all(config.output);
+  config.mergeOutput = OutputMergeMode::NONE;
+  config.outputCompress = osm2rdf::config::BZ2;
+  config.outputAsyncWrite = true;
+  std::filesystem::create_directories(config.output);
+  std::filesystem::path output{config.output};
+  output /= "file";
+
+  size_t parts = 2;
+  osm2rdf::util::Output o{config, output, parts};
+  o.open();
+  // Flushed buffers are written in the background, in order and into the
+  // same stream.
+  for (size_t i = 0; i < 10; ++i) {
+    o.write(std::to_string(i), 0);
+    o.flush(0);
+  }
+  o.write("b", 1);
+  o.close();
+
+  ASSERT_EQ("0123456789", decompressBzip2Streams(o.partFilename(0)));
+  ASSERT_EQ("b", decompressBzip2Streams(o.partFilename(1)));
+  ASSERT_GE(o.stallSeconds(), 0);
+
+  std::filesystem::remove_all(config.output);
+  ASSERT_FALSE(std::filesystem::exists(config.output));
+}
+
 // ____________________________________________________________________________
 TEST(UTIL_OutputMergeMode, NONE) {
   osm2rdf::config::Config config;
@@ -198,4 +425,78 @@ TEST(UTIL_OutputMergeMode, CONCATENATE) {
   ASSERT_FALSE(std::filesystem::exists(config.output));
 }
 
+// ____________________________________________________________________________
+TEST(UTIL_OutputMergeMode, CONCATENATEContent) {
+  osm2rdf::config::Config config;
+  config.output =
+      config.getTempPath("TEST_UTIL_OutputMergeMode", "CONCATENATEContent");
+  std::filesystem::remove_all(config.output);
+  config.mergeOutput = OutputMergeMode::CONCATENATE;
+  config.outputCompress = osm2rdf::config::NONE;
+  std::filesystem::create_directories(config.output);
+  std::filesystem::path output{config.output};
+  output /= "file";
+
+  // Parts of different sizes, including an empty one, end up at unaligned
+  // offsets of the final file.
+  std::string a(10000, 'a');
+  std::string c(4096, 'c');
+  size_t parts = 4;
+  osm2rdf::util::Output o{config, output, parts};
+  o.open();
+  o.write(a, 0);
+  o.write(c, 2);
+  o.write("d", 3);
+  o.close();
+  ASSERT_EQ(1, countFilesInPath(config.output));
+
+  std::ifstream in{output, std::ios::binary};
+  std::string data{std::istreambuf_iterator<char>(in),
+                   std::istreambuf_iterator<char>()};
+  ASSERT_EQ(a + c + "d", data);
+
+  std::filesystem::remove_all(config.output);
+  ASSERT_FALSE(std::filesystem::exists(config.output));
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_OutputMergeMode, CONCATENATEShards) {
+  osm2rdf::config::Config config;
+  config.output =
+      config.getTempPath("TEST_UTIL_OutputMergeMode", "CONCATENATEShards");
+  std::filesystem::remove_all(config.output);
+  config.mergeOutput = OutputMergeMode::CONCATENATE;
+  config.outputCompress = osm2rdf::config::NONE;
+  config.outputShards = 2;
+  std::filesystem::create_directories(config.output);
+  std::filesystem::path output{config.output};
+  output /= "file";
+
+  // Parts 0 and 1 form shard 0, parts 2 and 3 shard 1.
+  size_t parts = 4;
+  osm2rdf::util::Output o{config, output, parts};
+  ASSERT_EQ(2, o.shardCount());
+  o.open();
+  o.write("a", 0);
+  o.write("b", 1);
+  o.write("c", 2);
+  o.write("d", 3);
+  o.close();
+  // No final file, one file per shard.
+  ASSERT_EQ(2, countFilesInPath(config.output));
+  ASSERT_FALSE(std::filesystem::exists(output));
+
+  for (const auto& [shard, expected] :
+       {std::pair{0, "ab"}, std::pair{1, "cd"}}) {
+    std::ifstream in{o.shardFilename(shard), std::ios::binary};
+    std::string data{std::istreambuf_iterator<char>(in),
+                     std::istreambuf_iterator<char>()};
+    ASSERT_EQ(expected, data);
+  }
+  ASSERT_EQ(output.string() + ".shard_1", o.shardFilename(1));
+
+  std::filesystem::remove_all(config.output);
+  ASSERT_FALSE(std::filesystem::exists(config.output));
+}
+
 }  // namespace osm2rdf::util
@@ -0,0 +1,275 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/util/OutputCodec.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include "gtest/gtest.h"
+
+namespace osm2rdf::util {
+
+// ____________________________________________________________________________
+std::string readFile(const std::filesystem::path& path) {
+  std::ifstream in{path, std::ios::binary};
+  return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+// ____________________________________________________________________________
+std::string decompressBzip2(const std::string& data) {
+  std::string result;
+  char buf[4096];
+  size_t pos = 0;
+  while (pos < data.size()) {
+    bz_stream strm{};
+    EXPECT_EQ(BZ_OK, BZ2_bzDecompressInit(&strm, 0, 0));
+    strm.next_in = const_cast<char*>(data.data() + pos);
+    strm.avail_in = data.size() - pos;
+    int ret;
+    do {
+      strm.next_out = buf;
+      strm.avail_out = sizeof(buf);
+      ret = BZ2_bzDecompress(&strm);
+      result.append(buf, sizeof(buf) - strm.avail_out);
+    } while (ret == BZ_OK);
+    pos = data.size() - strm.avail_in;
+    BZ2_bzDecompressEnd(&strm);
+    if (ret != BZ_STREAM_END) {
+      ADD_FAILURE() << "bzip2 error " << ret;
+      break;
+    }
+  }
+  return result;
+}
+
+// ____________________________________________________________________________
+std::string decompressGz(const std::filesystem::path& path) {
+  // gzread continues with concatenated members.
+  gzFile file = gzopen(path.c_str(), "r");
+  EXPECT_NE(nullptr, file);
+  std::string result;
+  char buf[4096];
+  int r;
+  while ((r = gzread(file, buf, sizeof(buf))) > 0) {
+    result.append(buf, r);
+  }
+  EXPECT_EQ(0, r);
+  gzclose(file);
+  return result;
+}
+
+#if defined(OSM2RDF_HAVE_ZSTD)
+// ____________________________________________________________________________
+std::string decompressZstd(const std::string& data) {
+  ZSTD_DCtx* ctx = ZSTD_createDCtx();
+  std::string result;
+  char buf[4096];
+  ZSTD_inBuffer in{data.data(), data.size(), 0};
+  while (in.pos < in.size) {
+    ZSTD_outBuffer out{buf, sizeof(buf), 0};
+    size_t r = ZSTD_decompressStream(ctx, &out, &in);
+    if (ZSTD_isError(r)) {
+      ADD_FAILURE() << ZSTD_getErrorName(r);
+      break;
+    }
+    result.append(buf, out.pos);
+  }
+  ZSTD_freeDCtx(ctx);
+  return result;
+}
+#endif
+
+#if defined(OSM2RDF_HAVE_LZ4)
+// ____________________________________________________________________________
+std::string decompressLz4(const std::string& data) {
+  LZ4F_dctx* ctx = nullptr;
+  LZ4F_createDecompressionContext(&ctx, LZ4F_VERSION);
+  std::string result;
+  char buf[4096];
+  size_t pos = 0;
+  while (pos < data.size()) {
+    size_t outLen = sizeof(buf);
+    size_t inLen = data.size() - pos;
+    size_t r =
+        LZ4F_decompress(ctx, buf, &outLen, data.data() + pos, &inLen, nullptr);
+    if (LZ4F_isError(r)) {
+      ADD_FAILURE() << LZ4F_getErrorName(r);
+      break;
+    }
+    result.append(buf, outLen);
+    pos += inLen;
+  }
+  LZ4F_freeDecompressionContext(ctx);
+  return result;
+}
+#endif
+
+// ____________________________________________________________________________
+std::string decompress(osm2rdf::config::CompressFormat format,
+                       const std::filesystem::path& path) {
+  switch (format) {
+    case osm2rdf::config::BZ2:
+      return decompressBzip2(readFile(path));
+    case osm2rdf::config::GZ:
+      return decompressGz(path);
+#if defined(OSM2RDF_HAVE_ZSTD)
+    case osm2rdf::config::ZSTD:
+      return decompressZstd(readFile(path));
+#endif
+#if defined(OSM2RDF_HAVE_LZ4)
+    case osm2rdf::config::LZ4:
+      return decompressLz4(readFile(path));
+#endif
+    default:
+      return readFile(path);
+  }
+}
+
+// ____________________________________________________________________________
+void assertStreamRoundTrip(osm2rdf::config::CompressFormat format,
+                           int threads) {
+  osm2rdf::config::Config config;
+  config.outputCompress = format;
+  config.outputCompressionThreads = threads;
+  std::filesystem::path path =
+      config.getTempPath("TEST_UTIL_OutputCodec", "stream");
+  std::string a = "<a> <b> \"c\" .\n";
+  std::string b(3 * 1024 * 1024, 'x');
+
+  auto codec = OutputCodec::create(config);
+  codec->open(path, true);
+  codec->write(reinterpret_cast<const unsigned char*>(a.data()), a.size());
+  codec->write(reinterpret_cast<const unsigned char*>(b.data()), b.size());
+  codec->close();
+
+  ASSERT_EQ(a + b, decompress(format, path));
+  std::filesystem::remove(path);
+}
+
+// ____________________________________________________________________________
+void assertBlockRoundTrip(osm2rdf::config::CompressFormat format) {
+  osm2rdf::config::Config config;
+  config.outputCompress = format;
+  std::filesystem::path path =
+      config.getTempPath("TEST_UTIL_OutputCodec", "block");
+  std::string a = "<a> <b> \"c\" .\n";
+  std::string b = "<d> <e> <f> .\n";
+
+  auto codec = OutputCodec::create(config);
+  codec->open(path, false);
+  std::vector<char> block;
+  codec->compressBlock(reinterpret_cast<const unsigned char*>(a.data()),
+                       a.size(), &block);
+  codec->writeBlock(block);
+  codec->compressBlock(reinterpret_cast<const unsigned char*>(b.data()),
+                       b.size(), &block);
+  codec->writeBlock(block);
+  codec->close();
+
+  ASSERT_EQ(a + b, decompress(format, path));
+  std::filesystem::remove(path);
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_OutputCodec, NoneStream) {
+  assertStreamRoundTrip(osm2rdf::config::NONE, 0);
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_OutputCodec, NoneBlocks) {
+  assertBlockRoundTrip(osm2rdf::config::NONE);
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_OutputCodec, Bzip2Stream) {
+  assertStreamRoundTrip(osm2rdf::config::BZ2, 0);
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_OutputCodec, Bzip2Blocks) {
+  assertBlockRoundTrip(osm2rdf::config::BZ2);
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_OutputCodec, GzStream) {
+  assertStreamRoundTrip(osm2rdf::config::GZ, 0);
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_OutputCodec, GzBlocks) {
+  assertBlockRoundTrip(osm2rdf::config::GZ);
+}
+
+#if defined(OSM2RDF_HAVE_ZSTD)
+// ____________________________________________________________________________
+TEST(UTIL_OutputCodec, ZstdStream) {
+  assertStreamRoundTrip(osm2rdf::config::ZSTD, 0);
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_OutputCodec, ZstdStreamMultithreaded) {
+  assertStreamRoundTrip(osm2rdf::config::ZSTD, 2);
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_OutputCodec, ZstdBlocks) {
+  assertBlockRoundTrip(osm2rdf::config::ZSTD);
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_OutputCodec, ZstdBlockChecksum) {
+  osm2rdf::config::Config config;
+  config.outputCompress = osm2rdf::config::ZSTD;
+  std::string a = "<a> <b> \"c\" .\n";
+
+  auto codec = OutputCodec::create(config);
+  std::vector<char> block;
+  codec->compressBlock(reinterpret_cast<const unsigned char*>(a.data()),
+                       a.size(), &block);
+  // Content checksum flag of the frame header descriptor after the magic.
+  ASSERT_LT(4, block.size());
+  ASSERT_NE(0, block[4] & 0x04);
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_OutputCodec, ZstdThreadsSharedByParts) {
+  osm2rdf::config::Config config;
+  config.outputCompress = osm2rdf::config::ZSTD;
+  config.outputCompressionThreads = 8;
+
+  ASSERT_TRUE(OutputCodec::create(config, 4)->compressesInParallel());
+  // Fewer threads than parts, blocks are compressed by the output instead.
+  ASSERT_FALSE(OutputCodec::create(config, 9)->compressesInParallel());
+}
+#endif
+
+#if defined(OSM2RDF_HAVE_LZ4)
+// ____________________________________________________________________________
+TEST(UTIL_OutputCodec, Lz4Stream) {
+  assertStreamRoundTrip(osm2rdf::config::LZ4, 0);
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_OutputCodec, Lz4Blocks) {
+  assertBlockRoundTrip(osm2rdf::config::LZ4);
+}
+#endif
+
+}  // namespace osm2rdf::util
@@ -0,0 +1,101 @@
+// Copyright 2020, University of Freiburg
+// Authors: Axel Lehmann <lehmann@cs.uni-freiburg.de>.
+
+// This file is part of osm2rdf.
+//
+// osm2rdf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// osm2rdf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with osm2rdf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "osm2rdf/util/Simd.h"
+
+#include <random>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace osm2rdf::util::simd {
+
+// ____________________________________________________________________________
+void assertAllLevelsEqual(const std::string& s) {
+  const Level detected = detectLevel();
+  setLevel(Level::SCALAR);
+  size_t literal = findLiteralEscape(s);
+  size_t iriref = findIRIREFEscape(s);
+  size_t pnLocal = findPN_LOCALSpecial(s);
+  for (auto l : {Level::SSE2, Level::AVX2}) {
+    if (l > detected) {
+      continue;
+    }
+    setLevel(l);
+    ASSERT_EQ(literal, findLiteralEscape(s)) << s;
+    ASSERT_EQ(iriref, findIRIREFEscape(s)) << s;
+    ASSERT_EQ(pnLocal, findPN_LOCALSpecial(s)) << s;
+  }
+  setLevel(detected);
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_Simd, findLiteralEscape) {
+  ASSERT_EQ(0, findLiteralEscape(""));
+  ASSERT_EQ(5, findLiteralEscape("Hallo"));
+  ASSERT_EQ(5, findLiteralEscape("Hallo\"Welt"));
+  ASSERT_EQ(40, findLiteralEscape(std::string(40, 'a') + "\\"));
+  ASSERT_EQ(33, findLiteralEscape(std::string(33, 'a') + "\n"));
+  ASSERT_EQ(17, findLiteralEscape(std::string(17, 'a') + "\r"));
+  // Non-ASCII is copied verbatim.
+  const std::string street = u8"Straße Straße Straße Straße";
+  ASSERT_EQ(street.size(), findLiteralEscape(street));
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_Simd, findIRIREFEscape) {
+  ASSERT_EQ(0, findIRIREFEscape(""));
+  ASSERT_EQ(3, findIRIREFEscape("Q42"));
+  ASSERT_EQ(5, findIRIREFEscape("Hallo Welt"));
+  ASSERT_EQ(0, findIRIREFEscape(std::string(1, '\0')));
+  for (char c : {'<', '>', '"', '{', '}', '|', '^', '`', '\\'}) {
+    ASSERT_EQ(35, findIRIREFEscape(std::string(35, 'a') + c + "a"));
+  }
+  ASSERT_EQ(4, findIRIREFEscape(u8"Straße"));
+  const std::string iri = "https://de.wikipedia.org/wiki/Freiburg_im_Breisgau";
+  ASSERT_EQ(iri.size(), findIRIREFEscape(iri));
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_Simd, findPN_LOCALSpecial) {
+  ASSERT_EQ(0, findPN_LOCALSpecial(""));
+  ASSERT_EQ(12, findPN_LOCALSpecial("name:de_AT09"));
+  ASSERT_EQ(4, findPN_LOCALSpecial("addr-street"));
+  ASSERT_EQ(0, findPN_LOCALSpecial("@"));
+  ASSERT_EQ(32, findPN_LOCALSpecial(std::string(32, 'z') + "{"));
+  ASSERT_EQ(16, findPN_LOCALSpecial(std::string(16, 'A') + "["));
+  ASSERT_EQ(4, findPN_LOCALSpecial(u8"nameße"));
+}
+
+// ____________________________________________________________________________
+TEST(UTIL_Simd, allLevelsEqual) {
+  std::mt19937 gen{42};
+  std::uniform_int_distribution<int> byte{0, 255};
+  std::uniform_int_distribution<int> length{0, 100};
+  for (size_t i = 0; i < 10000; ++i) {
+    std::string s(length(gen), ' ');
+    for (auto& c : s) {
+      // Mostly clean chars to get long runs.
+      c = static_cast<char>(byte(gen) < 240 ? 'a' + (byte(gen) % 26)
+                                            : byte(gen));
+    }
+    assertAllLevelsEqual(s);
+  }
+}
+
+}  // namespace osm2rdf::util::simd